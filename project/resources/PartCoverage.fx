@@ -9,6 +9,15 @@ struct VS_INPUT
     float3 Tangent : TANGENT;
 };
 
+// Quantized vertex buffers (dae::QuantizedVertex), decoded by DecodeVertex
+struct VS_INPUT_QUANTIZED
+{
+    float4 Position : POSITION; // R16G16B16A16_UNORM in the mesh AABB, w = tangent sign
+    float2 UV : TEXCOORD; // R16G16_FLOAT
+    float2 Normal : NORMAL; // R16G16_SNORM, octahedral
+    float2 Tangent : TANGENT; // R16G16_SNORM, octahedral
+};
+
 struct VS_OUTPUT
 {
     float4 Position : SV_Position;
@@ -23,6 +32,12 @@ struct VS_OUTPUT
 // -------------------------
 float4x4 gWorldViewProj : WorldViewProjection;
 
+// -------------------------
+//   Position Dequantization (QuantizedTechnique)
+// -------------------------
+float3 gPositionMin : POSITIONMIN;
+float3 gPositionExtent : POSITIONEXTENT;
+
 // -------------------------
 //  Textures
 // -------------------------
@@ -51,6 +66,30 @@ VS_OUTPUT VS(VS_INPUT input)
     return output;
 }
 
+// Same math as dae::DequantizeVertex
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.f - abs(encoded.x) - abs(encoded.y));
+    const float fold = saturate(-direction.z);
+    direction.xy += direction.xy >= 0.f ? -fold : fold;
+    return normalize(direction);
+}
+
+VS_INPUT DecodeVertex(VS_INPUT_QUANTIZED input)
+{
+    VS_INPUT output = (VS_INPUT) 0;
+    output.Position = gPositionMin + input.Position.xyz * gPositionExtent;
+    output.UV = input.UV;
+    output.Normal = DecodeOctahedral(input.Normal);
+    output.Tangent = DecodeOctahedral(input.Tangent);
+    return output;
+}
+
+VS_OUTPUT VS_Quantized(VS_INPUT_QUANTIZED input)
+{
+    return VS(DecodeVertex(input));
+}
+
 // Pixel Shader
 float4 PS(VS_OUTPUT input) : SV_Target
 {
@@ -97,4 +136,18 @@ technique11 DefaultTechnique
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
+}
+
+// Same passes for quantized vertex buffers
+technique11 QuantizedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Quantized()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "BVH.h"
+#include <algorithm>
+#include <array>
+
+namespace dae
+{
+	void BVH::Insert(ObjectId object, const AABB& box)
+	{
+		if (object >= m_ObjectLeaves.size())
+			m_ObjectLeaves.resize(object + 1, INVALID_INDEX);
+
+		const uint32_t leaf{ AllocateNode() };
+		m_Nodes[leaf].box = box;
+		m_Nodes[leaf].object = object;
+		m_ObjectLeaves[object] = leaf;
+		++m_NumObjects;
+
+		InsertLeaf(leaf);
+	}
+
+	void BVH::Remove(ObjectId object)
+	{
+		const uint32_t leaf{ m_ObjectLeaves[object] };
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+
+		m_ObjectLeaves[object] = INVALID_INDEX;
+		--m_NumObjects;
+	}
+
+	void BVH::Clear()
+	{
+		*this = BVH{};
+	}
+
+	void BVH::Refit()
+	{
+		if (m_RootNode == INVALID_INDEX)
+			return;
+
+		// Inserts and removes pick good spots, the tree right after them is the new reference
+		const bool hasTopologyChanged{ m_IsRefitOrderDirty };
+		if (hasTopologyChanged)
+			UpdateRefitOrder();
+
+		const float cost{ RefitNodes() };
+		if (hasTopologyChanged)
+		{
+			m_BuildCost = cost;
+		}
+		else if (cost > m_BuildCost * REBUILD_COST_RATIO && m_NumObjects > 2)
+		{
+			// Objects drifted away from the neighbours they were grouped with
+			Rebuild();
+		}
+	}
+
+	void BVH::Rebuild()
+	{
+		if (m_NumObjects == 0)
+			return;
+
+		// Keep the leaves (the object -> leaf lookup stays valid), replace every internal node
+		std::vector<uint32_t> leaves{};
+		leaves.reserve(m_NumObjects);
+		for (const uint32_t leaf : m_ObjectLeaves)
+		{
+			if (leaf != INVALID_INDEX)
+				leaves.emplace_back(leaf);
+		}
+
+		for (uint32_t nodeIndex{}; nodeIndex < m_Nodes.size(); ++nodeIndex)
+		{
+			if (!m_Nodes[nodeIndex].IsLeaf())
+				FreeNode(nodeIndex);
+		}
+
+		m_RootNode = BuildRange(leaves.data(), static_cast<uint32_t>(leaves.size()), INVALID_INDEX);
+		UpdateRefitOrder();
+		m_BuildCost = RefitNodes();
+		++m_NumRebuilds;
+	}
+
+	uint32_t BVH::AllocateNode()
+	{
+		if (m_FreeNode == INVALID_INDEX)
+		{
+			m_Nodes.emplace_back();
+			return static_cast<uint32_t>(m_Nodes.size() - 1);
+		}
+
+		const uint32_t node{ m_FreeNode };
+		m_FreeNode = m_Nodes[node].parent;
+		m_Nodes[node] = Node{};
+		return node;
+	}
+
+	void BVH::FreeNode(uint32_t node)
+	{
+		// Free nodes look like leaves without an object, Rebuild skips them
+		m_Nodes[node] = Node{};
+		m_Nodes[node].parent = m_FreeNode;
+		m_FreeNode = node;
+	}
+
+	void BVH::InsertLeaf(uint32_t leaf)
+	{
+		m_IsRefitOrderDirty = true;
+
+		if (m_RootNode == INVALID_INDEX)
+		{
+			m_RootNode = leaf;
+			m_Nodes[leaf].parent = INVALID_INDEX;
+			return;
+		}
+
+		// Descend towards the cheapest sibling - a new parent costs its area, every ancestor grows by the union
+		const AABB& leafBox{ m_Nodes[leaf].box };
+		uint32_t sibling{ m_RootNode };
+		while (!m_Nodes[sibling].IsLeaf())
+		{
+			const Node& node{ m_Nodes[sibling] };
+			const float area{ node.box.GetSurfaceArea() };
+			const float combinedArea{ AABB::Merge(node.box, leafBox).GetSurfaceArea() };
+
+			const float siblingCost{ 2.f * combinedArea };
+			const float inheritanceCost{ 2.f * (combinedArea - area) };
+
+			float childCosts[2]{};
+			for (int i{}; i < 2; ++i)
+			{
+				const Node& child{ m_Nodes[node.children[i]] };
+				const float mergedArea{ AABB::Merge(child.box, leafBox).GetSurfaceArea() };
+				childCosts[i] = inheritanceCost + (child.IsLeaf() ? mergedArea : mergedArea - child.box.GetSurfaceArea());
+			}
+
+			if (siblingCost < childCosts[0] && siblingCost < childCosts[1])
+				break;
+
+			sibling = childCosts[0] <= childCosts[1] ? node.children[0] : node.children[1];
+		}
+
+		const uint32_t oldParent{ m_Nodes[sibling].parent };
+		const uint32_t newParent{ AllocateNode() };
+		Node& parentNode{ m_Nodes[newParent] };
+		parentNode.parent = oldParent;
+		parentNode.children[0] = sibling;
+		parentNode.children[1] = leaf;
+		parentNode.box = AABB::Merge(m_Nodes[sibling].box, m_Nodes[leaf].box);
+		m_Nodes[sibling].parent = newParent;
+		m_Nodes[leaf].parent = newParent;
+
+		if (oldParent == INVALID_INDEX)
+		{
+			m_RootNode = newParent;
+		}
+		else
+		{
+			Node& grandParent{ m_Nodes[oldParent] };
+			grandParent.children[grandParent.children[0] == sibling ? 0 : 1] = newParent;
+		}
+
+		for (uint32_t ancestor{ oldParent }; ancestor != INVALID_INDEX; ancestor = m_Nodes[ancestor].parent)
+		{
+			Node& node{ m_Nodes[ancestor] };
+			node.box = AABB::Merge(m_Nodes[node.children[0]].box, m_Nodes[node.children[1]].box);
+		}
+	}
+
+	void BVH::RemoveLeaf(uint32_t leaf)
+	{
+		m_IsRefitOrderDirty = true;
+
+		if (leaf == m_RootNode)
+		{
+			m_RootNode = INVALID_INDEX;
+			return;
+		}
+
+		// The sibling takes the place of the parent
+		const uint32_t parent{ m_Nodes[leaf].parent };
+		const uint32_t grandParent{ m_Nodes[parent].parent };
+		const uint32_t sibling{ m_Nodes[parent].children[m_Nodes[parent].children[0] == leaf ? 1 : 0] };
+
+		if (grandParent == INVALID_INDEX)
+		{
+			m_RootNode = sibling;
+			m_Nodes[sibling].parent = INVALID_INDEX;
+		}
+		else
+		{
+			Node& grandParentNode{ m_Nodes[grandParent] };
+			grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+			m_Nodes[sibling].parent = grandParent;
+
+			for (uint32_t ancestor{ grandParent }; ancestor != INVALID_INDEX; ancestor = m_Nodes[ancestor].parent)
+			{
+				Node& node{ m_Nodes[ancestor] };
+				node.box = AABB::Merge(m_Nodes[node.children[0]].box, m_Nodes[node.children[1]].box);
+			}
+		}
+
+		FreeNode(parent);
+	}
+
+	uint32_t BVH::BuildRange(uint32_t* pLeaves, uint32_t numLeaves, uint32_t parent)
+	{
+		if (numLeaves == 1)
+		{
+			m_Nodes[pLeaves[0]].parent = parent;
+			return pLeaves[0];
+		}
+
+		AABB centroidBounds{};
+		for (uint32_t i{}; i < numLeaves; ++i)
+		{
+			centroidBounds.Grow(m_Nodes[pLeaves[i]].box.GetCenter());
+		}
+
+		const Vector3 centroidExtents{ centroidBounds.max - centroidBounds.min };
+		int axis{ 0 };
+		if (centroidExtents.y > centroidExtents[axis])
+			axis = 1;
+		if (centroidExtents.z > centroidExtents[axis])
+			axis = 2;
+
+		// Bin the centroids along the widest axis, split where area * count on both sides is the lowest
+		// Every centroid at the same spot => any split is as good as the middle
+		constexpr int NUM_BINS{ 16 };
+		uint32_t splitIndex{ numLeaves / 2 };
+
+		if (centroidExtents[axis] > 0.f)
+		{
+			const float binScale{ NUM_BINS / centroidExtents[axis] };
+			const auto getBin{ [&](uint32_t leaf)
+				{
+					const int bin{ static_cast<int>((m_Nodes[leaf].box.GetCenter()[axis] - centroidBounds.min[axis]) * binScale) };
+					return std::min(bin, NUM_BINS - 1);
+				} };
+
+			std::array<AABB, NUM_BINS> binBoxes{};
+			std::array<uint32_t, NUM_BINS> binCounts{};
+			for (uint32_t i{}; i < numLeaves; ++i)
+			{
+				const int bin{ getBin(pLeaves[i]) };
+				binBoxes[bin] = AABB::Merge(binBoxes[bin], m_Nodes[pLeaves[i]].box);
+				++binCounts[bin];
+			}
+
+			// Costs of everything right of every split, then sweep from the left
+			std::array<float, NUM_BINS> rightCosts{};
+			AABB rightBox{};
+			uint32_t rightCount{};
+			for (int bin{ NUM_BINS - 1 }; bin > 0; --bin)
+			{
+				rightBox = AABB::Merge(rightBox, binBoxes[bin]);
+				rightCount += binCounts[bin];
+				rightCosts[bin] = rightBox.GetSurfaceArea() * rightCount;
+			}
+
+			float bestCost{ FLT_MAX };
+			int bestSplit{ -1 };
+			AABB leftBox{};
+			uint32_t leftCount{};
+			for (int bin{ 1 }; bin < NUM_BINS; ++bin)
+			{
+				leftBox = AABB::Merge(leftBox, binBoxes[bin - 1]);
+				leftCount += binCounts[bin - 1];
+				if (leftCount == 0 || leftCount == numLeaves)
+					continue;
+
+				const float cost{ leftBox.GetSurfaceArea() * leftCount + rightCosts[bin] };
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = bin;
+				}
+			}
+
+			if (bestSplit > 0)
+			{
+				uint32_t* pMiddle{ std::partition(pLeaves, pLeaves + numLeaves, [&](uint32_t leaf) { return getBin(leaf) < bestSplit; }) };
+				splitIndex = static_cast<uint32_t>(pMiddle - pLeaves);
+			}
+		}
+
+		const uint32_t node{ AllocateNode() };
+		m_Nodes[node].parent = parent;
+
+		const uint32_t left{ BuildRange(pLeaves, splitIndex, node) };
+		const uint32_t right{ BuildRange(pLeaves + splitIndex, numLeaves - splitIndex, node) };
+
+		Node& nodeRef{ m_Nodes[node] }; // AllocateNode may have grown the vector
+		nodeRef.children[0] = left;
+		nodeRef.children[1] = right;
+		nodeRef.box = AABB::Merge(m_Nodes[left].box, m_Nodes[right].box);
+		return node;
+	}
+
+	void BVH::UpdateRefitOrder()
+	{
+		m_RefitOrder.clear();
+		if (m_RootNode == INVALID_INDEX)
+		{
+			m_IsRefitOrderDirty = false;
+			return;
+		}
+
+		// Pre-order, reversed afterwards => children before parents
+		std::vector<uint32_t> stack{ m_RootNode };
+		while (!stack.empty())
+		{
+			const uint32_t nodeIndex{ stack.back() };
+			stack.pop_back();
+
+			const Node& node{ m_Nodes[nodeIndex] };
+			if (node.IsLeaf())
+				continue;
+
+			m_RefitOrder.emplace_back(nodeIndex);
+			stack.emplace_back(node.children[0]);
+			stack.emplace_back(node.children[1]);
+		}
+
+		std::reverse(m_RefitOrder.begin(), m_RefitOrder.end());
+		m_IsRefitOrderDirty = false;
+	}
+
+	float BVH::RefitNodes()
+	{
+		float internalArea{};
+		for (const uint32_t nodeIndex : m_RefitOrder)
+		{
+			Node& node{ m_Nodes[nodeIndex] };
+			node.box = AABB::Merge(m_Nodes[node.children[0]].box, m_Nodes[node.children[1]].box);
+			internalArea += node.box.GetSurfaceArea();
+		}
+
+		const float rootArea{ m_Nodes[m_RootNode].box.GetSurfaceArea() };
+		return rootArea > 0.f ? internalArea / rootArea : 0.f;
+	}
+
+	void BVH::GetChildrenNearestFirst(const Node& node, const Vector3& point, uint32_t& nearChild, uint32_t& farChild) const
+	{
+		const auto squaredDistance{ [&](const AABB& box)
+			{
+				const Vector3 closest{ Vector3::Min(Vector3::Max(point, box.min), box.max) };
+				return (closest - point).SqrMagnitude();
+			} };
+
+		const bool isFirstNearer{ squaredDistance(m_Nodes[node.children[0]].box) <= squaredDistance(m_Nodes[node.children[1]].box) };
+		nearChild = node.children[isFirstNearer ? 0 : 1];
+		farChild = node.children[isFirstNearer ? 1 : 0];
+	}
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cfloat>
+#include <utility>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "BoundingVolumes.h"
+
+namespace dae
+{
+	// Dynamic bounding volume hierarchy over world space object boxes
+	// Objects are inserted and removed one at a time, next to the sibling that grows the tree the least (surface area)
+	// Moving objects only refit => the topology slowly gets worse, Refit rebuilds top-down once the tree got too loose
+	class BVH final
+	{
+	public:
+		using ObjectId = uint32_t; // Chosen by the caller, keep them dense - leaves are looked up by id
+		static constexpr uint32_t INVALID_INDEX{ UINT32_MAX };
+
+		void Insert(ObjectId object, const AABB& box);
+		void Remove(ObjectId object);
+		void Clear();
+
+		// Leaf boxes only, the tree is stale until Refit
+		// Different objects may be updated from different threads
+		void SetBox(ObjectId object, const AABB& box) { m_Nodes[m_ObjectLeaves[object]].box = box; };
+		void Refit();
+		void Rebuild(); // Binned SAH, top-down over the current leaf boxes
+
+		uint32_t GetObjectCount() const { return m_NumObjects; };
+		bool Contains(ObjectId object) const { return object < m_ObjectLeaves.size() && m_ObjectLeaves[object] != INVALID_INDEX; };
+		const AABB& GetBox(ObjectId object) const { return m_Nodes[m_ObjectLeaves[object]].box; };
+		AABB GetBounds() const { return m_RootNode != INVALID_INDEX ? m_Nodes[m_RootNode].box : AABB{}; };
+		uint32_t GetRebuildCount() const { return m_NumRebuilds; };
+
+		// Visits the tree nearest child first, seen from viewPoint => occluders tend to come before what they hide
+		// nodeTest(const AABB&) -> Containment, Outside skips the subtree, Inside accepts it without testing further
+		// leafFunction(ObjectId, bool isInside) for every object that was not rejected
+		template <typename NodeTest, typename LeafFunction>
+		void Query(const Vector3& viewPoint, NodeTest&& nodeTest, LeafFunction&& leafFunction) const;
+
+		// Closest hit along the ray, nodes are visited nearest first and skipped once they start behind the best hit
+		// hitFunction(ObjectId, float& distance) -> bool, an exact test for objects whose box the ray enters before distance
+		// Returns INVALID_INDEX when nothing was hit, distance holds the hit otherwise
+		template <typename HitFunction>
+		ObjectId Raycast(const Vector3& origin, const Vector3& direction, float& distance, HitFunction&& hitFunction) const;
+
+	private:
+		struct Node
+		{
+			AABB box{};
+			uint32_t parent{ INVALID_INDEX }; // Next free node while on the free list
+			uint32_t children[2]{ INVALID_INDEX, INVALID_INDEX };
+			ObjectId object{ INVALID_INDEX }; // Leaves only
+
+			bool IsLeaf() const { return children[0] == INVALID_INDEX; };
+		};
+
+		std::vector<Node> m_Nodes{};
+		std::vector<uint32_t> m_ObjectLeaves{}; // Leaf node per object id
+		uint32_t m_RootNode{ INVALID_INDEX };
+		uint32_t m_FreeNode{ INVALID_INDEX };
+		uint32_t m_NumObjects{};
+
+		// Internal nodes, children before their parents => one pass refits the whole tree
+		std::vector<uint32_t> m_RefitOrder{};
+		bool m_IsRefitOrderDirty{ false };
+
+		// Sum of the internal node areas relative to the root, right after the tree was built or changed
+		float m_BuildCost{};
+		uint32_t m_NumRebuilds{};
+		static constexpr float REBUILD_COST_RATIO{ 1.5f };
+
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t node);
+		void InsertLeaf(uint32_t leaf);
+		void RemoveLeaf(uint32_t leaf);
+		uint32_t BuildRange(uint32_t* pLeaves, uint32_t numLeaves, uint32_t parent);
+		void UpdateRefitOrder();
+		float RefitNodes(); // Returns the cost of the refitted tree
+
+		// Nearest child first, using the squared distance from the point to the child boxes
+		void GetChildrenNearestFirst(const Node& node, const Vector3& point, uint32_t& nearChild, uint32_t& farChild) const;
+	};
+
+	template <typename NodeTest, typename LeafFunction>
+	void BVH::Query(const Vector3& viewPoint, NodeTest&& nodeTest, LeafFunction&& leafFunction) const
+	{
+		if (m_RootNode == INVALID_INDEX)
+			return;
+
+		// A subtree that is fully inside reports its leaves without testing them
+		struct Entry
+		{
+			uint32_t node;
+			bool isInside;
+		};
+		std::vector<Entry> stack{};
+		stack.reserve(64);
+		stack.emplace_back(Entry{ m_RootNode, false });
+
+		while (!stack.empty())
+		{
+			const Entry entry{ stack.back() };
+			stack.pop_back();
+
+			const Node& node{ m_Nodes[entry.node] };
+			bool isInside{ entry.isInside };
+			if (!isInside)
+			{
+				const Containment containment{ nodeTest(node.box) };
+				if (containment == Containment::Outside)
+					continue;
+
+				isInside = containment == Containment::Inside;
+			}
+
+			if (node.IsLeaf())
+			{
+				leafFunction(node.object, isInside);
+				continue;
+			}
+
+			uint32_t nearChild{};
+			uint32_t farChild{};
+			GetChildrenNearestFirst(node, viewPoint, nearChild, farChild);
+			stack.emplace_back(Entry{ farChild, isInside });
+			stack.emplace_back(Entry{ nearChild, isInside });
+		}
+	}
+
+	template <typename HitFunction>
+	BVH::ObjectId BVH::Raycast(const Vector3& origin, const Vector3& direction, float& distance, HitFunction&& hitFunction) const
+	{
+		ObjectId closestObject{ INVALID_INDEX };
+		if (m_RootNode == INVALID_INDEX)
+			return closestObject;
+
+		const Vector3 invDirection{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+		struct Entry
+		{
+			uint32_t node;
+			float entryDistance;
+		};
+		std::vector<Entry> stack{};
+		stack.reserve(64);
+
+		float entryDistance{};
+		if (m_Nodes[m_RootNode].box.IntersectRay(origin, invDirection, distance, entryDistance))
+			stack.emplace_back(Entry{ m_RootNode, entryDistance });
+
+		while (!stack.empty())
+		{
+			const Entry entry{ stack.back() };
+			stack.pop_back();
+
+			// A closer hit was found after this node was pushed
+			if (entry.entryDistance > distance)
+				continue;
+
+			const Node& node{ m_Nodes[entry.node] };
+			if (node.IsLeaf())
+			{
+				float hitDistance{ distance };
+				if (hitFunction(node.object, hitDistance) && hitDistance < distance)
+				{
+					distance = hitDistance;
+					closestObject = node.object;
+				}
+				continue;
+			}
+
+			Entry hits[2]{};
+			int numHits{};
+			for (const uint32_t child : node.children)
+			{
+				if (m_Nodes[child].box.IntersectRay(origin, invDirection, distance, entryDistance))
+					hits[numHits++] = Entry{ child, entryDistance };
+			}
+
+			// Nearest on top of the stack
+			if (numHits == 2 && hits[0].entryDistance < hits[1].entryDistance)
+				std::swap(hits[0], hits[1]);
+
+			for (int i{}; i < numHits; ++i)
+			{
+				stack.emplace_back(hits[i]);
+			}
+		}
+
+		return closestObject;
+	}
+}
@@ -0,0 +1,238 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+
+namespace dae
+{
+	namespace
+	{
+		// The vehicle is placed here by the Renderer
+		const Vector3 SCENE_CENTER{ 0.f, 0.f, 50.f };
+
+		// Timelines loop after this many seconds
+		constexpr float SCENARIO_DURATION{ 10.f };
+
+		constexpr int INSTANCE_GRID_SIZE{ 5 };
+		constexpr float INSTANCE_SPACING{ 25.f };
+
+		constexpr int CROWD_GRID_SIZE{ 12 };
+		constexpr float CROWD_SPACING{ 40.f };
+	}
+
+	const char* GetScenarioName(BenchmarkScenario scenario)
+	{
+		switch (scenario)
+		{
+		case BenchmarkScenario::Orbit:
+			return "orbit";
+		case BenchmarkScenario::FlyThrough:
+			return "fly_through";
+		case BenchmarkScenario::CloseUp:
+			return "close_up";
+		case BenchmarkScenario::ManyInstances:
+			return "many_instances";
+		case BenchmarkScenario::Crowd:
+			return "crowd";
+		default:
+			return "unknown";
+		}
+	}
+
+	BenchmarkFrame EvaluateScenario(BenchmarkScenario scenario, float time)
+	{
+		const float t{ std::fmod(time, SCENARIO_DURATION) / SCENARIO_DURATION }; // [0, 1)
+
+		BenchmarkFrame frame{};
+		frame.cameraTarget = SCENE_CENTER;
+
+		switch (scenario)
+		{
+		case BenchmarkScenario::Orbit:
+		{
+			constexpr float radius{ 40.f };
+			const float angle{ t * 2.f * PI };
+			frame.cameraOrigin = SCENE_CENTER + Vector3{ radius * std::sin(angle), 10.f, -radius * std::cos(angle) };
+			break;
+		}
+		case BenchmarkScenario::FlyThrough:
+		{
+			// Starts far in front of the vehicle, passes it on the side and ends behind it
+			const Vector3 start{ -15.f, 5.f, -60.f };
+			const Vector3 end{ 15.f, 5.f, 110.f };
+			frame.cameraOrigin = start + (end - start) * t;
+			frame.cameraTarget = frame.cameraOrigin + Vector3{ 0.f, -0.1f, 1.f };
+			break;
+		}
+		case BenchmarkScenario::CloseUp:
+			frame.cameraOrigin = SCENE_CENTER + Vector3{ 0.f, 3.f, -12.f };
+			frame.meshYaw = t * 2.f * PI;
+			break;
+		case BenchmarkScenario::ManyInstances:
+		{
+			const float halfExtent{ (INSTANCE_GRID_SIZE - 1) * INSTANCE_SPACING * 0.5f };
+			for (int z{}; z < INSTANCE_GRID_SIZE; ++z)
+			{
+				for (int x{}; x < INSTANCE_GRID_SIZE; ++x)
+				{
+					frame.instanceOffsets.emplace_back(Vector3{ x * INSTANCE_SPACING - halfExtent, 0.f, z * INSTANCE_SPACING - halfExtent });
+				}
+			}
+
+			frame.cameraOrigin = SCENE_CENTER + Vector3{ 0.f, 70.f, -110.f };
+			frame.meshYaw = t * 2.f * PI;
+			break;
+		}
+		case BenchmarkScenario::Crowd:
+		{
+			const float halfExtent{ (CROWD_GRID_SIZE - 1) * CROWD_SPACING * 0.5f };
+			for (int z{}; z < CROWD_GRID_SIZE; ++z)
+			{
+				for (int x{}; x < CROWD_GRID_SIZE; ++x)
+				{
+					frame.instanceOffsets.emplace_back(Vector3{ x * CROWD_SPACING - halfExtent, 0.f, z * CROWD_SPACING - halfExtent });
+				}
+			}
+
+			// Seen from above the front rows hide little, pulls back until every vehicle is only a few pixels tall
+			frame.cameraOrigin = SCENE_CENTER + Vector3{ 0.f, 200.f + 300.f * t, -250.f - 400.f * t };
+			frame.farPlane = 1000.f;
+			frame.meshYaw = t * 2.f * PI;
+			break;
+		}
+		default:
+			break;
+		}
+
+		return frame;
+	}
+
+	float GetPercentile(const std::vector<float>& sortedValues, float percentile)
+	{
+		if (sortedValues.empty())
+			return 0.f;
+
+		// Nearest rank
+		const size_t rank{ static_cast<size_t>(std::ceil(percentile / 100.f * sortedValues.size())) };
+		return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+	}
+
+	void SummarizeFrameTimes(BenchmarkResult& result)
+	{
+		if (result.frameTimes.empty())
+			return;
+
+		std::vector<float> sortedTimes{ result.frameTimes };
+		std::sort(sortedTimes.begin(), sortedTimes.end());
+
+		result.minTime = sortedTimes.front();
+		result.maxTime = sortedTimes.back();
+		result.meanTime = std::accumulate(sortedTimes.begin(), sortedTimes.end(), 0.f) / static_cast<float>(sortedTimes.size());
+		result.p50Time = GetPercentile(sortedTimes, 50.f);
+		result.p95Time = GetPercentile(sortedTimes, 95.f);
+		result.p99Time = GetPercentile(sortedTimes, 99.f);
+	}
+
+	bool WriteBenchmarkJSON(const std::string& filePath, const BenchmarkConfiguration& configuration, const std::vector<BenchmarkResult>& results)
+	{
+		std::ofstream file(filePath);
+		if (!file)
+			return false;
+
+		file << "{\n";
+		file << "  \"version\": 1,\n";
+		file << "  \"backend\": \"" << configuration.backendName << "\",\n";
+#if defined(NDEBUG)
+		file << "  \"build\": \"release\",\n";
+#else
+		file << "  \"build\": \"debug\",\n";
+#endif
+		file << "  \"lod_active\": " << (configuration.isLodActive ? "true" : "false") << ",\n";
+		file << "  \"vertex_format\": \"" << configuration.vertexFormat << "\",\n";
+		file << "  \"transparency_mode\": \"" << configuration.transparencyMode << "\",\n";
+		file << "  \"results\": [\n";
+
+		for (size_t i{}; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result{ results[i] };
+
+			file << "    {\n";
+			file << "      \"scenario\": \"" << result.scenarioName << "\",\n";
+			file << "      \"width\": " << result.resolution.width << ",\n";
+			file << "      \"height\": " << result.resolution.height << ",\n";
+			file << "      \"frames\": " << result.frameTimes.size() << ",\n";
+			file << "      \"time_step_s\": " << result.timeStep << ",\n";
+			file << "      \"min_ms\": " << result.minTime << ",\n";
+			file << "      \"max_ms\": " << result.maxTime << ",\n";
+			file << "      \"mean_ms\": " << result.meanTime << ",\n";
+			file << "      \"p50_ms\": " << result.p50Time << ",\n";
+			file << "      \"p95_ms\": " << result.p95Time << ",\n";
+			file << "      \"p99_ms\": " << result.p99Time << ",\n";
+			file << "      \"frame_budget_ms\": " << result.frameBudget << ",\n";
+			file << "      \"stalls\": " << result.numStalls << ",\n";
+
+			// Bucketed percentiles, within 1% of the exact ones but cheap enough to keep for any number of frames
+			const FrameTimeHistogram& histogram{ result.frameTimeHistogram };
+			file << "      \"histogram_ms\": {\"p50\": " << histogram.GetValueAtPercentile(50.0) * 1e-6
+				<< ", \"p90\": " << histogram.GetValueAtPercentile(90.0) * 1e-6
+				<< ", \"p99\": " << histogram.GetValueAtPercentile(99.0) * 1e-6
+				<< ", \"p99_9\": " << histogram.GetValueAtPercentile(99.9) * 1e-6
+				<< ", \"max\": " << histogram.GetMax() * 1e-6 << "},\n";
+			file << "      \"pipeline_statistics_total\": {";
+
+			bool isFirstCounter{ true };
+			result.statistics.ForEachCounter([&](const char* name, uint64_t value)
+				{
+					file << (isFirstCounter ? "" : ", ") << "\"" << name << "\": " << value;
+					isFirstCounter = false;
+				});
+
+			file << "},\n";
+			file << "      \"vertices_per_second\": " << result.statistics.GetVerticesPerSecond() << ",\n";
+			file << "      \"mesh_cull_rate\": " << result.statistics.GetMeshCullRate() << ",\n";
+			file << "      \"cluster_cull_rate\": " << result.statistics.GetClusterCullRate() << ",\n";
+
+			// Averages per compared frame, the times are the transparent pass of each mode
+			if (result.numTransparencyComparisons > 0)
+			{
+				const TransparencyComparison& comparison{ result.transparencyComparison };
+				const double numComparisons{ static_cast<double>(result.numTransparencyComparisons) };
+				file << "      \"transparency_comparison\": {\"frames\": " << result.numTransparencyComparisons
+					<< ", \"triangles\": " << comparison.numTriangles / numComparisons
+					<< ", \"sorted_ms\": " << comparison.sortedTime / numComparisons
+					<< ", \"oit_ms\": " << comparison.oitTime / numComparisons
+					<< ", \"mean_channel_difference\": " << comparison.meanChannelError / numComparisons
+					<< ", \"max_channel_difference\": " << comparison.maxChannelError << "},\n";
+			}
+
+			file << "      \"frame_times_ms\": [";
+
+			for (size_t frame{}; frame < result.frameTimes.size(); ++frame)
+			{
+				file << (frame > 0 ? ", " : "") << result.frameTimes[frame];
+			}
+
+			file << "]\n";
+			file << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+
+		file << "  ]\n";
+		file << "}\n";
+
+		return static_cast<bool>(file);
+	}
+
+	void PrintBenchmarkResult(const BenchmarkResult& result)
+	{
+		std::cout << result.scenarioName << " @ " << result.resolution.width << "x" << result.resolution.height
+			<< " | mean " << result.meanTime << " ms | p50 " << result.p50Time << " ms | p95 " << result.p95Time
+			<< " ms | p99 " << result.p99Time << " ms | max " << result.maxTime << " ms | stalls " << result.numStalls
+			<< " | " << result.statistics.GetVerticesPerSecond() * 1e-6 << " Mvertices/s | "
+			<< result.statistics.GetMeshCullRate() * 100.0 << "% meshes culled | "
+			<< result.statistics.GetClusterCullRate() * 100.0 << "% clusters culled | "
+			<< (result.frameTimes.empty() ? 0 : result.statistics.meshTriangles / result.frameTimes.size()) << " mesh triangles/frame ("
+			<< result.statistics.GetLodSkipRate() * 100.0 << "% skipped by LOD)\n";
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "PipelineStatistics.h"
+#include "FrameTimeHistogram.h"
+
+namespace dae
+{
+	// Scripted timelines - the same time always gives the same camera and mesh transforms
+	enum class BenchmarkScenario
+	{
+		Orbit,         // Camera circles the vehicle once
+		FlyThrough,    // Camera flies from far away past the vehicle
+		CloseUp,       // Vehicle fills the screen while it turns
+		ManyInstances, // Grid of vehicles seen from above
+		Crowd,         // Large grid of vehicles, most of them far away while the camera pulls back
+
+		Count
+	};
+	constexpr int BENCHMARK_SCENARIO_COUNT{ static_cast<int>(BenchmarkScenario::Count) };
+
+	struct BenchmarkFrame
+	{
+		Vector3 cameraOrigin{};
+		Vector3 cameraTarget{};
+		float meshYaw{};
+		std::vector<Vector3> instanceOffsets{}; // One vehicle per offset, a single one at the origin when empty
+		float farPlane{ 100.f }; // Same as the interactive camera unless the script looks further
+	};
+
+	struct BenchmarkResolution
+	{
+		int width{};
+		int height{};
+	};
+
+	struct BenchmarkResult
+	{
+		std::string scenarioName{};
+		BenchmarkResolution resolution{};
+		float timeStep{}; // s, simulated time between two frames
+		std::vector<float> frameTimes{}; // ms, wall clock time from frame to frame (Timer::Update)
+		FrameTimeHistogram frameTimeHistogram{}; // ns, the same frames
+		float frameBudget{}; // ms, slower frames are stalls
+		uint64_t numStalls{};
+		PipelineStatistics statistics{}; // Summed over every recorded frame (software backend only)
+
+		// Extra untimed frames of the same timeline with both transparency modes, summed (software backend only)
+		// Frames without transparent triangles are left out
+		uint32_t numTransparencyComparisons{};
+		TransparencyComparison transparencyComparison{};
+
+		float minTime{};
+		float maxTime{};
+		float meanTime{};
+		float p50Time{};
+		float p95Time{};
+		float p99Time{};
+	};
+
+	// What every result of a run was measured with, written once at the top of the JSON
+	struct BenchmarkConfiguration
+	{
+		std::string backendName{};
+		bool isLodActive{ true };
+		std::string vertexFormat{};
+		std::string transparencyMode{}; // Of the timed frames
+	};
+
+	const char* GetScenarioName(BenchmarkScenario scenario);
+	BenchmarkFrame EvaluateScenario(BenchmarkScenario scenario, float time);
+
+	// Fills in the statistics from result.frameTimes
+	void SummarizeFrameTimes(BenchmarkResult& result);
+	float GetPercentile(const std::vector<float>& sortedValues, float percentile);
+
+	bool WriteBenchmarkJSON(const std::string& filePath, const BenchmarkConfiguration& configuration, const std::vector<BenchmarkResult>& results);
+	void PrintBenchmarkResult(const BenchmarkResult& result);
+}
@@ -0,0 +1,164 @@
+#include "BoundingVolumes.h"
+#include <cmath>
+#include <utility>
+
+namespace dae
+{
+	AABB AABB::Transformed(const Matrix& matrix) const
+	{
+		if (IsEmpty())
+			return *this;
+
+		// Arvo - every world extent sums the absolute contributions of the three box axes
+		const Vector3 center{ matrix.TransformPoint(GetCenter()) };
+		const Vector3 extents{ GetExtents() };
+		const Vector3 axisX{ matrix.GetAxisX() };
+		const Vector3 axisY{ matrix.GetAxisY() };
+		const Vector3 axisZ{ matrix.GetAxisZ() };
+
+		Vector3 worldExtents{};
+		for (int i{}; i < 3; ++i)
+		{
+			worldExtents[i] = std::abs(axisX[i]) * extents.x + std::abs(axisY[i]) * extents.y + std::abs(axisZ[i]) * extents.z;
+		}
+
+		return AABB{ center - worldExtents, center + worldExtents };
+	}
+
+	bool AABB::IntersectRay(const Vector3& origin, const Vector3& invDirection, float maxDistance, float& entryDistance) const
+	{
+		float tMin{ 0.f };
+		float tMax{ maxDistance };
+
+		for (int i{}; i < 3; ++i)
+		{
+			float t0{ (min[i] - origin[i]) * invDirection[i] };
+			float t1{ (max[i] - origin[i]) * invDirection[i] };
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			// NaN (origin on a slab, direction 0) keeps the previous bounds
+			tMin = t0 > tMin ? t0 : tMin;
+			tMax = t1 < tMax ? t1 : tMax;
+			if (tMin > tMax)
+				return false;
+		}
+
+		entryDistance = tMin;
+		return true;
+	}
+
+	bool IntersectRayTriangle(const Vector3& origin, const Vector3& direction, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance)
+	{
+		const Vector3 edge1{ v1 - v0 };
+		const Vector3 edge2{ v2 - v0 };
+		const Vector3 p{ Vector3::Cross(direction, edge2) };
+		const float determinant{ Vector3::Dot(edge1, p) };
+		if (std::abs(determinant) < 1e-12f)
+			return false;
+
+		const float invDeterminant{ 1.f / determinant };
+		const Vector3 toOrigin{ origin - v0 };
+		const float u{ Vector3::Dot(toOrigin, p) * invDeterminant };
+		if (u < 0.f || u > 1.f)
+			return false;
+
+		const Vector3 q{ Vector3::Cross(toOrigin, edge1) };
+		const float v{ Vector3::Dot(direction, q) * invDeterminant };
+		if (v < 0.f || u + v > 1.f)
+			return false;
+
+		const float t{ Vector3::Dot(edge2, q) * invDeterminant };
+		if (t < 0.f)
+			return false;
+
+		distance = t;
+		return true;
+	}
+
+	Frustum Frustum::FromViewProjection(const Matrix& viewProjMatrix)
+	{
+		// clip = p * M => every clip component is a dot product with a column of M (Gribb & Hartmann)
+		const auto column{ [&](int c)
+			{
+				return Vector4{ viewProjMatrix[0][c], viewProjMatrix[1][c], viewProjMatrix[2][c], viewProjMatrix[3][c] };
+			} };
+
+		const Vector4 x{ column(0) };
+		const Vector4 y{ column(1) };
+		const Vector4 z{ column(2) };
+		const Vector4 w{ column(3) };
+
+		Frustum frustum{};
+		frustum.planes[Left] = w + x;
+		frustum.planes[Right] = w - x;
+		frustum.planes[Bottom] = w + y;
+		frustum.planes[Top] = w - y;
+		frustum.planes[Near] = z;
+		frustum.planes[Far] = w - z;
+
+		for (Vector4& plane : frustum.planes)
+		{
+			const float length{ plane.GetXYZ().Magnitude() };
+			plane = plane * (1.f / length);
+		}
+
+		return frustum;
+	}
+
+	bool Frustum::IsSphereOutside(const Vector3& center, float radius) const
+	{
+		for (const Vector4& plane : planes)
+		{
+			if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool Frustum::IsBoxOutside(const AABB& objectBox, const Matrix& worldMatrix) const
+	{
+		// The box axes are the rows of the world matrix, scaled by the extents
+		const Vector3 center{ worldMatrix.TransformPoint(objectBox.GetCenter()) };
+		const Vector3 extents{ objectBox.GetExtents() };
+		const Vector3 axisX{ worldMatrix.GetAxisX() * extents.x };
+		const Vector3 axisY{ worldMatrix.GetAxisY() * extents.y };
+		const Vector3 axisZ{ worldMatrix.GetAxisZ() * extents.z };
+
+		for (const Vector4& plane : planes)
+		{
+			const Vector3 normal{ plane.GetXYZ() };
+			const float projectedRadius{ std::abs(Vector3::Dot(normal, axisX)) + std::abs(Vector3::Dot(normal, axisY))
+				+ std::abs(Vector3::Dot(normal, axisZ)) };
+
+			if (Vector3::Dot(normal, center) + plane.w < -projectedRadius)
+				return true;
+		}
+
+		return false;
+	}
+
+	Containment Frustum::Classify(const AABB& worldBox) const
+	{
+		if (worldBox.IsEmpty())
+			return Containment::Outside;
+
+		const Vector3 center{ worldBox.GetCenter() };
+		const Vector3 extents{ worldBox.GetExtents() };
+		Containment containment{ Containment::Inside };
+
+		for (const Vector4& plane : planes)
+		{
+			const float distance{ plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w };
+			const float projectedRadius{ std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z };
+
+			if (distance < -projectedRadius)
+				return Containment::Outside;
+			if (distance < projectedRadius)
+				containment = Containment::Intersecting;
+		}
+
+		return containment;
+	}
+}
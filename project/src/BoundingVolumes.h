@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cfloat>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+
+namespace dae
+{
+	struct BoundingSphere
+	{
+		Vector3 center{};
+		float radius{};
+	};
+
+	struct AABB
+	{
+		Vector3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+		Vector3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		Vector3 GetCenter() const { return (min + max) * 0.5f; };
+		Vector3 GetExtents() const { return (max - min) * 0.5f; };
+		bool IsEmpty() const { return min.x > max.x; };
+
+		void Grow(const Vector3& point)
+		{
+			min = Vector3::Min(min, point);
+			max = Vector3::Max(max, point);
+		};
+
+		float GetSurfaceArea() const
+		{
+			const Vector3 size{ max - min };
+			return IsEmpty() ? 0.f : 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		};
+
+		static AABB Merge(const AABB& a, const AABB& b) { return AABB{ Vector3::Min(a.min, b.min), Vector3::Max(a.max, b.max) }; };
+
+		AABB Transformed(const Matrix& matrix) const; // Box around the transformed box, empty stays empty
+
+		// Slab test, invDirection = 1 / direction per component => entry distance of the ray
+		bool IntersectRay(const Vector3& origin, const Vector3& invDirection, float maxDistance, float& entryDistance) const;
+	};
+
+	enum class Containment
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	// Moller-Trumbore, both windings, distance in units of direction
+	bool IntersectRayTriangle(const Vector3& origin, const Vector3& direction, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance);
+
+	// Planes of a view projection in world space, normals point inwards => dot(normal, p) + d >= 0 inside
+	struct Frustum
+	{
+		enum Plane
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		std::array<Vector4, PlaneCount> planes{}; // xyz = unit normal, w = d
+
+		// Row vectors and D3D clip space (0 <= z <= w), like CreatePerspectiveFovLH
+		static Frustum FromViewProjection(const Matrix& viewProjMatrix);
+
+		bool IsSphereOutside(const Vector3& center, float radius) const; // Fully behind one plane, conservative near the corners
+		bool IsBoxOutside(const AABB& objectBox, const Matrix& worldMatrix) const; // Oriented box in world space, same test
+		Containment Classify(const AABB& worldBox) const;
+	};
+}
@@ -18,6 +18,7 @@ namespace dae
 		invViewMatrix{},
 		viewMatrix{},
 		projectionMatrix{},
+		frustum{},
 		CameraRotationSpeed{ PI * 5.f },
 		initialCameraMoveSpeedMouse{ 500.f },
 		initialCameraMoveSpeedKeys{ 50.f }
@@ -38,6 +39,7 @@ namespace dae
 		invViewMatrix{},
 		viewMatrix{},
 		projectionMatrix{},
+		frustum{},
 		CameraRotationSpeed{ PI * 5.f },
 		initialCameraMoveSpeedMouse{ 500.f },
 		initialCameraMoveSpeedKeys{ 50.f }
@@ -77,6 +79,11 @@ namespace dae
 		//DirectX Implementation => https://learn.microsoft.com/en-us/windows/win32/direct3d9/d3dxmatrixperspectivefovlh
 	}
 
+	void Camera::CalculateFrustum()
+	{
+		frustum = Frustum::FromViewProjection(viewMatrix * projectionMatrix);
+	}
+
 	void Camera::Update(const Timer* pTimer, float aspectRatio, const RasterizerMode currentRasterizerState)
 	{
 		const float deltaTime{ pTimer->GetElapsed() };
@@ -174,6 +181,29 @@ namespace dae
 		//Update Matrices
 		CalculateViewMatrix();
 		CalculateProjectionMatrix(aspectRatio); //Try to optimize this - should only be called once or when fov/aspectRatio changes
+		CalculateFrustum();
+	}
+
+	void Camera::LookAt(const Vector3& _origin, const Vector3& target, float aspectRatio)
+	{
+		origin = _origin;
+
+		forward = target - origin;
+		forward.Normalize();
+
+		right = Vector3::Cross(Vector3::UnitY, forward);
+		right.Normalize();
+
+		up = Vector3::Cross(forward, right);
+		up.Normalize();
+
+		// Keep yaw and pitch in sync, so mouse input continues from the scripted direction
+		totalPitch = asinf(forward.y);
+		totalYaw = atan2f(forward.x, forward.z);
+
+		CalculateViewMatrix();
+		CalculateProjectionMatrix(aspectRatio);
+		CalculateFrustum();
 	}
 }
 
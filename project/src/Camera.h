@@ -5,6 +5,7 @@
 
 #include "Timer.h"
 #include "Math.h"
+#include "BoundingVolumes.h"
 
 namespace dae
 {
@@ -30,6 +31,7 @@ namespace dae
 		Matrix invViewMatrix;
 		Matrix viewMatrix;
 		Matrix projectionMatrix;
+		Frustum frustum; // World space, extracted once per frame after the matrices
 
 		float CameraRotationSpeed;
 		float initialCameraMoveSpeedMouse;
@@ -41,6 +43,11 @@ namespace dae
 
 		void CalculateProjectionMatrix(float aspectRatio);
 
+		void CalculateFrustum();
+
 		void Update(const Timer* pTimer, float aspectRatio, const RasterizerMode currentRasterizerState);
+
+		// Scripted camera (benchmarks) - no input, matrices are updated right away
+		void LookAt(const Vector3& _origin, const Vector3& target, float aspectRatio);
 	};
 }
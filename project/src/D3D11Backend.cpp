@@ -0,0 +1,543 @@
+#include "D3D11Backend.h"
+#include "Profiler.h"
+#include <iostream>
+#include <algorithm>
+
+#define SAFE_RELEASE(p) \
+if (p) {p->Release(); p = nullptr; }
+
+using namespace dae;
+
+D3D11Backend::D3D11Backend(SDL_Window* pWindow, int width, int height) :
+	m_pWindow{ pWindow },
+	m_Width{ width },
+	m_Height{ height }
+{
+	if (InitializeDirectX() != S_OK)
+		return;
+
+	CreateSamplerStates();
+
+	m_pOpaqueEffect = std::make_unique<OpaqueEffect>(m_pDevice);
+	m_pTransparencyEffect = std::make_unique<TransparencyEffect>(m_pDevice);
+
+	for (int format{}; format < VERTEX_FORMAT_COUNT; ++format)
+	{
+		const VertexFormat vertexFormat{ static_cast<VertexFormat>(format) };
+		if (FAILED(CreateInputLayout(m_pOpaqueEffect.get(), vertexFormat, &m_pOpaqueInputLayouts[format])) ||
+			FAILED(CreateInputLayout(m_pTransparencyEffect.get(), vertexFormat, &m_pTransparencyInputLayouts[format])))
+		{
+			std::wcout << L"Failed to create the input layouts\n";
+			return;
+		}
+	}
+
+	m_IsInitialized = true;
+}
+
+D3D11Backend::~D3D11Backend()
+{
+	// 0. Resources and effects created by the device
+	for (auto& pBuffer : m_pBuffers)
+	{
+		SAFE_RELEASE(pBuffer);
+	}
+	m_pTextures.clear();
+
+	for (int format{}; format < VERTEX_FORMAT_COUNT; ++format)
+	{
+		SAFE_RELEASE(m_pOpaqueInputLayouts[format]);
+		SAFE_RELEASE(m_pTransparencyInputLayouts[format]);
+	}
+	m_pOpaqueEffect.reset();
+	m_pTransparencyEffect.reset();
+
+	for (auto& pSampler : m_pSamplers)
+	{
+		SAFE_RELEASE(pSampler);
+	}
+
+	// 1. Unbind Render Target view and Depth Stencil view from Device Context
+	if (m_pDeviceContext)
+	{
+		m_pDeviceContext->ClearState();
+		m_pDeviceContext->Flush();
+	}
+
+	// 2. Release Views
+	SAFE_RELEASE(m_pDepthStencilView);
+	SAFE_RELEASE(m_pRenderTargetView);
+
+	// 3. Release Buffers
+	SAFE_RELEASE(m_pDepthStencilBuffer);
+	SAFE_RELEASE(m_pRenderTargetBuffer);
+
+	// 4. Release Swap Chain
+	SAFE_RELEASE(m_pSwapChain);
+
+	// 5. Handle Device Context BEFORE Device
+	SAFE_RELEASE(m_pDeviceContext);
+
+	// 6. Release Device
+	SAFE_RELEASE(m_pDevice);
+}
+
+BufferHandle D3D11Backend::CreateVertexBuffer(const std::vector<VertexIn>& vertices)
+{
+	return CreateBuffer(vertices.data(), sizeof(VertexIn) * static_cast<uint32_t>(vertices.size()), D3D11_BIND_VERTEX_BUFFER);
+}
+
+BufferHandle D3D11Backend::CreateVertexBuffer(const QuantizedVertexBuffer& vertices)
+{
+	const BufferHandle buffer{ CreateBuffer(vertices.vertices.data(), sizeof(QuantizedVertex) * static_cast<uint32_t>(vertices.vertices.size()),
+		D3D11_BIND_VERTEX_BUFFER) };
+
+	if (buffer != INVALID_HANDLE)
+		m_BufferLayouts[buffer - 1] = BufferLayout{ VertexFormat::Quantized, vertices.positionMin, vertices.positionExtent, IndexFormat::UInt32 };
+
+	return buffer;
+}
+
+BufferHandle D3D11Backend::CreateIndexBuffer(const std::vector<uint16_t>& indices)
+{
+	const BufferHandle buffer{ CreateBuffer(indices.data(), sizeof(uint16_t) * static_cast<uint32_t>(indices.size()), D3D11_BIND_INDEX_BUFFER) };
+
+	if (buffer != INVALID_HANDLE)
+		m_BufferLayouts[buffer - 1].indexFormat = IndexFormat::UInt16;
+
+	return buffer;
+}
+
+BufferHandle D3D11Backend::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+{
+	return CreateBuffer(indices.data(), sizeof(uint32_t) * static_cast<uint32_t>(indices.size()), D3D11_BIND_INDEX_BUFFER);
+}
+
+TextureHandle D3D11Backend::CreateTexture(const Texture* pTexture)
+{
+	D3D11Texture* pD3D11Texture{ D3D11Texture::Create(m_pDevice, pTexture) };
+	if (!pD3D11Texture)
+		return INVALID_HANDLE;
+
+	m_pTextures.emplace_back(pD3D11Texture);
+	return static_cast<TextureHandle>(m_pTextures.size());
+}
+
+// No mesh shaders in D3D11 - the input assembler keeps drawing the index buffer
+BufferHandle D3D11Backend::CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat)
+{
+	(void)meshlets;
+	(void)vertexFormat;
+	return INVALID_HANDLE;
+}
+
+void D3D11Backend::BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos)
+{
+	m_ViewProjMatrix = viewProjMatrix;
+	m_CameraPos = cameraPos;
+
+	// Clear Views at the start of each Frame
+	const float clearColorRGBA[4]{ clearColor.r, clearColor.g, clearColor.b, 1.f };
+	m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, clearColorRGBA);
+	m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+}
+
+void D3D11Backend::EndFrame()
+{
+	DAE_PROFILE_SCOPE("Present");
+
+	// Present BackBuffer (SWAP)
+	m_pSwapChain->Present(0, 0);
+}
+
+void D3D11Backend::SetPipelineState(const PipelineState& pipelineState)
+{
+	m_PipelineState = pipelineState;
+
+	if (pipelineState.blendMode == BlendMode::Opaque)
+	{
+		m_pCurrentEffect = m_pOpaqueEffect.get();
+	}
+	else
+	{
+		m_pCurrentEffect = m_pTransparencyEffect.get();
+	}
+
+	BindInputLayout();
+}
+
+void D3D11Backend::SetVertexBuffer(BufferHandle vertexBuffer)
+{
+	ID3D11Buffer* pVertexBuffer{ GetBuffer(vertexBuffer) };
+	const VertexFormat previousFormat{ m_VertexBufferLayout.format };
+	m_VertexBufferLayout = vertexBuffer != INVALID_HANDLE ? m_BufferLayouts[vertexBuffer - 1] : BufferLayout{};
+
+	const UINT stride{ static_cast<UINT>(GetVertexSize(m_VertexBufferLayout.format)) };
+	constexpr UINT offset{ 0 };
+	m_pDeviceContext->IASetVertexBuffers(0, 1, &pVertexBuffer, &stride, &offset);
+
+	if (m_VertexBufferLayout.format != previousFormat)
+		BindInputLayout();
+}
+
+void D3D11Backend::SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology)
+{
+	const IndexFormat indexFormat{ indexBuffer != INVALID_HANDLE ? m_BufferLayouts[indexBuffer - 1].indexFormat : IndexFormat::UInt32 };
+	m_pDeviceContext->IASetIndexBuffer(GetBuffer(indexBuffer), indexFormat == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
+
+	if (topology == PrimitiveTopology::TriangleList)
+	{
+		m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	}
+	else
+	{
+		m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	}
+}
+
+void D3D11Backend::SetTexture(TextureSlot slot, TextureHandle texture)
+{
+	m_pBoundTextures[static_cast<int>(slot)] = texture != INVALID_HANDLE ? m_pTextures[texture - 1].get() : nullptr;
+}
+
+void D3D11Backend::SetWorldMatrix(const Matrix& worldMatrix)
+{
+	m_WorldMatrix = worldMatrix;
+}
+
+void D3D11Backend::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	if (!m_pCurrentEffect)
+		return;
+
+	Matrix worldViewProjectionMatrix{ m_WorldMatrix * m_ViewProjMatrix };
+	m_pCurrentEffect->GetWorldViewProjMatrix()->SetMatrix(reinterpret_cast<float*>(&worldViewProjectionMatrix));
+
+	if (m_VertexBufferLayout.format == VertexFormat::Quantized)
+		m_pCurrentEffect->SetPositionDequantization(m_VertexBufferLayout.positionMin, m_VertexBufferLayout.positionExtent);
+
+	const auto effectWorldMatrix{ m_pCurrentEffect->GetWorldMatrix() };
+	const auto effectCameraPosVector{ m_pCurrentEffect->GetCameraPos() };
+
+	if (effectWorldMatrix)
+		effectWorldMatrix->SetMatrix(reinterpret_cast<float*>(&m_WorldMatrix));
+
+	if (effectCameraPosVector)
+		effectCameraPosVector->SetFloatVector(reinterpret_cast<const float*>(&m_CameraPos));
+
+	// Bind Texture's SRV to GPU's resource view
+	m_pCurrentEffect->SetDiffuseMap(m_pBoundTextures[static_cast<int>(TextureSlot::Diffuse)]);
+
+	if (m_pBoundTextures[static_cast<int>(TextureSlot::Normal)])
+		m_pCurrentEffect->SetNormalMap(m_pBoundTextures[static_cast<int>(TextureSlot::Normal)]);
+
+	if (m_pBoundTextures[static_cast<int>(TextureSlot::Specular)])
+		m_pCurrentEffect->SetSpecularMap(m_pBoundTextures[static_cast<int>(TextureSlot::Specular)]);
+
+	if (m_pBoundTextures[static_cast<int>(TextureSlot::Gloss)])
+		m_pCurrentEffect->SetGlossMap(m_pBoundTextures[static_cast<int>(TextureSlot::Gloss)]);
+
+	// ----- Apply Technique Pass -----
+	// Opaque technique switches passes for the cull mode, the transparency technique has a single pass
+	const int passNumber{ m_PipelineState.blendMode == BlendMode::Opaque ? static_cast<int>(m_PipelineState.cullMode) : 0 };
+
+	ID3DX11EffectTechnique* pTechnique{ m_pCurrentEffect->GetTechnique(m_VertexBufferLayout.format) };
+	if (!pTechnique)
+		return;
+
+	ID3DX11EffectPass* pass = pTechnique->GetPassByIndex(passNumber);
+	pass->Apply(0, m_pDeviceContext);
+
+	// ----- Bind Sampler AFTER Technique pass ------
+	ID3D11SamplerState* pSampler{ m_pSamplers[static_cast<int>(m_PipelineState.samplerType)] };
+	m_pDeviceContext->PSSetSamplers(0, 1, &pSampler);
+
+	// ----- DRAW -----
+	m_pDeviceContext->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void D3D11Backend::DrawMeshlets(BufferHandle meshletBuffer)
+{
+	(void)meshletBuffer;
+}
+
+void D3D11Backend::SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	m_pInstanceTransforms = pWorldMatrices;
+	m_InstanceCount = pWorldMatrices ? instanceCount : 0;
+}
+
+void D3D11Backend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex)
+{
+	instanceCount = std::min(instanceCount, m_InstanceCount);
+	for (uint32_t instance{}; instance < instanceCount; ++instance)
+	{
+		m_WorldMatrix = m_pInstanceTransforms[instance];
+		DrawIndexed(indexCount, startIndex, baseVertex);
+	}
+}
+
+void D3D11Backend::DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount)
+{
+	// Instance by instance => the world matrix changes once per instance, not once per submesh
+	instanceCount = std::min(instanceCount, m_InstanceCount);
+	for (uint32_t instance{}; instance < instanceCount; ++instance)
+	{
+		m_WorldMatrix = m_pInstanceTransforms[instance];
+		for (const Mesh::Submesh& submesh : submeshes)
+		{
+			DrawIndexed(submesh.indexCount, submesh.startIndex, submesh.baseVertex);
+		}
+	}
+}
+
+void D3D11Backend::DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount)
+{
+	(void)meshletBuffer;
+	(void)instanceCount;
+}
+
+BufferHandle D3D11Backend::CreateBuffer(const void* pData, uint32_t byteWidth, UINT bindFlags)
+{
+	D3D11_BUFFER_DESC bd{};
+	bd.Usage = D3D11_USAGE_IMMUTABLE;
+	bd.ByteWidth = byteWidth;
+	bd.BindFlags = bindFlags;
+	bd.CPUAccessFlags = 0;
+	bd.MiscFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA initData{};
+	initData.pSysMem = pData;
+
+	ID3D11Buffer* pBuffer{};
+	if (FAILED(m_pDevice->CreateBuffer(&bd, &initData, &pBuffer)))
+		return INVALID_HANDLE;
+
+	m_pBuffers.emplace_back(pBuffer);
+	m_BufferLayouts.emplace_back();
+	return static_cast<BufferHandle>(m_pBuffers.size());
+}
+
+ID3D11Buffer* D3D11Backend::GetBuffer(BufferHandle buffer) const
+{
+	return buffer != INVALID_HANDLE ? m_pBuffers[buffer - 1] : nullptr;
+}
+
+void D3D11Backend::BindInputLayout()
+{
+	const int format{ static_cast<int>(m_VertexBufferLayout.format) };
+	const bool isOpaque{ m_pCurrentEffect == m_pOpaqueEffect.get() };
+
+	m_pDeviceContext->IASetInputLayout(isOpaque ? m_pOpaqueInputLayouts[format] : m_pTransparencyInputLayouts[format]);
+}
+
+HRESULT D3D11Backend::CreateInputLayout(Effect* pEffect, VertexFormat vertexFormat, ID3D11InputLayout** ppInputLayout)
+{
+	// Vertex Layout
+	static constexpr uint32_t numElements{ 4 };
+	D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
+
+	vertexDesc[0].SemanticName = "POSITION";
+	vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	vertexDesc[1].SemanticName = "TEXCOORD";
+	vertexDesc[1].SemanticIndex = 0;
+	vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	vertexDesc[2].SemanticName = "NORMAL";
+	vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	vertexDesc[3].SemanticName = "TANGENT";
+	vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	if (vertexFormat == VertexFormat::Quantized)
+	{
+		// Decoded by VS_Quantized, see DecodeVertex in the effects
+		vertexDesc[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+		vertexDesc[0].AlignedByteOffset = offsetof(QuantizedVertex, position);
+
+		vertexDesc[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+		vertexDesc[1].AlignedByteOffset = offsetof(QuantizedVertex, UVCoordinate);
+
+		vertexDesc[2].Format = DXGI_FORMAT_R16G16_SNORM;
+		vertexDesc[2].AlignedByteOffset = offsetof(QuantizedVertex, normal);
+
+		vertexDesc[3].Format = DXGI_FORMAT_R16G16_SNORM;
+		vertexDesc[3].AlignedByteOffset = offsetof(QuantizedVertex, tangent);
+	}
+	else
+	{
+		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		vertexDesc[0].AlignedByteOffset = offsetof(VertexIn, position); // Starts from offset position OR byte 0 if using float[3]
+
+		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+		vertexDesc[1].AlignedByteOffset = offsetof(VertexIn, UVCoordinate); // Starts from offset UVCoordinate OR +3 +3 floats = 24 bytes if using float[2]
+
+		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		vertexDesc[2].AlignedByteOffset = offsetof(VertexIn, normal);
+
+		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		vertexDesc[3].AlignedByteOffset = offsetof(VertexIn, tangent);
+	}
+
+	// Input Layout
+	ID3DX11EffectTechnique* pTechnique{ pEffect->GetTechnique(vertexFormat) };
+	if (!pTechnique)
+		return E_FAIL;
+
+	D3DX11_PASS_DESC passDesc{};
+	pTechnique->GetPassByIndex(0)->GetDesc(&passDesc);
+
+	return m_pDevice->CreateInputLayout(
+		vertexDesc,
+		numElements,
+		passDesc.pIAInputSignature,
+		passDesc.IAInputSignatureSize,
+		ppInputLayout);
+}
+
+void D3D11Backend::CreateSamplerStates()
+{
+	D3D11_SAMPLER_DESC desc{};
+	desc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+	desc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+	desc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+
+	// Point
+	desc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
+	m_pDevice->CreateSamplerState(&desc, &m_pSamplers[static_cast<int>(SamplerType::Point)]);
+
+	// Linear
+	desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	m_pDevice->CreateSamplerState(&desc, &m_pSamplers[static_cast<int>(SamplerType::Linear)]);
+
+	// Anisotropic
+	desc.Filter = D3D11_FILTER_ANISOTROPIC;
+	desc.MaxAnisotropy = 16;
+	m_pDevice->CreateSamplerState(&desc, &m_pSamplers[static_cast<int>(SamplerType::Anisotropic)]);
+}
+
+HRESULT D3D11Backend::InitializeDirectX()
+{
+	// 1. ----- Create Device and Device Context -----
+	D3D_FEATURE_LEVEL featureLevel{ D3D_FEATURE_LEVEL_11_1 };
+	uint32_t createDeviceFlag{ 0 };
+#if defined(DEBUG) || defined(_DEBUG)
+	createDeviceFlag |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+	// Create DXGI Factory
+	IDXGIFactory1* pDxgiFactory{};
+	HRESULT result{ CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**> (&pDxgiFactory)) };
+	if (FAILED(result))
+		return S_FALSE;
+
+	IDXGIAdapter* adapter = nullptr;
+	IDXGIAdapter* selectedAdapter = nullptr;
+
+	for (UINT i{ 0 }; pDxgiFactory->EnumAdapters(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+	{
+		DXGI_ADAPTER_DESC desc;
+		adapter->GetDesc(&desc);
+		std::wcout << L"Adapter: " << i << L": " << desc.Description << L"\n";
+
+		if (desc.VendorId == 0x10DE) // NVIDIA vendor ID
+		{
+			selectedAdapter = adapter;
+			break;
+		}
+	}
+
+	if (selectedAdapter == nullptr)
+	{
+		std::wcout << L"No NVIDIA GPU found on machine\n";
+	}
+
+	result = D3D11CreateDevice(selectedAdapter, D3D_DRIVER_TYPE_UNKNOWN, 0, createDeviceFlag, &featureLevel,
+		1, D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
+	if (FAILED(result))
+		return S_FALSE;
+
+	// 2. ----- SWAPCHAIN ------
+	DXGI_SWAP_CHAIN_DESC swapChainDesc{};
+	swapChainDesc.BufferDesc.Width = m_Width;
+	swapChainDesc.BufferDesc.Height = m_Height;
+	swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
+	swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
+	swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; // 32 bit format
+	swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+	swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	swapChainDesc.SampleDesc.Count = 1;
+	swapChainDesc.SampleDesc.Quality = 0;
+	swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT; // Buffers will be bound to Output Merger as a render target
+	swapChainDesc.BufferCount = 1;
+	swapChainDesc.Windowed = true;
+	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+	swapChainDesc.Flags = 0;
+
+	// Get Handle from SDL
+	SDL_SysWMinfo sysWMInfo{};
+	SDL_GetVersion(&sysWMInfo.version);
+	SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
+	swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
+
+	result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
+	if (FAILED(result))
+		return S_FALSE;
+
+	// 3. ----- Depth Stencil and Depth Stencil View -----
+	// Depth Stencil
+	D3D11_TEXTURE2D_DESC depthStencilDesc{};
+	depthStencilDesc.Width = m_Width;
+	depthStencilDesc.Height = m_Height;
+	depthStencilDesc.MipLevels = 1;
+	depthStencilDesc.ArraySize = 1;
+	depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthStencilDesc.SampleDesc.Count = 1;
+	depthStencilDesc.SampleDesc.Quality = 0;
+	depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
+	depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+	depthStencilDesc.CPUAccessFlags = 0;
+	depthStencilDesc.MiscFlags = 0;
+
+	// View
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+	depthStencilViewDesc.Format = depthStencilDesc.Format;
+	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+	depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+	result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
+	if (FAILED(result))
+		return S_FALSE;
+
+	result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
+	if (FAILED(result))
+		return S_FALSE;
+
+
+	// 4. ----- Render Target and Render Target View -----
+	result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**> (&m_pRenderTargetBuffer));
+	if (FAILED(result))
+		return S_FALSE;
+
+	result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
+	if (FAILED(result))
+		return S_FALSE;
+
+	// Output Merger Stage
+	// 5. ----- Binding RenderTargertView and DepthStencilView ------
+	m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
+
+
+	// 6. ----- ViewPort ------
+	D3D11_VIEWPORT viewPort{};
+	viewPort.Width = static_cast<float> (m_Width);
+	viewPort.Height = static_cast<float> (m_Height);
+	viewPort.TopLeftX = 0.f;
+	viewPort.TopLeftY = 0.f;
+	viewPort.MinDepth = 0.f;
+	viewPort.MaxDepth = 1.f;
+	m_pDeviceContext->RSSetViewports(1, &viewPort);
+
+	return S_OK;
+}
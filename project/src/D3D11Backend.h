@@ -0,0 +1,122 @@
+#pragma once
+// SDL Headers
+#include "SDL.h"
+#include "SDL_syswm.h"
+// DirectX Headers
+#include <dxgi.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#include <d3dx11effect.h>
+
+#include <array>
+#include <vector>
+#include <memory>
+
+#include "RenderBackend.h"
+#include "OpaqueEffect.h"
+#include "TransparencyEffect.h"
+#include "D3D11Texture.h"
+
+namespace dae
+{
+	// GPU backend - owns the device, swap chain and both effects, buffers and textures live in VRAM
+	class D3D11Backend final : public RenderBackend
+	{
+	public:
+		D3D11Backend(SDL_Window* pWindow, int width, int height);
+		virtual ~D3D11Backend() override;
+
+		D3D11Backend(const D3D11Backend&) = delete;
+		D3D11Backend(D3D11Backend&&) noexcept = delete;
+		D3D11Backend& operator=(const D3D11Backend&) = delete;
+		D3D11Backend& operator=(D3D11Backend&&) noexcept = delete;
+
+		bool IsInitialized() const { return m_IsInitialized; };
+
+		virtual const char* GetName() const override { return "D3D11"; };
+
+		virtual BufferHandle CreateVertexBuffer(const std::vector<VertexIn>& vertices) override;
+		virtual BufferHandle CreateVertexBuffer(const QuantizedVertexBuffer& vertices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint16_t>& indices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint32_t>& indices) override;
+		virtual TextureHandle CreateTexture(const Texture* pTexture) override;
+		virtual BufferHandle CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat) override;
+
+		virtual void BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos) override;
+		virtual void EndFrame() override; // Presents the swap chain
+
+		virtual void SetPipelineState(const PipelineState& pipelineState) override;
+		virtual void SetVertexBuffer(BufferHandle vertexBuffer) override;
+		virtual void SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology) override;
+		virtual void SetTexture(TextureSlot slot, TextureHandle texture) override;
+		virtual void SetWorldMatrix(const Matrix& worldMatrix) override;
+		virtual void SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount) override;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawMeshlets(BufferHandle meshletBuffer) override;
+
+		// No hardware instancing yet - one DrawIndexed per instance with its world matrix
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount) override;
+		virtual void DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount) override;
+
+	private:
+		SDL_Window* m_pWindow{};
+		int m_Width{};
+		int m_Height{};
+		bool m_IsInitialized{ false };
+
+		// DIRECTX
+		HRESULT InitializeDirectX();
+		void CreateSamplerStates();
+		HRESULT CreateInputLayout(Effect* pEffect, VertexFormat vertexFormat, ID3D11InputLayout** ppInputLayout);
+
+		ID3D11Device* m_pDevice{};
+		ID3D11DeviceContext* m_pDeviceContext{};
+
+		IDXGISwapChain* m_pSwapChain{};
+
+		ID3D11Texture2D* m_pDepthStencilBuffer{};
+		ID3D11DepthStencilView* m_pDepthStencilView{};
+
+		ID3D11Texture2D* m_pRenderTargetBuffer{};
+		ID3D11RenderTargetView* m_pRenderTargetView{};
+
+		std::array<ID3D11SamplerState*, 3> m_pSamplers{}; // Indexed by SamplerType
+
+		// One effect per blend mode, one input layout per blend mode and vertex format
+		std::unique_ptr<OpaqueEffect> m_pOpaqueEffect{};
+		std::unique_ptr<TransparencyEffect> m_pTransparencyEffect{};
+		std::array<ID3D11InputLayout*, VERTEX_FORMAT_COUNT> m_pOpaqueInputLayouts{};
+		std::array<ID3D11InputLayout*, VERTEX_FORMAT_COUNT> m_pTransparencyInputLayouts{};
+
+		// How to read a buffer - vertex buffers use the vertex fields, index buffers the index format
+		struct BufferLayout
+		{
+			VertexFormat format{ VertexFormat::Float32 };
+			Vector3 positionMin{};
+			Vector3 positionExtent{};
+			IndexFormat indexFormat{ IndexFormat::UInt32 };
+		};
+
+		// Resources - handle N lives at index N - 1
+		std::vector<ID3D11Buffer*> m_pBuffers{};
+		std::vector<BufferLayout> m_BufferLayouts{};
+		std::vector<std::unique_ptr<D3D11Texture>> m_pTextures{};
+
+		// Bound state
+		Effect* m_pCurrentEffect{};
+		BufferLayout m_VertexBufferLayout{};
+		PipelineState m_PipelineState{};
+		std::array<D3D11Texture*, TEXTURE_SLOT_COUNT> m_pBoundTextures{};
+		Matrix m_WorldMatrix{};
+		const Matrix* m_pInstanceTransforms{}; // Not copied, see RenderBackend::SetInstanceTransforms
+		uint32_t m_InstanceCount{};
+		Matrix m_ViewProjMatrix{};
+		Vector3 m_CameraPos{};
+
+		BufferHandle CreateBuffer(const void* pData, uint32_t byteWidth, UINT bindFlags);
+		ID3D11Buffer* GetBuffer(BufferHandle buffer) const;
+		void BindInputLayout(); // For the current effect and vertex format
+	};
+}
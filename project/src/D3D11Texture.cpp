@@ -0,0 +1,69 @@
+#include "D3D11Texture.h"
+#include <iostream>
+
+#define SAFE_RELEASE(p) \
+if (p) {p->Release(); p = nullptr; }
+
+D3D11Texture::~D3D11Texture()
+{
+	SAFE_RELEASE(m_pSRV);
+	SAFE_RELEASE(m_pResourceTexture);
+}
+
+D3D11Texture* D3D11Texture::Create(ID3D11Device* device, const Texture* pTexture)
+{
+	if (!pTexture)
+		return nullptr;
+
+	const SDL_Surface* surface{ pTexture->GetSurface() };
+
+	D3D11Texture* newTexture{ new D3D11Texture() };
+
+	// ----- Create Texture2D -----
+	D3D11_TEXTURE2D_DESC desc{};
+	desc.Width = surface->w;
+	desc.Height = surface->h;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA initData{};
+	initData.pSysMem = surface->pixels;
+	initData.SysMemPitch = static_cast<UINT>(surface->pitch);
+	initData.SysMemSlicePitch = static_cast<UINT>(surface->h * surface->pitch);
+
+	HRESULT result{ device->CreateTexture2D(&desc, &initData, &newTexture->m_pResourceTexture) };
+	if (FAILED(result))
+	{
+		std::wcout << "Failed to create Texture2D\n";
+		delete newTexture;
+		return nullptr;
+	}
+
+	// ----- Create SRV -----
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = desc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+
+	result = device->CreateShaderResourceView(newTexture->m_pResourceTexture, &srvDesc, &newTexture->m_pSRV);
+	if (FAILED(result))
+	{
+		std::wcout << "Failed to create SRV\n";
+		delete newTexture;
+		return nullptr;
+	}
+
+	return newTexture;
+}
+
+ID3D11ShaderResourceView* D3D11Texture::GetSRV() const
+{
+	return m_pSRV;
+}
@@ -0,0 +1,30 @@
+#pragma once
+// DirectX Headers
+#include <dxgi.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#include <d3dx11effect.h>
+
+#include "Texture.h"
+
+// GPU copy of a CPU Texture (D3D11 backend only)
+class D3D11Texture final
+{
+public:
+	~D3D11Texture();
+
+	D3D11Texture(const D3D11Texture&) = delete;
+	D3D11Texture(D3D11Texture&&) noexcept = delete;
+	D3D11Texture& operator=(const D3D11Texture&) = delete;
+	D3D11Texture& operator=(D3D11Texture&&) noexcept = delete;
+
+	static D3D11Texture* Create(ID3D11Device* device, const Texture* pTexture);
+
+	ID3D11ShaderResourceView* GetSRV() const;
+
+private:
+	D3D11Texture() = default;
+
+	ID3D11Texture2D* m_pResourceTexture{};
+	ID3D11ShaderResourceView* m_pSRV{};
+};
@@ -1,13 +1,16 @@
 #include "Effect.h"
 #include <iostream>
 #include <sstream> // string stream for wstringstream
-#include "Texture.h"
+#include "D3D11Texture.h"
 
 Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetPath)
 	:m_pEffect{},
 	m_pTechnique{},
+	m_pQuantizedTechnique{},
 	m_pWorldViewProjMatrixVariable{},
-	m_pDiffuseMapVairable{}
+	m_pDiffuseMapVairable{},
+	m_pPositionMinVariable{},
+	m_pPositionExtentVariable{}
 {
 	m_pEffect = LoadEffect(pDevice, assetPath);
 	if (!m_pEffect)
@@ -23,6 +26,13 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetPath)
 		m_pTechnique = nullptr;
 	}
 
+	m_pQuantizedTechnique = m_pEffect->GetTechniqueByName("QuantizedTechnique");
+	if (!m_pQuantizedTechnique->IsValid())
+	{
+		std::wcout << L"QuantizedTechnique not valid!\n";
+		m_pQuantizedTechnique = nullptr;
+	}
+
 	m_pWorldViewProjMatrixVariable = m_pEffect->GetVariableByName("gWorldViewProj")->AsMatrix();
 	if (!m_pWorldViewProjMatrixVariable->IsValid())
 	{
@@ -36,6 +46,20 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetPath)
 		std::wcout << L"m_pDiffuseMapVariable not valid!\n";
 		m_pDiffuseMapVairable = nullptr;
 	}
+
+	m_pPositionMinVariable = m_pEffect->GetVariableByName("gPositionMin")->AsVector();
+	if (!m_pPositionMinVariable->IsValid())
+	{
+		std::wcout << L"m_pPositionMinVariable not valid!\n";
+		m_pPositionMinVariable = nullptr;
+	}
+
+	m_pPositionExtentVariable = m_pEffect->GetVariableByName("gPositionExtent")->AsVector();
+	if (!m_pPositionExtentVariable->IsValid())
+	{
+		std::wcout << L"m_pPositionExtentVariable not valid!\n";
+		m_pPositionExtentVariable = nullptr;
+	}
 }
 
 Effect::~Effect() noexcept
@@ -49,11 +73,20 @@ Effect::~Effect() noexcept
 	if (m_pTechnique)
 		m_pTechnique = nullptr; // Technique is owned by Effect, thus no need to Release
 
+	if (m_pQuantizedTechnique)
+		m_pQuantizedTechnique = nullptr;
+
 	if (m_pWorldViewProjMatrixVariable)
 		m_pWorldViewProjMatrixVariable = nullptr; // Matrix is owned by Effect --||--
 
 	if (m_pDiffuseMapVairable)
 		m_pDiffuseMapVairable = nullptr;
+
+	if (m_pPositionMinVariable)
+		m_pPositionMinVariable = nullptr;
+
+	if (m_pPositionExtentVariable)
+		m_pPositionExtentVariable = nullptr;
 }
 
 ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetPath)
@@ -119,15 +152,32 @@ ID3DX11EffectTechnique* Effect::GetTechnique() const
 	return (m_pTechnique && m_pTechnique->IsValid()) ? m_pTechnique : nullptr;
 }
 
+ID3DX11EffectTechnique* Effect::GetTechnique(dae::VertexFormat vertexFormat) const
+{
+	if (vertexFormat == dae::VertexFormat::Quantized)
+		return (m_pQuantizedTechnique && m_pQuantizedTechnique->IsValid()) ? m_pQuantizedTechnique : nullptr;
+
+	return GetTechnique();
+}
+
 ID3DX11EffectMatrixVariable* Effect::GetWorldViewProjMatrix() const
 {
 	return m_pWorldViewProjMatrixVariable;
 }
 
-void Effect::SetDiffuseMap(Texture* pDiffuseTexture) // Bind texture's SRV to Effect's SRV
+void Effect::SetDiffuseMap(D3D11Texture* pDiffuseTexture) // Bind texture's SRV to Effect's SRV
 {
 	if (m_pDiffuseMapVairable)
 	{
 		m_pDiffuseMapVairable->SetResource(pDiffuseTexture->GetSRV());
 	}
 }
+
+void Effect::SetPositionDequantization(const dae::Vector3& positionMin, const dae::Vector3& positionExtent)
+{
+	if (m_pPositionMinVariable && m_pPositionExtentVariable)
+	{
+		m_pPositionMinVariable->SetFloatVector(reinterpret_cast<const float*>(&positionMin));
+		m_pPositionExtentVariable->SetFloatVector(reinterpret_cast<const float*>(&positionExtent));
+	}
+}
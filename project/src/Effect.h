@@ -5,9 +5,11 @@
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
 
-class Texture;
+class D3D11Texture;
 #include <string>
 
+#include "VertexFormat.h"
+
 class Effect
 {
 public:
@@ -22,9 +24,11 @@ public:
 
 	virtual ID3DX11Effect* GetEffect() const;
 	virtual ID3DX11EffectTechnique* GetTechnique() const;
+	virtual ID3DX11EffectTechnique* GetTechnique(dae::VertexFormat vertexFormat) const; // Same passes, the vertex shader decodes the format
 	virtual ID3DX11EffectMatrixVariable* GetWorldViewProjMatrix() const;
+	virtual void SetPositionDequantization(const dae::Vector3& positionMin, const dae::Vector3& positionExtent); // QuantizedTechnique only
 
-	virtual void SetDiffuseMap(Texture* pDiffuseTexture);
+	virtual void SetDiffuseMap(D3D11Texture* pDiffuseTexture);
 
 	enum class EffectType
 	{
@@ -36,9 +40,9 @@ public:
 	virtual ID3DX11EffectMatrixVariable* GetWorldMatrix() const { return nullptr; };
 	virtual ID3DX11EffectVectorVariable* GetCameraPos() const { return nullptr; };
 
-	virtual void SetNormalMap(Texture* pNormalTexture) {};
-	virtual void SetSpecularMap(Texture* pSpecularTexture) {};
-	virtual void SetGlossMap(Texture* pGlossTexture) {};
+	virtual void SetNormalMap(D3D11Texture* pNormalTexture) {};
+	virtual void SetSpecularMap(D3D11Texture* pSpecularTexture) {};
+	virtual void SetGlossMap(D3D11Texture* pGlossTexture) {};
 
 	// TransparencyEffect No-op Functions
 	virtual void ApplyPipelineStates(ID3D11DeviceContext* pDevContext) {};
@@ -51,11 +55,15 @@ protected:
 	ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetPath);
 
 	ID3DX11EffectTechnique* m_pTechnique;
+	ID3DX11EffectTechnique* m_pQuantizedTechnique;
 
 	ID3DX11EffectMatrixVariable* m_pWorldViewProjMatrixVariable;
 
 	ID3DX11EffectShaderResourceVariable* m_pDiffuseMapVairable;
 
+	ID3DX11EffectVectorVariable* m_pPositionMinVariable;
+	ID3DX11EffectVectorVariable* m_pPositionExtentVariable;
+
 private:
 	
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "FrameTimeHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace dae
+{
+	void FrameTimeHistogram::Record(uint64_t value)
+	{
+		++m_Buckets[GetBucketIndex(value)];
+		++m_Count;
+		m_Sum += value;
+		m_Min = std::min(m_Min, value);
+		m_Max = std::max(m_Max, value);
+	}
+
+	void FrameTimeHistogram::Reset()
+	{
+		m_Buckets.fill(0);
+		m_Count = 0;
+		m_Sum = 0;
+		m_Min = UINT64_MAX;
+		m_Max = 0;
+	}
+
+	uint64_t FrameTimeHistogram::GetValueAtPercentile(double percentile) const
+	{
+		if (m_Count == 0)
+			return 0;
+
+		const uint64_t rank{ std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_Count)), 1, m_Count) };
+
+		uint64_t countBelow{};
+		for (int bucketIndex{}; bucketIndex < BUCKET_COUNT; ++bucketIndex)
+		{
+			countBelow += m_Buckets[bucketIndex];
+			if (countBelow >= rank)
+				return std::min(GetBucketHighestValue(bucketIndex), m_Max);
+		}
+
+		return m_Max;
+	}
+
+	int FrameTimeHistogram::GetBucketIndex(uint64_t value)
+	{
+		// Small values get a bucket each
+		if (value < SUB_BUCKET_COUNT)
+			return static_cast<int>(value);
+
+		value = std::min(value, (uint64_t{ 1 } << MAX_VALUE_BITS) - 1);
+
+		// Keep the top SUB_BUCKET_BITS bits, every doubling of the value adds SUB_BUCKET_HALF_COUNT buckets
+		const int shift{ static_cast<int>(std::bit_width(value)) - SUB_BUCKET_BITS };
+		return shift * SUB_BUCKET_HALF_COUNT + static_cast<int>(value >> shift);
+	}
+
+	uint64_t FrameTimeHistogram::GetBucketHighestValue(int bucketIndex)
+	{
+		if (bucketIndex < SUB_BUCKET_COUNT)
+			return static_cast<uint64_t>(bucketIndex);
+
+		const int shift{ bucketIndex / SUB_BUCKET_HALF_COUNT - 1 };
+		const uint64_t subBucket{ static_cast<uint64_t>(bucketIndex - shift * SUB_BUCKET_HALF_COUNT) };
+		return (subBucket << shift) + (uint64_t{ 1 } << shift) - 1;
+	}
+}
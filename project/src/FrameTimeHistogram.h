@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace dae
+{
+	// HDR style histogram of durations in ns (log buckets split into linear sub buckets, like HdrHistogram)
+	// Every recorded value is kept to within 1/128 of its size, memory and Record cost do not grow with the number of samples
+	class FrameTimeHistogram final
+	{
+	public:
+		void Record(uint64_t value);
+		void Reset();
+
+		uint64_t GetCount() const { return m_Count; };
+		uint64_t GetMin() const { return m_Count > 0 ? m_Min : 0; };
+		uint64_t GetMax() const { return m_Max; };
+		double GetMean() const { return m_Count > 0 ? static_cast<double>(m_Sum) / m_Count : 0.0; };
+
+		// Nearest rank, percentile in [0, 100] - returns the highest value of the bucket the rank falls in (clamped to the max)
+		uint64_t GetValueAtPercentile(double percentile) const;
+
+	private:
+		static constexpr int SUB_BUCKET_BITS{ 8 };
+		static constexpr int SUB_BUCKET_COUNT{ 1 << SUB_BUCKET_BITS };
+		static constexpr int SUB_BUCKET_HALF_COUNT{ SUB_BUCKET_COUNT / 2 };
+		static constexpr int MAX_VALUE_BITS{ 44 }; // ~4.9 hours in ns, longer values are clamped
+		static constexpr int BUCKET_COUNT{ (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF_COUNT };
+
+		std::array<uint64_t, BUCKET_COUNT> m_Buckets{};
+		uint64_t m_Count{};
+		uint64_t m_Sum{};
+		uint64_t m_Min{ UINT64_MAX };
+		uint64_t m_Max{};
+
+		static int GetBucketIndex(uint64_t value);
+		static uint64_t GetBucketHighestValue(int bucketIndex);
+	};
+}
@@ -11,7 +11,8 @@
 enum class RasterizerMode
 {
 	Hardware = 0,
-	Software = 1
+	Software = 1,
+	Null = 2 // Records draws without rendering (see NullBackend)
 };
 
 enum class CullMode
@@ -141,6 +142,19 @@ inline auto RemapValue(float value, float threshold = 0.95f) -> ColorRGB
 	return ColorRGB{ t, t, t };
 }
 
+// Debug color ramp, t in [0, 1] => blue, cyan, green, yellow, red
+inline ColorRGB GetHeatmapColor(float t)
+{
+	constexpr int numStops{ 5 };
+	constexpr ColorRGB stops[numStops]{ { 0.f, 0.f, 1.f }, { 0.f, 1.f, 1.f }, { 0.f, 1.f, 0.f }, { 1.f, 1.f, 0.f }, { 1.f, 0.f, 0.f } };
+
+	const float scaled{ std::max(0.f, std::min(1.f, t)) * (numStops - 1) };
+	const int stop{ std::min(static_cast<int>(scaled), numStops - 2) };
+	const float blend{ scaled - stop };
+
+	return ColorRGB::Lerp(stops[stop], stops[stop + 1], blend);
+}
+
 inline ColorRGB GetLambertColor(const ColorRGB& sampledDiffuse, float cosTheta)
 {
 	constexpr float diffuseReflectance{ 7.f };
@@ -166,6 +180,13 @@ inline ColorRGB Phong(const ColorRGB& specularColor, float reflectance, float ph
 	return reflectance * specularColor * expCosA;
 }
 
+// Weighted Blended OIT depth weight (McGuire & Bavoil 2013, eq. 10)
+inline float GetOITWeight(float alpha, float viewDepth)
+{
+	const float depthFactor{ 0.03f / (1e-5f + powf(viewDepth / 200.f, 4.f)) };
+	return alpha * std::max(1e-2f, std::min(3e3f, depthFactor));
+}
+
 inline bool IsTriangleOffScreen(const std::array<VertexOut, 3>& tri, int screenWidth, int screenHeight)
 {
 	for (const auto& v : tri)
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <limits>
 #include <cassert>
+#include <cstdint>
 
 namespace dae {
 	Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t) :
@@ -17,57 +18,6 @@ namespace dae {
 		data[3] = t;
 	}
 
-	Matrix::Matrix(const Matrix& m)
-	{
-		data[0] = m[0];
-		data[1] = m[1];
-		data[2] = m[2];
-		data[3] = m[3];
-	}
-
-	Vector3 Matrix::TransformVector(const Vector3& v) const
-	{
-		return TransformVector(v.x, v.y, v.z);
-	}
-
-	Vector3 Matrix::TransformVector(float x, float y, float z) const
-	{
-		return Vector3{
-			data[0].x * x + data[1].x * y + data[2].x * z,
-			data[0].y * x + data[1].y * y + data[2].y * z,
-			data[0].z * x + data[1].z * y + data[2].z * z
-		};
-	}
-
-	Vector3 Matrix::TransformPoint(const Vector3& p) const
-	{
-		return TransformPoint(p.x, p.y, p.z);
-	}
-
-	Vector3 Matrix::TransformPoint(float x, float y, float z) const
-	{
-		return Vector3{
-			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
-			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
-			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
-		};
-	}
-
-	Vector4 Matrix::TransformPoint(const Vector4& p) const
-	{
-		return TransformPoint(p.x, p.y, p.z, p.w);
-	}
-
-	Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
-	{
-		return Vector4{
-			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
-			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
-			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
-			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
-		};
-	}
-
 	const Matrix& Matrix::Transpose()
 	{
 		Matrix result{};
@@ -246,8 +196,8 @@ namespace dae {
 	{
 		return {
 			{1, 0, 0, 0},
-			{0, cos(pitch), -sin(pitch), 0},
-			{0, sin(pitch), cos(pitch), 0},
+			{0, std::cos(pitch), -std::sin(pitch), 0},
+			{0, std::sin(pitch), std::cos(pitch), 0},
 			{0, 0, 0, 1}
 		};
 	}
@@ -255,9 +205,9 @@ namespace dae {
 	Matrix Matrix::CreateRotationY(float yaw)
 	{
 		return {
-			{cos(yaw), 0, -sin(yaw), 0},
+			{std::cos(yaw), 0, -std::sin(yaw), 0},
 			{0, 1, 0, 0},
-			{sin(yaw), 0, cos(yaw), 0},
+			{std::sin(yaw), 0, std::cos(yaw), 0},
 			{0, 0, 0, 1}
 		};
 	}
@@ -265,8 +215,8 @@ namespace dae {
 	Matrix Matrix::CreateRotationZ(float roll)
 	{
 		return {
-			{cos(roll), sin(roll), 0, 0},
-			{-sin(roll), cos(roll), 0, 0},
+			{std::cos(roll), std::sin(roll), 0, 0},
+			{-std::sin(roll), std::cos(roll), 0, 0},
 			{0, 0, 1, 0},
 			{0, 0, 0, 1}
 		};
@@ -293,50 +243,6 @@ namespace dae {
 	}
 
 #pragma region Operator Overloads
-	Vector4& Matrix::operator[](int index)
-	{
-		assert(index <= 3 && index >= 0);
-		return data[index];
-	}
-
-	Vector4 Matrix::operator[](int index) const
-	{
-		assert(index <= 3 && index >= 0);
-		return data[index];
-	}
-
-	Matrix Matrix::operator*(const Matrix& m) const
-	{
-		Matrix result{};
-		Matrix m_transposed = Transpose(m);
-
-		for (int r{ 0 }; r < 4; ++r)
-		{
-			for (int c{ 0 }; c < 4; ++c)
-			{
-				result[r][c] = Vector4::Dot(data[r], m_transposed[c]);
-			}
-		}
-
-		return result;
-	}
-
-	const Matrix& Matrix::operator*=(const Matrix& m)
-	{
-		Matrix copy{ *this };
-		Matrix m_transposed = Transpose(m);
-
-		for (int r{ 0 }; r < 4; ++r)
-		{
-			for (int c{ 0 }; c < 4; ++c)
-			{
-				data[r][c] = Vector4::Dot(copy[r], m_transposed[c]);
-			}
-		}
-
-		return *this;
-	}
-
 	void Matrix::AsColMajArray(float out[4][4]) const
 	{
 		for (int v = 0; v < 4; ++v)
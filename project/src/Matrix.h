@@ -1,6 +1,9 @@
 #pragma once
+#include <cassert>
+
 #include "Vector3.h"
 #include "Vector4.h"
+#include "SIMD.h"
 
 namespace dae {
 	struct Matrix final
@@ -16,7 +19,7 @@ namespace dae {
 			const Vector4& yAxis,
 			const Vector4& zAxis,
 			const Vector4& t);
-		Matrix(const Matrix& m);
+		Matrix(const Matrix& m) = default;
 
 		Vector3 TransformVector(const Vector3& v) const;
 		Vector3 TransformVector(float x, float y, float z) const;
@@ -58,7 +61,7 @@ namespace dae {
 		void AsColMajArray(float out[4][4]) const;
 
 	private:
-		//Row-Major Matrix
+		//Row-Major Matrix - every row is 16-byte aligned (Vector4), so it loads as one SSE register
 		Vector4 data[4]
 		{
 			{1,0,0,0}, //xAxis
@@ -72,4 +75,110 @@ namespace dae {
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
 	};
-}
\ No newline at end of file
+
+#pragma region Inline Definitions - hot in the vertex and pixel loops
+	inline Vector3 Matrix::TransformVector(const Vector3& v) const
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	inline Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+#if defined(DAE_SIMD_SSE)
+		__m128 result{ _mm_mul_ps(data[0].Load(), _mm_set1_ps(x)) };
+		result = MultiplyAdd(data[1].Load(), _mm_set1_ps(y), result);
+		result = MultiplyAdd(data[2].Load(), _mm_set1_ps(z), result);
+		return Vector4::FromRegister(result).GetXYZ();
+#else
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z,
+			data[0].y * x + data[1].y * y + data[2].y * z,
+			data[0].z * x + data[1].z * y + data[2].z * z
+		};
+#endif
+	}
+
+	inline Vector3 Matrix::TransformPoint(const Vector3& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, 1.f).GetXYZ();
+	}
+
+	inline Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		return TransformPoint(x, y, z, 1.f).GetXYZ();
+	}
+
+	inline Vector4 Matrix::TransformPoint(const Vector4& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	// w is not read, points always get the full translation row
+	inline Vector4 Matrix::TransformPoint(float x, float y, float z, float /*w*/) const
+	{
+#if defined(DAE_SIMD_SSE)
+		__m128 result{ _mm_mul_ps(data[0].Load(), _mm_set1_ps(x)) };
+		result = MultiplyAdd(data[1].Load(), _mm_set1_ps(y), result);
+		result = MultiplyAdd(data[2].Load(), _mm_set1_ps(z), result);
+		return Vector4::FromRegister(_mm_add_ps(result, data[3].Load())); // Same order as the scalar sum
+#else
+		return Vector4{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+		};
+#endif
+	}
+
+	inline Vector4& Matrix::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	inline Vector4 Matrix::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	// Row r of the product = sum over k of this[r][k] * m[k]
+	inline Matrix Matrix::operator*(const Matrix& m) const
+	{
+		Matrix result{ *this };
+		result *= m;
+		return result;
+	}
+
+	inline const Matrix& Matrix::operator*=(const Matrix& m)
+	{
+#if defined(DAE_SIMD_SSE)
+		const __m128 m0{ m.data[0].Load() };
+		const __m128 m1{ m.data[1].Load() };
+		const __m128 m2{ m.data[2].Load() };
+		const __m128 m3{ m.data[3].Load() };
+
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4& row{ data[r] };
+			__m128 result{ _mm_mul_ps(_mm_set1_ps(row.x), m0) };
+			result = MultiplyAdd(_mm_set1_ps(row.y), m1, result);
+			result = MultiplyAdd(_mm_set1_ps(row.z), m2, result);
+			result = MultiplyAdd(_mm_set1_ps(row.w), m3, result);
+			data[r].Store(result);
+		}
+#else
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4 row{ data[r] };
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				data[r][c] = row.x * m.data[0][c] + row.y * m.data[1][c] + row.z * m.data[2][c] + row.w * m.data[3][c];
+			}
+		}
+#endif
+		return *this;
+	}
+#pragma endregion
+}
@@ -1,24 +1,17 @@
 #pragma once
-// DirectX Headers
-#include <dxgi.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#include <d3dx11effect.h>
-
 #include "Math.h" // Includes dae structs + DataStructs + important enum classes
 #include <vector>
 
-#include "Effect.h"
-#include "OpaqueEffect.h"
-#include "TransparencyEffect.h"
-
 #include "Texture.h"
 #include <string>
 #include <memory>
+#include <array>
+#include <algorithm>
+#include <iostream>
 #include "Utils.h"
-
-#define SAFE_RELEASE(p) \
-if (p) {p->Release(); p = nullptr; }
+#include "VertexFormat.h"
+#include "Meshlets.h"
+#include "MeshSimplifier.h"
 
 using namespace dae;
 
@@ -28,25 +21,26 @@ enum class PrimitiveTopology
 	TriangleStrip
 };
 
-enum class SamplerType
+enum class IndexFormat
 {
-	Point = 0,
-	Linear = 1,
-	Anisotropic = 2
+	UInt16, // Up to 65536 vertices per submesh
+	UInt32
 };
 
-template <typename EffectType>
+// CPU side of a mesh - geometry, transform and textures. Backends upload copies of it (see RenderBackend::UploadMesh)
 class Mesh final
 {
 public:
-	static_assert(
-		std::is_base_of_v<Effect, EffectType>,
-		"Mesh<EffectType>: EffectType must derive from Effect");
+	struct Submesh
+	{
+		uint32_t startIndex;
+		uint32_t indexCount;
+		int32_t baseVertex; // Added to every index of the submesh
+	};
 
-	Mesh(ID3D11Device* pDevice, const std::string& mainBodyMeshOBJ, PrimitiveTopology _primitive,
+	Mesh(const std::string& mainBodyMeshOBJ, PrimitiveTopology _primitive,
 		const std::string& diffuseTexturePath, const std::string& normalTexturePath = "", const std::string& specularTexturePath = "", const std::string& glossTexturePath = "")
-		: m_pEffect{ std::make_unique<EffectType>(pDevice) },
-		m_Vertices{},
+		: m_Vertices{},
 		m_Indices{},
 		m_CurrentTopology{ _primitive },
 		m_Position{ 0.f, 0.f, 0.f },
@@ -56,20 +50,20 @@ public:
 		m_TranslationMatrix{ Matrix::CreateTranslation(m_Position) },
 		m_RotationMatrix{ Matrix::CreateRotationY(m_RotY) },
 		m_ScaleMatrix{ Matrix::CreateScale(m_Scale) },
-		m_pDiffuseTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, diffuseTexturePath)) },
-		m_pNormalTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, normalTexturePath)) },
-		m_pSpecularTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, specularTexturePath)) },
-		m_pGlossTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, glossTexturePath)) }
+		m_pDiffuseTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(diffuseTexturePath)) },
+		m_pNormalTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(normalTexturePath)) },
+		m_pSpecularTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(specularTexturePath)) },
+		m_pGlossTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(glossTexturePath)) }
 	{
 		Utils::ParseOBJ(mainBodyMeshOBJ, m_Vertices, m_Indices);
-		m_WorldMatrix = m_ScaleMatrix * m_RotationMatrix * m_TranslationMatrix;
-		CreateLayouts(pDevice);
+		ChooseIndexFormat();
+		ComputeBounds();
+		UpdateWorldMatrix();
 	};
 
-	Mesh(ID3D11Device* pDevice, const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices, PrimitiveTopology _primitive,
+	Mesh(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices, PrimitiveTopology _primitive,
 		const std::string& diffuseTexturePath, const std::string& normalTexturePath = "", const std::string& specularTexturePath = "", const std::string& glossTexturePath = "")
-		: m_pEffect{ std::make_unique<EffectType>(pDevice) },
-		m_Vertices{ vertices },
+		: m_Vertices{ vertices },
 		m_Indices{ indices },
 		m_CurrentTopology{ _primitive },
 		m_Position{ 0.f, 0.f, 0.f },
@@ -79,121 +73,44 @@ public:
 		m_TranslationMatrix{ Matrix::CreateTranslation(m_Position) },
 		m_RotationMatrix{ Matrix::CreateRotationY(m_RotY) },
 		m_ScaleMatrix{ Matrix::CreateScale(m_Scale) },
-		m_pDiffuseTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, diffuseTexturePath)) },
-		m_pNormalTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, normalTexturePath)) },
-		m_pSpecularTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, specularTexturePath)) },
-		m_pGlossTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(pDevice, glossTexturePath)) }
+		m_pDiffuseTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(diffuseTexturePath)) },
+		m_pNormalTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(normalTexturePath)) },
+		m_pSpecularTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(specularTexturePath)) },
+		m_pGlossTexture{ std::unique_ptr<Texture>(Texture::LoadFromFile(glossTexturePath)) }
 	{
-		m_WorldMatrix = m_ScaleMatrix * m_RotationMatrix * m_TranslationMatrix;
-		CreateLayouts(pDevice);
+		ChooseIndexFormat();
+		ComputeBounds();
+		UpdateWorldMatrix();
 	};
-	~Mesh()
-	{
-		SAFE_RELEASE(m_pVertexBuffer);
-		SAFE_RELEASE(m_pIndexBuffer);
-		SAFE_RELEASE(m_pInputLayout);
-	}
+	~Mesh() = default;
 
 	Mesh(const Mesh& other) = delete;
 	Mesh(Mesh&& effect) = delete;
-    Mesh& operator=(const  Mesh&) = delete;
+	Mesh& operator=(const  Mesh&) = delete;
 	Mesh& operator=(Mesh&&) noexcept = delete;
 
-	void Render(RasterizerMode currentRasterizerMode, const Matrix& viewProjMatrix, const Vector3& cameraPos,
-		ID3D11DeviceContext* pDeviceContext, ID3D11SamplerState* currentSamplerState, CullMode currentCullMode)
-	{
-		// SHARED
-		m_WorldMatrix = m_ScaleMatrix * m_RotationMatrix * m_TranslationMatrix;
-
-		// HARDWARE
-		if (currentRasterizerMode == RasterizerMode::Hardware)
-		{
-			Matrix worldViewProjectionMatrix{ m_WorldMatrix * viewProjMatrix };
-			m_pEffect->GetWorldViewProjMatrix()->SetMatrix(reinterpret_cast<float*>(&worldViewProjectionMatrix));
-
-			// Bind Texture's SRV to GPU's resource view
-			m_pEffect->SetDiffuseMap(m_pDiffuseTexture.get());
-
-			if (m_pNormalTexture)
-				m_pEffect->SetNormalMap(m_pNormalTexture.get());
-
-			if (m_pSpecularTexture)
-				m_pEffect->SetSpecularMap(m_pSpecularTexture.get());
-
-			if (m_pGlossTexture)
-				m_pEffect->SetGlossMap(m_pGlossTexture.get());
-
-			// Set Primitive Topology
-			if (m_CurrentTopology == PrimitiveTopology::TriangleList)
-			{
-				pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			}
-			else
-			{
-				pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-			}
-
-			// Set Input Layout
-			pDeviceContext->IASetInputLayout(m_pInputLayout);
-
-			// Set Vertex Buffer
-			constexpr UINT stride{ sizeof(VertexIn) };
-			constexpr UINT offset{ 0 };
-			pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
-
-			// Set Index Buffer
-			pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
-
-			// ----- Apply Technique Pass -----
-			D3DX11_TECHNIQUE_DESC techDesc{};
-			m_pEffect->GetTechnique()->GetDesc(&techDesc);
-
-			int passNumber{};
-			if constexpr (std::is_same_v<EffectType, OpaqueEffect>)
-			{
-				passNumber = static_cast<int>(currentCullMode);
-			}
-
-			if constexpr (std::is_same_v<EffectType, TransparencyEffect>)
-			{
-				passNumber = 0;
-			}
-
-			ID3DX11EffectPass* pass = m_pEffect->GetTechnique()->GetPassByIndex(passNumber); // Technique switches passes (for cull mode)
-			pass->Apply(0, pDeviceContext);
-
-			// ----- Bind Variables AFTER Technique pass ------
-			pDeviceContext->PSSetSamplers(0, 1, &currentSamplerState);
-
-			//pDeviceContext->RSSetState(currentRasterizerState);
-
-			const auto effectWorldMatrix{ m_pEffect->GetWorldMatrix() };
-			const auto effectCameraPosVector{ m_pEffect->GetCameraPos() };
-
-			if (effectWorldMatrix)
-				effectWorldMatrix->SetMatrix(reinterpret_cast<float*>(&m_WorldMatrix));
-
-			if (effectCameraPosVector)
-				effectCameraPosVector->SetFloatVector(reinterpret_cast<const float*>(&cameraPos));
-
-			// ----- DRAW -----
-			pDeviceContext->DrawIndexed(m_NumIndices, 0, 0);
-		}
-	};
-
 	void Translate(const Vector3& offset)
 	{
 		m_Position += offset;
 		m_TranslationMatrix = Matrix::CreateTranslation(m_Position);
+		UpdateWorldMatrix();
 	};
 	void RotateY(float yaw)
 	{
 		m_RotY += yaw;
 		m_RotationMatrix = Matrix::CreateRotationY(m_RotY);
+		UpdateWorldMatrix();
+	};
+	void SetRotationY(float yaw)
+	{
+		m_RotY = yaw;
+		m_RotationMatrix = Matrix::CreateRotationY(m_RotY);
+		UpdateWorldMatrix();
 	};
 	void Scale(const Vector3& scale)
 	{
 		m_ScaleMatrix = Matrix::CreateScale(scale);
+		UpdateWorldMatrix();
 	};
 
 	// Getters
@@ -207,11 +124,39 @@ public:
 		return m_Vertices;
 	}
 
-	const std::vector<uint32_t>& GetIndices() const
+	// Only the vector matching the index format holds indices, the other one is empty
+	IndexFormat GetIndexFormat() const
+	{
+		return m_IndexFormat;
+	};
+
+	const std::vector<uint16_t>& GetIndices16() const
+	{
+		return m_Indices16;
+	}
+
+	const std::vector<uint32_t>& GetIndices32() const
 	{
 		return m_Indices;
 	}
 
+	size_t GetIndexCount() const
+	{
+		return m_IndexFormat == IndexFormat::UInt16 ? m_Indices16.size() : m_Indices.size();
+	};
+
+	// Relative to the base vertex of the submesh the index belongs to
+	uint32_t GetIndex(size_t index) const
+	{
+		return m_IndexFormat == IndexFormat::UInt16 ? m_Indices16[index] : m_Indices[index];
+	};
+
+	// One draw per submesh - a single one covering every index unless the mesh was split
+	const std::vector<Submesh>& GetSubmeshes() const
+	{
+		return m_Submeshes;
+	};
+
 	const Texture* GetDiffuseTexture() const
 	{
 		return m_pDiffuseTexture.get();
@@ -237,16 +182,109 @@ public:
 		return m_CurrentTopology;
 	};
 
+	// Layout of the vertex buffers created from this mesh, set before uploading (see UploadMesh)
+	VertexFormat GetVertexFormat() const
+	{
+		return m_VertexFormat;
+	};
+	void SetVertexFormat(VertexFormat vertexFormat)
+	{
+		m_VertexFormat = vertexFormat;
+	};
+
+	// Object space, computed at load time - splitting and meshlets only duplicate vertices, the bounds stay valid
+	const AABB& GetBoundingBox() const
+	{
+		return m_BoundingBox;
+	};
+
+	const BoundingSphere& GetBoundingSphere() const
+	{
+		return m_BoundingSphere;
+	};
+
+	// Closest triangle along the ray in object space, distance in units of direction (both windings)
+	bool Raycast(const Vector3& origin, const Vector3& direction, float& distance) const;
+
+	// Meshes with more vertices than 16-bit indices can address keep 32-bit indices, unless they are split
+	// Every submesh references at most maxSubmeshVertices (up to 65536) vertices, vertices shared across submeshes are duplicated
+	// Triangle lists only (false otherwise), call it before uploading
+	bool SplitInto16BitSubmeshes(size_t maxSubmeshVertices = MAX_16BIT_VERTICES);
+	size_t GetDuplicatedVertexCount() const // By SplitInto16BitSubmeshes
+	{
+		return m_NumDuplicatedVertices;
+	};
+
+	// Clusters for per-meshlet culling, backends that support them draw the meshlets instead of the index buffer
+	// Triangle lists only, call it before uploading (after SplitInto16BitSubmeshes)
+	void BuildMeshlets();
+	bool HasMeshlets() const
+	{
+		return !m_Meshlets.meshlets.empty();
+	};
+	const MeshletMesh& GetMeshlets() const
+	{
+		return m_Meshlets;
+	};
+
+	// Levels of detail - simplified triangle lists over the vertices of the mesh, LOD 0 is the mesh itself
+	// Every level halves the triangles of the one before, until minTriangles is reached or the error gets too large
+	// Triangle lists only, call it before uploading (after SplitInto16BitSubmeshes and BuildMeshlets, levels get meshlets when the mesh has them)
+	struct Lod
+	{
+		std::vector<uint16_t> indices16{}; // Absolute, only the vector matching the index format holds indices
+		std::vector<uint32_t> indices32{};
+		IndexFormat indexFormat{ IndexFormat::UInt32 };
+		MeshletMesh meshlets{};
+		float error{}; // Object space distance to the full detail surface, grows with every level
+		size_t triangleCount{};
+	};
+	void BuildLods(size_t maxLods = 6, size_t minTriangles = 256);
+	size_t GetLodCount() const
+	{
+		return m_Lods.size() + 1;
+	};
+	const Lod& GetLod(size_t lod) const // 1 to GetLodCount() - 1
+	{
+		return m_Lods[lod - 1];
+	};
+	float GetLodError(size_t lod) const
+	{
+		return lod == 0 ? 0.f : m_Lods[lod - 1].error;
+	};
+	size_t GetLodTriangleCount(size_t lod) const
+	{
+		return lod == 0 ? GetTriangleCount() : m_Lods[lod - 1].triangleCount;
+	};
+	size_t GetTriangleCount() const
+	{
+		return m_CurrentTopology == PrimitiveTopology::TriangleList ? GetIndexCount() / 3 : std::max<size_t>(GetIndexCount(), 2) - 2;
+	};
+
+	// Simplified copy of the mesh for the occlusion buffer, its largest triangles in the winding the rasterizers draw
+	// Three object space positions per triangle, empty for meshes that should not hide anything (transparent)
+	void BuildOccluder(size_t maxTriangles = 256);
+	const std::vector<Vector3>& GetOccluderTriangles() const
+	{
+		return m_OccluderTriangles;
+	};
+
 private:
 	// Mesh Members
-	// --- HARDWARE ---
-	const std::unique_ptr<EffectType> m_pEffect;
-
-	// --- SHARED ---
 	std::vector<VertexIn> m_Vertices;
 	std::vector<uint32_t> m_Indices;
+	std::vector<uint16_t> m_Indices16{};
+	IndexFormat m_IndexFormat{ IndexFormat::UInt32 };
+	std::vector<Submesh> m_Submeshes{};
+	size_t m_NumDuplicatedVertices{};
+	MeshletMesh m_Meshlets{};
+	std::vector<Lod> m_Lods{};
+	std::vector<Vector3> m_OccluderTriangles{};
+	AABB m_BoundingBox{};
+	BoundingSphere m_BoundingSphere{};
 
 	const PrimitiveTopology m_CurrentTopology;
+	VertexFormat m_VertexFormat{ VertexFormat::Float32 };
 
 	Vector3 m_Position;
 	float m_RotY;
@@ -262,81 +300,254 @@ private:
 	const std::unique_ptr<Texture> m_pSpecularTexture;
 	const std::unique_ptr<Texture> m_pGlossTexture;
 
-	void CreateLayouts(ID3D11Device* pDevice)
-	{
-		// Vertex Layout
-		static constexpr uint32_t numElements{ 4 };
-		D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
-
-		vertexDesc[0].SemanticName = "POSITION";
-		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[0].AlignedByteOffset = offsetof(VertexIn, position); // Starts from offset position OR byte 0 if using float[3]
-		vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[1].SemanticName = "TEXCOORD";
-		vertexDesc[1].SemanticIndex = 0;
-		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-		vertexDesc[1].AlignedByteOffset = offsetof(VertexIn, UVCoordinate); // Starts from offset UVCoordinate OR +3 +3 floats = 24 bytes if using float[2]
-		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[2].SemanticName = "NORMAL";
-		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[2].AlignedByteOffset = offsetof(VertexIn, normal);
-		vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[3].SemanticName = "TANGENT";
-		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[3].AlignedByteOffset = offsetof(VertexIn, tangent);
-		vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		// Input Layout
-		D3DX11_PASS_DESC passDesc{};
-		m_pEffect->GetTechnique()->GetPassByIndex(0)->GetDesc(&passDesc);
-
-		HRESULT result{ pDevice->CreateInputLayout(
-			vertexDesc,
-			numElements,
-			passDesc.pIAInputSignature,
-			passDesc.IAInputSignatureSize,
-			&m_pInputLayout) };
-
-		if (FAILED(result))
+	void UpdateWorldMatrix()
+	{
+		m_WorldMatrix = m_ScaleMatrix * m_RotationMatrix * m_TranslationMatrix;
+	};
+
+	// Sphere around the box center, a little larger than the tightest sphere but found in one pass
+	void ComputeBounds()
+	{
+		for (const VertexIn& vertex : m_Vertices)
+		{
+			m_BoundingBox.Grow(vertex.position);
+		}
+
+		if (m_BoundingBox.IsEmpty())
 			return;
 
-		// Vertex buffer
-		D3D11_BUFFER_DESC bd{};
-		bd.Usage = D3D11_USAGE_IMMUTABLE;
-		bd.ByteWidth = sizeof(VertexIn) * static_cast<uint32_t>(m_Vertices.size());
-		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		bd.CPUAccessFlags = 0;
-		bd.MiscFlags = 0;
+		m_BoundingSphere.center = m_BoundingBox.GetCenter();
+		float radiusSquared{};
+		for (const VertexIn& vertex : m_Vertices)
+		{
+			radiusSquared = std::max(radiusSquared, (vertex.position - m_BoundingSphere.center).SqrMagnitude());
+		}
+		m_BoundingSphere.radius = std::sqrt(radiusSquared);
+	};
 
-		D3D11_SUBRESOURCE_DATA initData{};
-		initData.pSysMem = m_Vertices.data();
+	static constexpr size_t MAX_16BIT_VERTICES{ 65536 };
 
-		result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
-		if (FAILED(result))
-			return;
+	// Every submesh with its base vertex applied, one triangle list over m_Vertices
+	std::vector<uint32_t> GetAbsoluteIndices() const
+	{
+		std::vector<uint32_t> indices{};
+		indices.reserve(GetIndexCount());
+		for (const Submesh& submesh : m_Submeshes)
+		{
+			for (uint32_t i{}; i < submesh.indexCount; ++i)
+			{
+				indices.emplace_back(GetIndex(submesh.startIndex + i) + submesh.baseVertex);
+			}
+		}
 
-		// Index Buffer
-		m_NumIndices = static_cast<uint32_t>(m_Indices.size());
+		return indices;
+	};
 
-		bd.Usage = D3D11_USAGE_IMMUTABLE;
-		bd.ByteWidth = sizeof(uint32_t) * m_NumIndices;
-		bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		bd.CPUAccessFlags = 0;
-		bd.MiscFlags = 0;
-		initData.pSysMem = m_Indices.data();
-		result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
+	// 16-bit indices whenever they can address every vertex, the 32-bit indices are released
+	void ChooseIndexFormat()
+	{
+		m_Submeshes = { Submesh{ 0, static_cast<uint32_t>(m_Indices.size()), 0 } };
 
-		if (FAILED(result))
+		if (m_Vertices.size() > MAX_16BIT_VERTICES)
 			return;
+
+		m_Indices16.assign(m_Indices.begin(), m_Indices.end());
+		m_Indices = {};
+		m_IndexFormat = IndexFormat::UInt16;
 	};
-	
+};
+
+inline bool Mesh::SplitInto16BitSubmeshes(size_t maxSubmeshVertices)
+{
+	if (m_CurrentTopology != PrimitiveTopology::TriangleList)
+		return false;
+
+	// A mesh that already fits a single 16-bit submesh stays as it is
+	maxSubmeshVertices = std::clamp<size_t>(maxSubmeshVertices, 3, MAX_16BIT_VERTICES);
+	if (m_IndexFormat == IndexFormat::UInt16 && m_Submeshes.size() == 1 && m_Vertices.size() <= maxSubmeshVertices)
+		return true;
+
+	// Absolute indices => 16 and 32-bit meshes split the same way
+	const std::vector<uint32_t> indices{ GetAbsoluteIndices() };
+
+	std::vector<VertexIn> splitVertices{};
+	std::vector<uint16_t> splitIndices{};
+	splitVertices.reserve(m_Vertices.size());
+	splitIndices.reserve(indices.size());
+
+	// Index of every source vertex inside the submesh it was last copied into
+	std::vector<uint32_t> localIndices(m_Vertices.size());
+	std::vector<uint32_t> submeshNumbers(m_Vertices.size(), UINT32_MAX);
+
+	m_Submeshes.clear();
+	Submesh submesh{ 0, 0, 0 };
+
+	const auto closeSubmesh{ [&]()
+		{
+			submesh.indexCount = static_cast<uint32_t>(splitIndices.size()) - submesh.startIndex;
+			if (submesh.indexCount > 0)
+				m_Submeshes.emplace_back(submesh);
+
+			submesh = Submesh{ static_cast<uint32_t>(splitIndices.size()), 0, static_cast<int32_t>(splitVertices.size()) };
+		} };
+
+	for (size_t i{}; i + 2 < indices.size(); i += 3)
+	{
+		// Triangles are never split - start a new submesh when the vertices this one adds do not fit anymore
+		size_t numNewVertices{};
+		for (size_t corner{}; corner < 3; ++corner)
+		{
+			if (submeshNumbers[indices[i + corner]] != m_Submeshes.size())
+				++numNewVertices;
+		}
+
+		if (splitVertices.size() - submesh.baseVertex + numNewVertices > maxSubmeshVertices)
+			closeSubmesh();
+
+		const uint32_t submeshNumber{ static_cast<uint32_t>(m_Submeshes.size()) };
+		for (size_t corner{}; corner < 3; ++corner)
+		{
+			const uint32_t vertex{ indices[i + corner] };
+			if (submeshNumbers[vertex] != submeshNumber)
+			{
+				submeshNumbers[vertex] = submeshNumber;
+				localIndices[vertex] = static_cast<uint32_t>(splitVertices.size() - submesh.baseVertex);
+				splitVertices.emplace_back(m_Vertices[vertex]);
+			}
+
+			splitIndices.emplace_back(static_cast<uint16_t>(localIndices[vertex]));
+		}
+	}
+	closeSubmesh();
+
+	m_NumDuplicatedVertices += splitVertices.size() - m_Vertices.size();
+	m_Vertices = std::move(splitVertices);
+	m_Indices16 = std::move(splitIndices);
+	m_Indices = {};
+	m_IndexFormat = IndexFormat::UInt16;
+	return true;
+}
+
+inline void Mesh::BuildMeshlets()
+{
+	if (m_CurrentTopology != PrimitiveTopology::TriangleList)
+	{
+		std::cout << "Only triangle lists can be split into meshlets\n";
+		return;
+	}
+
+	m_Meshlets = dae::BuildMeshlets(m_Vertices, GetAbsoluteIndices());
+}
+
+inline void Mesh::BuildLods(size_t maxLods, size_t minTriangles)
+{
+	if (m_CurrentTopology != PrimitiveTopology::TriangleList)
+	{
+		std::cout << "Only triangle lists can be simplified into levels of detail\n";
+		return;
+	}
+
+	// Halving targets, every level is a snapshot of the same simplification => errors grow from level to level
+	std::vector<size_t> targetIndexCounts{};
+	for (size_t triangleCount{ GetTriangleCount() / 2 }; triangleCount >= minTriangles && targetIndexCounts.size() + 1 < maxLods; triangleCount /= 2)
+	{
+		targetIndexCounts.emplace_back(triangleCount * 3);
+	}
+
+	// Past a few percent of the radius the simplifier tears features apart instead of removing detail
+	constexpr float maxRelativeError{ 0.02f };
+	std::vector<SimplifiedMesh> levels{ SimplifyMesh(m_Vertices, GetAbsoluteIndices(), targetIndexCounts, m_BoundingSphere.radius * maxRelativeError) };
+	m_Lods.clear();
+
+	for (SimplifiedMesh& level : levels)
+	{
+		// Seams and borders are locked, a level that barely shrinks is not worth a draw of its own
+		const size_t triangleCount{ level.indices.size() / 3 };
+		if (triangleCount == 0 || triangleCount * 10 > GetLodTriangleCount(m_Lods.size()) * 8)
+			continue;
+
+		Lod lod{};
+		lod.error = level.error;
+		lod.triangleCount = triangleCount;
+		if (HasMeshlets())
+			lod.meshlets = dae::BuildMeshlets(m_Vertices, level.indices);
+
+		if (m_Vertices.size() <= MAX_16BIT_VERTICES)
+		{
+			lod.indices16.assign(level.indices.begin(), level.indices.end());
+			lod.indexFormat = IndexFormat::UInt16;
+		}
+		else
+		{
+			lod.indices32 = std::move(level.indices);
+		}
+
+		m_Lods.emplace_back(std::move(lod));
+	}
+}
+
+inline void Mesh::BuildOccluder(size_t maxTriangles)
+{
+	struct OccluderTriangle
+	{
+		std::array<Vector3, 3> positions;
+		float area;
+	};
+	std::vector<OccluderTriangle> triangles{};
+
+	const bool isStrip{ m_CurrentTopology == PrimitiveTopology::TriangleStrip };
+	const size_t triangleStep{ isStrip ? size_t{ 1 } : size_t{ 3 } };
+
+	for (const Submesh& submesh : m_Submeshes)
+	{
+		for (size_t i{ submesh.startIndex }; i + 2 < size_t{ submesh.startIndex } + submesh.indexCount; i += triangleStep)
+		{
+			// Odd strip triangles are flipped by the rasterizers
+			const bool isFlipped{ isStrip && ((i - submesh.startIndex) & 1) };
+			const Vector3& v0{ m_Vertices[GetIndex(i) + submesh.baseVertex].position };
+			const Vector3& v1{ m_Vertices[GetIndex(isFlipped ? i + 2 : i + 1) + submesh.baseVertex].position };
+			const Vector3& v2{ m_Vertices[GetIndex(isFlipped ? i + 1 : i + 2) + submesh.baseVertex].position };
+
+			const float area{ Vector3::Cross(v1 - v0, v2 - v0).Magnitude() };
+			if (area > 0.f)
+				triangles.emplace_back(OccluderTriangle{ { v0, v1, v2 }, area });
+		}
+	}
+
+	// Big triangles hide the most for the fewest pixels to rasterize
+	const size_t numTriangles{ std::min(maxTriangles, triangles.size()) };
+	std::partial_sort(triangles.begin(), triangles.begin() + numTriangles, triangles.end(),
+		[](const OccluderTriangle& a, const OccluderTriangle& b) { return a.area > b.area; });
+
+	m_OccluderTriangles.clear();
+	m_OccluderTriangles.reserve(numTriangles * 3);
+	for (size_t i{}; i < numTriangles; ++i)
+	{
+		m_OccluderTriangles.insert(m_OccluderTriangles.end(), triangles[i].positions.begin(), triangles[i].positions.end());
+	}
+}
+
+inline bool Mesh::Raycast(const Vector3& origin, const Vector3& direction, float& distance) const
+{
+	const size_t triangleStep{ m_CurrentTopology == PrimitiveTopology::TriangleList ? size_t{ 3 } : size_t{ 1 } };
+	bool isHit{ false };
+
+	for (const Submesh& submesh : m_Submeshes)
+	{
+		for (size_t i{ submesh.startIndex }; i + 2 < size_t{ submesh.startIndex } + submesh.indexCount; i += triangleStep)
+		{
+			const Vector3& v0{ m_Vertices[GetIndex(i) + submesh.baseVertex].position };
+			const Vector3& v1{ m_Vertices[GetIndex(i + 1) + submesh.baseVertex].position };
+			const Vector3& v2{ m_Vertices[GetIndex(i + 2) + submesh.baseVertex].position };
+
+			float hitDistance{};
+			if (IntersectRayTriangle(origin, direction, v0, v1, v2, hitDistance) && hitDistance < distance)
+			{
+				distance = hitDistance;
+				isHit = true;
+			}
+		}
+	}
 
-	// Direct X Resources
-	ID3D11InputLayout* m_pInputLayout{};
-	ID3D11Buffer* m_pVertexBuffer{};
-	ID3D11Buffer* m_pIndexBuffer{};
-	uint32_t m_NumIndices{};
-};
\ No newline at end of file
+	return isHit;
+}
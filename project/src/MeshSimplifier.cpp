@@ -0,0 +1,494 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <map>
+#include <array>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <cmath>
+#include <cfloat>
+#include <cstddef>
+
+namespace dae
+{
+	namespace
+	{
+		// Same index for vertices whose first numBytes are bitwise identical
+		std::vector<uint32_t> WeldVertices(const std::vector<VertexIn>& vertices, size_t numBytes)
+		{
+			std::vector<uint32_t> weldedIndices(vertices.size());
+			std::unordered_map<std::string_view, uint32_t> firstOccurrences{};
+			firstOccurrences.reserve(vertices.size());
+
+			for (uint32_t i{}; i < vertices.size(); ++i)
+			{
+				const std::string_view bytes{ reinterpret_cast<const char*>(&vertices[i]), numBytes };
+				weldedIndices[i] = firstOccurrences.try_emplace(bytes, i).first->second;
+			}
+
+			return weldedIndices;
+		}
+
+		// Weighted sum of squared distances to planes, error(p) = pT A p + 2 bT p + c
+		struct Quadric
+		{
+			double a00{}, a11{}, a22{}, a01{}, a02{}, a12{};
+			double b0{}, b1{}, b2{};
+			double c{};
+			double weight{};
+
+			// Plane dot(normal, p) + distance = 0, normal has unit length
+			static Quadric FromPlane(const Vector3& normal, float distance, double weight)
+			{
+				const double x{ normal.x }, y{ normal.y }, z{ normal.z }, d{ distance };
+				return Quadric{ weight * x * x, weight * y * y, weight * z * z, weight * x * y, weight * x * z, weight * y * z,
+					weight * x * d, weight * y * d, weight * z * d, weight * d * d, weight };
+			};
+
+			Quadric& operator+=(const Quadric& other)
+			{
+				a00 += other.a00; a11 += other.a11; a22 += other.a22;
+				a01 += other.a01; a02 += other.a02; a12 += other.a12;
+				b0 += other.b0; b1 += other.b1; b2 += other.b2;
+				c += other.c;
+				weight += other.weight;
+				return *this;
+			};
+
+			// Squared distance, averaged over the planes
+			float GetError(const Vector3& p) const
+			{
+				if (weight <= 0.0)
+					return 0.f;
+
+				const double x{ p.x }, y{ p.y }, z{ p.z };
+				const double error{ a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+					+ 2.0 * (b0 * x + b1 * y + b2 * z) + c };
+				return static_cast<float>(std::abs(error) / weight);
+			};
+		};
+
+		// Which edges a position may collapse along
+		enum class VertexKind : uint8_t
+		{
+			Manifold, // Interior, every set of attributes covers a closed fan (double sided sheets have two) => any edge
+			Border,   // On an open border => only along the border
+			Seam,     // Two sets of attributes split by a seam => only along the seam
+			Locked    // Corners, seam ends, non manifold edges
+		};
+
+		constexpr size_t PASS_REDUCTION{ 8 }; // A pass removes at most 1 / PASS_REDUCTION of the triangles
+		constexpr float BORDER_WEIGHT{ 10.f }; // Open borders are the silhouette of the mesh, seams only the texture layout
+
+		// First corner at the smallest position => the same key for every rotation of a triangle
+		std::array<uint32_t, 3> GetTriangleKey(uint32_t p0, uint32_t p1, uint32_t p2)
+		{
+			if (p1 < p0 && p1 < p2)
+				return { p1, p2, p0 };
+			if (p2 < p0 && p2 < p1)
+				return { p2, p0, p1 };
+			return { p0, p1, p2 };
+		}
+
+		struct Collapse
+		{
+			uint32_t from{}; // Positions
+			uint32_t to{};
+			float error{}; // Squared distance
+		};
+	}
+
+	std::vector<SimplifiedMesh> SimplifyMesh(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices,
+		const std::vector<size_t>& targetIndexCounts, float maxError)
+	{
+		// Every position is identified by its first vertex, the others are wedges with their own attributes
+		// Tangents are per face in OBJ files, corners that only differ in them are the same wedge
+		static_assert(offsetof(VertexIn, position) == 0 && offsetof(VertexIn, tangent) == sizeof(Vector3) * 2 + sizeof(Vector2),
+			"Welding compares the leading bytes");
+		const std::vector<uint32_t> positionIds{ WeldVertices(vertices, sizeof(Vector3)) };
+		const std::vector<uint32_t> wedgeIds{ WeldVertices(vertices, offsetof(VertexIn, tangent)) };
+		const auto getPosition{ [&](uint32_t position) -> const Vector3& { return vertices[position].position; } };
+
+		SimplifiedMesh current{}; // State of the run, copied into every level
+		current.indices.reserve(indices.size());
+		for (size_t i{}; i + 2 < indices.size(); i += 3)
+		{
+			const uint32_t p0{ positionIds[indices[i]] }, p1{ positionIds[indices[i + 1]] }, p2{ positionIds[indices[i + 2]] };
+			if (p0 != p1 && p1 != p2 && p0 != p2)
+			{
+				for (size_t corner{}; corner < 3; ++corner)
+				{
+					current.indices.emplace_back(wedgeIds[indices[i + corner]]);
+				}
+			}
+		}
+
+		// Double sided surfaces repeat every triangle with the opposite winding (all of vehicle.obj), front and back would look
+		// like two layers glued together at every edge => only the fronts are simplified, every level mirrors them again
+		std::vector<uint32_t> backWedges(vertices.size(), UINT32_MAX); // Wedge of the back triangle per front wedge
+		std::vector<uint8_t> isDoubleSided(vertices.size()); // Per position
+		size_t numBackTriangles{};
+		{
+			std::map<std::array<uint32_t, 3>, std::vector<uint32_t>> unpairedFronts{}; // Start index in frontIndices
+			std::vector<uint32_t> frontIndices{};
+			frontIndices.reserve(current.indices.size());
+
+			for (size_t i{}; i < current.indices.size(); i += 3)
+			{
+				const uint32_t* pCorners{ current.indices.data() + i };
+				const std::array<uint32_t, 3> positions{ positionIds[pCorners[0]], positionIds[pCorners[1]], positionIds[pCorners[2]] };
+
+				const auto pFronts{ unpairedFronts.find(GetTriangleKey(positions[0], positions[2], positions[1])) };
+				if (pFronts == unpairedFronts.end() || pFronts->second.empty())
+				{
+					unpairedFronts[GetTriangleKey(positions[0], positions[1], positions[2])].emplace_back(static_cast<uint32_t>(frontIndices.size()));
+					frontIndices.insert(frontIndices.end(), pCorners, pCorners + 3);
+					continue;
+				}
+
+				const uint32_t* pFrontCorners{ frontIndices.data() + pFronts->second.back() };
+				pFronts->second.pop_back();
+				for (size_t corner{}; corner < 3; ++corner)
+				{
+					const uint32_t frontWedge{ *std::find_if(pFrontCorners, pFrontCorners + 3, [&](uint32_t wedge) { return positionIds[wedge] == positions[corner]; }) };
+					if (backWedges[frontWedge] == UINT32_MAX)
+						backWedges[frontWedge] = pCorners[corner];
+					isDoubleSided[positions[corner]] = 1;
+				}
+				++numBackTriangles;
+			}
+
+			current.indices = std::move(frontIndices);
+		}
+
+		// Targets count both sides
+		const size_t numFrontTriangles{ current.indices.size() / 3 };
+		const auto getFrontTarget{ [&](size_t targetIndexCount) { return targetIndexCount / 3 * numFrontTriangles / std::max<size_t>(1, numFrontTriangles + numBackTriangles); } };
+		const auto mirrorBackTriangles{ [&](SimplifiedMesh level)
+			{
+				const auto getBackWedge{ [&](uint32_t wedge) { return backWedges[wedge] != UINT32_MAX ? backWedges[wedge] : wedge; } };
+				const size_t numFrontIndices{ level.indices.size() };
+				for (size_t i{}; i < numFrontIndices; i += 3)
+				{
+					const uint32_t v0{ level.indices[i] }, v1{ level.indices[i + 1] }, v2{ level.indices[i + 2] };
+					if (isDoubleSided[positionIds[v0]] && isDoubleSided[positionIds[v1]] && isDoubleSided[positionIds[v2]])
+						level.indices.insert(level.indices.end(), { getBackWedge(v0), getBackWedge(v2), getBackWedge(v1) });
+				}
+				return level;
+			} };
+
+		// Triangles around every position of the current triangles (offsets + list)
+		std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1);
+		std::vector<uint32_t> adjacencyCursors(vertices.size());
+		std::vector<uint32_t> adjacency{};
+		const auto buildAdjacency{ [&]()
+			{
+				std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+				for (const uint32_t index : current.indices)
+				{
+					++adjacencyOffsets[positionIds[index] + 1];
+				}
+				std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+
+				adjacency.resize(current.indices.size());
+				std::copy(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1, adjacencyCursors.begin());
+				for (size_t i{}; i < current.indices.size(); ++i)
+				{
+					adjacency[adjacencyCursors[positionIds[current.indices[i]]]++] = static_cast<uint32_t>(i / 3);
+				}
+			} };
+
+		// Directed edges of the current triangles, between the positions of the vertices or between the vertices themselves
+		const auto countEdges{ [&](uint32_t from, uint32_t to, bool isPositionEdge)
+			{
+				const uint32_t fromPosition{ positionIds[from] };
+				uint32_t numEdges{};
+				for (uint32_t a{ adjacencyOffsets[fromPosition] }; a < adjacencyOffsets[fromPosition + 1]; ++a)
+				{
+					const uint32_t* pCorners{ current.indices.data() + adjacency[a] * 3 };
+					for (size_t corner{}; corner < 3; ++corner)
+					{
+						const uint32_t next{ pCorners[(corner + 1) % 3] };
+						if (isPositionEdge ? positionIds[pCorners[corner]] == fromPosition && positionIds[next] == positionIds[to]
+							: pCorners[corner] == from && next == to)
+							++numEdges;
+					}
+				}
+				return numEdges;
+			} };
+
+		// Without a twin going the other way an edge is on an open border, without a twin of the same vertices on a seam
+		const auto isBorderEdge{ [&](uint32_t from, uint32_t to) { return countEdges(to, from, true) == 0; } };
+		const auto isSeamEdge{ [&](uint32_t from, uint32_t to) { return !isBorderEdge(from, to) && countEdges(to, from, false) == 0; } };
+
+		// Triangle planes weighted by area, plus planes through border and seam edges that keep them in place
+		std::vector<Quadric> quadrics(vertices.size());
+		buildAdjacency();
+		for (size_t i{}; i < current.indices.size(); i += 3)
+		{
+			const Vector3& p0{ vertices[current.indices[i]].position };
+			const Vector3 cross{ Vector3::Cross(vertices[current.indices[i + 1]].position - p0, vertices[current.indices[i + 2]].position - p0) };
+			const float area{ cross.Magnitude() * 0.5f };
+			if (area <= 0.f)
+				continue;
+
+			const Vector3 normal{ cross / (area * 2.f) };
+			const Quadric planeQuadric{ Quadric::FromPlane(normal, -Vector3::Dot(normal, p0), area) };
+			for (size_t corner{}; corner < 3; ++corner)
+			{
+				quadrics[positionIds[current.indices[i + corner]]] += planeQuadric;
+			}
+
+			for (size_t corner{}; corner < 3; ++corner)
+			{
+				const uint32_t from{ current.indices[i + corner] };
+				const uint32_t to{ current.indices[i + (corner + 1) % 3] };
+				const bool isBorder{ isBorderEdge(from, to) };
+				if (!isBorder && !isSeamEdge(from, to))
+					continue;
+
+				const Vector3 edge{ vertices[to].position - vertices[from].position };
+				const Vector3 edgeNormal{ Vector3::Cross(edge, normal) };
+				if (edgeNormal.SqrMagnitude() <= 0.f)
+					continue;
+
+				const Vector3 edgePlaneNormal{ edgeNormal.Normalized() };
+				const float weight{ edge.SqrMagnitude() * (isBorder ? BORDER_WEIGHT : 1.f) };
+				const Quadric edgeQuadric{ Quadric::FromPlane(edgePlaneNormal, -Vector3::Dot(edgePlaneNormal, vertices[from].position), weight) };
+				quadrics[positionIds[from]] += edgeQuadric;
+				quadrics[positionIds[to]] += edgeQuadric;
+			}
+		}
+
+		const float maxErrorSquared{ maxError * maxError };
+
+		std::vector<VertexKind> kinds(vertices.size());
+		std::vector<uint8_t> wedgeCounts(vertices.size());
+		std::vector<uint8_t> borderEdgeCounts(vertices.size());
+		std::vector<uint8_t> seamEdgeCounts(vertices.size());
+		std::vector<uint8_t> nonManifoldEdgeCounts(vertices.size());
+		std::vector<uint8_t> isReferenced(vertices.size());
+		std::vector<Collapse> collapses{};
+		std::vector<uint32_t> vertexRemap(vertices.size());
+		std::vector<uint32_t> positionRemap(vertices.size());
+		std::vector<uint8_t> isLocked(vertices.size());
+		std::vector<std::pair<uint32_t, uint32_t>> wedgeTargets{};
+
+		// One run for every target, coarser levels continue where the finer ones stopped
+		std::vector<SimplifiedMesh> levels{};
+		levels.reserve(targetIndexCounts.size());
+		bool isStuck{ false };
+		for (const size_t targetIndexCount : targetIndexCounts)
+		{
+			const size_t targetTriangleCount{ getFrontTarget(targetIndexCount) };
+
+			// Passes of independent collapses, cheapest first, every position collapses at most once per pass
+			while (!isStuck && current.indices.size() / 3 > targetTriangleCount)
+			{
+				const size_t numTriangles{ current.indices.size() / 3 };
+				buildAdjacency();
+
+				// Classify the positions of the current triangles, counts saturate (anything that high is locked anyway)
+				const auto increment{ [](std::vector<uint8_t>& counts, uint32_t position) { counts[position] = static_cast<uint8_t>(std::min(counts[position] + 1, 255)); } };
+				std::fill(wedgeCounts.begin(), wedgeCounts.end(), uint8_t{});
+				std::fill(borderEdgeCounts.begin(), borderEdgeCounts.end(), uint8_t{});
+				std::fill(seamEdgeCounts.begin(), seamEdgeCounts.end(), uint8_t{});
+				std::fill(nonManifoldEdgeCounts.begin(), nonManifoldEdgeCounts.end(), uint8_t{});
+				std::fill(isReferenced.begin(), isReferenced.end(), uint8_t{});
+				for (size_t i{}; i < current.indices.size(); ++i)
+				{
+					const uint32_t from{ current.indices[i] };
+					const uint32_t to{ current.indices[i % 3 == 2 ? i - 2 : i + 1] };
+					if (!isReferenced[from])
+					{
+						isReferenced[from] = 1;
+						increment(wedgeCounts, positionIds[from]);
+					}
+
+					if (isBorderEdge(from, to))
+					{
+						increment(borderEdgeCounts, positionIds[from]);
+						increment(borderEdgeCounts, positionIds[to]);
+					}
+					else if (isSeamEdge(from, to))
+					{
+						increment(seamEdgeCounts, positionIds[from]);
+						increment(seamEdgeCounts, positionIds[to]);
+					}
+
+					// Double sided sheets that reuse the vertices of the front for the back look closed at their border
+					if (countEdges(from, to, false) > 1)
+					{
+						increment(nonManifoldEdgeCounts, positionIds[from]);
+						increment(nonManifoldEdgeCounts, positionIds[to]);
+					}
+				}
+
+				for (size_t position{}; position < vertices.size(); ++position)
+				{
+					const uint8_t numWedges{ wedgeCounts[position] };
+					const uint8_t numBorderEdges{ borderEdgeCounts[position] };
+					const uint8_t numSeamEdges{ seamEdgeCounts[position] };
+
+					if (nonManifoldEdgeCounts[position] > 0)
+						kinds[position] = VertexKind::Locked;
+					else if (numBorderEdges == 0 && numSeamEdges == 0)
+						kinds[position] = VertexKind::Manifold;
+					else if (numWedges == 1 && numBorderEdges == 2 && numSeamEdges == 0)
+						kinds[position] = VertexKind::Border;
+					else if (numWedges == 2 && numBorderEdges == 0 && numSeamEdges == 4) // Both sides of the seam pass through
+						kinds[position] = VertexKind::Seam;
+					else
+						kinds[position] = VertexKind::Locked;
+				}
+
+				// The cheaper allowed direction of every edge, interior edges are seen from both triangles => only once
+				const auto canCollapse{ [&](uint32_t from, bool isBorder, bool isSeam)
+					{
+						switch (kinds[from])
+						{
+						case VertexKind::Manifold:
+							return true;
+						case VertexKind::Border:
+							return isBorder;
+						case VertexKind::Seam:
+							return isSeam;
+						default:
+							return false;
+						}
+					} };
+
+				collapses.clear();
+				for (size_t i{}; i < current.indices.size(); ++i)
+				{
+					const uint32_t from{ current.indices[i] };
+					const uint32_t to{ current.indices[i % 3 == 2 ? i - 2 : i + 1] };
+					const uint32_t p0{ positionIds[from] };
+					const uint32_t p1{ positionIds[to] };
+					const bool isBorder{ isBorderEdge(from, to) };
+					if (p0 > p1 && !isBorder)
+						continue;
+
+					const bool isSeam{ isSeamEdge(from, to) };
+					const float error01{ canCollapse(p0, isBorder, isSeam) ? quadrics[p0].GetError(getPosition(p1)) : FLT_MAX };
+					const float error10{ canCollapse(p1, isBorder, isSeam) ? quadrics[p1].GetError(getPosition(p0)) : FLT_MAX };
+					if (error01 == FLT_MAX && error10 == FLT_MAX)
+						continue;
+
+					collapses.emplace_back(error01 <= error10 ? Collapse{ p0, p1, error01 } : Collapse{ p1, p0, error10 });
+				}
+
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+				// Small steps => the collapses of a pass never reach much past the cheapest ones, quadrics catch up in between
+				const size_t removalGoal{ std::min(numTriangles - targetTriangleCount, std::max<size_t>(1, numTriangles / PASS_REDUCTION)) };
+				size_t numRemovedTriangles{};
+				size_t numCollapses{};
+
+				std::iota(vertexRemap.begin(), vertexRemap.end(), 0u);
+				std::iota(positionRemap.begin(), positionRemap.end(), 0u);
+				std::fill(isLocked.begin(), isLocked.end(), uint8_t{});
+
+				for (const Collapse& collapse : collapses)
+				{
+					if (numRemovedTriangles >= removalGoal || collapse.error > maxErrorSquared)
+						break;
+
+					if (isLocked[collapse.from] || isLocked[collapse.to])
+						continue;
+
+					// Moving the position may not flip any of the triangles that survive the collapse
+					bool isFlipped{ false };
+					size_t numCollapsedTriangles{};
+					wedgeTargets.clear();
+					for (uint32_t a{ adjacencyOffsets[collapse.from] }; a < adjacencyOffsets[collapse.from + 1] && !isFlipped; ++a)
+					{
+						const uint32_t* pCorners{ current.indices.data() + adjacency[a] * 3 };
+						std::array<uint32_t, 3> positions{};
+						for (size_t corner{}; corner < 3; ++corner)
+						{
+							positions[corner] = positionRemap[positionIds[pCorners[corner]]];
+						}
+
+						const auto pTo{ std::find(positions.begin(), positions.end(), collapse.to) };
+						if (pTo != positions.end())
+						{
+							// Collapses away, the corner next to the moving one decides which wedge of the target a wedge becomes
+							const size_t fromCorner{ static_cast<size_t>(std::find(positions.begin(), positions.end(), collapse.from) - positions.begin()) };
+							const uint32_t wedge{ pCorners[fromCorner] };
+							const uint32_t target{ pCorners[pTo - positions.begin()] };
+							const auto pExisting{ std::find_if(wedgeTargets.begin(), wedgeTargets.end(), [&](const auto& wedgeTarget) { return wedgeTarget.first == wedge; }) };
+							if (pExisting == wedgeTargets.end())
+								wedgeTargets.emplace_back(wedge, target);
+							else if (pExisting->second != target)
+								isFlipped = true; // Ambiguous, the wedge touches both sides of a seam of the target
+							++numCollapsedTriangles;
+							continue;
+						}
+
+						if (positions[0] == positions[1] || positions[1] == positions[2] || positions[0] == positions[2])
+							continue;
+
+						const Vector3& p0{ getPosition(positions[0]) };
+						const Vector3& p1{ getPosition(positions[1]) };
+						const Vector3& p2{ getPosition(positions[2]) };
+						const Vector3 normal{ Vector3::Cross(p1 - p0, p2 - p0) };
+
+						std::array<Vector3, 3> moved{ p0, p1, p2 };
+						for (size_t corner{}; corner < 3; ++corner)
+						{
+							if (positions[corner] == collapse.from)
+								moved[corner] = getPosition(collapse.to);
+						}
+						const Vector3 movedNormal{ Vector3::Cross(moved[1] - moved[0], moved[2] - moved[0]) };
+						isFlipped = Vector3::Dot(normal, movedNormal) <= 0.f;
+					}
+
+					// Every wedge needs a wedge of the target on its side, a fan that collapses completely takes its surface with it
+					const uint32_t numAdjacentTriangles{ adjacencyOffsets[collapse.from + 1] - adjacencyOffsets[collapse.from] };
+					if (isFlipped || wedgeTargets.size() != wedgeCounts[collapse.from] || numCollapsedTriangles == numAdjacentTriangles)
+						continue;
+
+					for (const auto& [wedge, target] : wedgeTargets)
+					{
+						vertexRemap[wedge] = target;
+					}
+					positionRemap[collapse.from] = collapse.to;
+					quadrics[collapse.to] += quadrics[collapse.from];
+					isLocked[collapse.from] = 1;
+					isLocked[collapse.to] = 1;
+
+					current.error = std::max(current.error, std::sqrt(collapse.error));
+					numRemovedTriangles += numCollapsedTriangles;
+					++numCollapses;
+				}
+
+				if (numCollapses == 0)
+				{
+					isStuck = true;
+					break;
+				}
+
+				// Triangles around the collapsed edges lose a corner
+				size_t numIndices{};
+				for (size_t i{}; i < current.indices.size(); i += 3)
+				{
+					const uint32_t v0{ vertexRemap[current.indices[i]] }, v1{ vertexRemap[current.indices[i + 1]] }, v2{ vertexRemap[current.indices[i + 2]] };
+					const uint32_t p0{ positionIds[v0] }, p1{ positionIds[v1] }, p2{ positionIds[v2] };
+					if (p0 == p1 || p1 == p2 || p0 == p2)
+						continue;
+
+					current.indices[numIndices++] = v0;
+					current.indices[numIndices++] = v1;
+					current.indices[numIndices++] = v2;
+				}
+				current.indices.resize(numIndices);
+			}
+
+			levels.emplace_back(mirrorBackTriangles(current));
+		}
+
+		return levels;
+	}
+}
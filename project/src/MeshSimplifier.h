@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+
+namespace dae
+{
+	struct SimplifiedMesh
+	{
+		std::vector<uint32_t> indices{}; // Triangle list into the vertices that were simplified
+		float error{}; // Object space distance between the simplified and the original surface, largest over every collapse
+	};
+
+	// Edge collapse driven by quadric error metrics (Garland, Heckbert)
+	// Vertices never move, an edge collapses into one of its endpoints => the results index the same vertex buffer
+	// Corners that share a position but not their attributes (UV seams) only collapse along the seam, open borders only along the border
+	// One level per target index count (largest first), all of them snapshots of a single run
+	// A level stops at its target or when the next collapse would move the surface further than maxError, later levels stop there too
+	std::vector<SimplifiedMesh> SimplifyMesh(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices,
+		const std::vector<size_t>& targetIndexCounts, float maxError);
+}
@@ -0,0 +1,305 @@
+#include "Meshlets.h"
+#include "VertexStreams.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <cmath>
+#include <cstddef>
+
+namespace dae
+{
+	static_assert(MeshletMesh::VERTEX_ALIGNMENT == VertexStreams::BATCH_SIZE, "Meshlets have to start on a vertex batch");
+	static_assert(MeshletMesh::MAX_VERTICES <= 256, "Local indices are 8-bit");
+
+	namespace
+	{
+		// Same index for vertices whose first numBytes are bitwise identical
+		std::vector<uint32_t> WeldVertices(const std::vector<VertexIn>& vertices, size_t numBytes)
+		{
+			std::vector<uint32_t> weldedIndices(vertices.size());
+			std::unordered_map<std::string_view, uint32_t> firstOccurrences{};
+			firstOccurrences.reserve(vertices.size());
+
+			for (uint32_t i{}; i < vertices.size(); ++i)
+			{
+				const std::string_view bytes{ reinterpret_cast<const char*>(&vertices[i]), numBytes };
+				weldedIndices[i] = firstOccurrences.try_emplace(bytes, i).first->second;
+			}
+
+			return weldedIndices;
+		}
+
+		// Sphere around the AABB center, cone of the front face normals (same construction as meshoptimizer)
+		void ComputeMeshletBounds(const MeshletMesh& meshletMesh, Meshlet& meshlet)
+		{
+			const VertexIn* pVertices{ meshletMesh.vertices.data() + meshlet.vertexOffset };
+			const uint8_t* pTriangles{ meshletMesh.triangles.data() + meshlet.triangleOffset * 3 };
+
+			Vector3 minPosition{ pVertices[0].position };
+			Vector3 maxPosition{ pVertices[0].position };
+			for (uint32_t i{ 1 }; i < meshlet.vertexCount; ++i)
+			{
+				minPosition = Vector3::Min(minPosition, pVertices[i].position);
+				maxPosition = Vector3::Max(maxPosition, pVertices[i].position);
+			}
+
+			meshlet.bounds.center = (minPosition + maxPosition) * 0.5f;
+			meshlet.bounds.radius = 0.f;
+			for (uint32_t i{}; i < meshlet.vertexCount; ++i)
+			{
+				meshlet.bounds.radius = std::max(meshlet.bounds.radius, (pVertices[i].position - meshlet.bounds.center).Magnitude());
+			}
+
+			// Front faces wind like the software rasterizer expects them (see PassTriangleOptimizations), zero area => zero normal
+			std::vector<Vector3> normals(meshlet.triangleCount);
+			Vector3 normalSum{};
+			for (uint32_t triangle{}; triangle < meshlet.triangleCount; ++triangle)
+			{
+				const Vector3& p0{ pVertices[pTriangles[triangle * 3]].position };
+				const Vector3& p1{ pVertices[pTriangles[triangle * 3 + 1]].position };
+				const Vector3& p2{ pVertices[pTriangles[triangle * 3 + 2]].position };
+
+				const Vector3 normal{ Vector3::Cross(p1 - p0, p2 - p0) };
+				if (normal.SqrMagnitude() == 0.f)
+					continue; // Never rasterized
+
+				normals[triangle] = normal.Normalized();
+				normalSum += normals[triangle];
+			}
+
+			meshlet.coneCutoff = 1.f;
+			if (normalSum.SqrMagnitude() == 0.f)
+				return;
+			normalSum.Normalize();
+
+			float minDot{ 1.f };
+			for (const Vector3& normal : normals)
+			{
+				if (normal.SqrMagnitude() > 0.f)
+					minDot = std::min(minDot, Vector3::Dot(normalSum, normal));
+			}
+
+			// Cone wider than ~85 degrees => the test would hardly ever cull, keep it off
+			if (minDot <= 0.1f)
+				return;
+
+			// Apex behind every triangle plane, so the cone test holds for cameras close to the meshlet too
+			float maxDistance{};
+			for (uint32_t triangle{}; triangle < meshlet.triangleCount; ++triangle)
+			{
+				if (normals[triangle].SqrMagnitude() == 0.f)
+					continue;
+
+				const Vector3& p0{ pVertices[pTriangles[triangle * 3]].position };
+				const float distance{ Vector3::Dot(meshlet.bounds.center - p0, normals[triangle]) / Vector3::Dot(normalSum, normals[triangle]) };
+				maxDistance = std::max(maxDistance, distance);
+			}
+
+			meshlet.coneAxis = normalSum;
+			meshlet.coneApex = meshlet.bounds.center - normalSum * maxDistance;
+			meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+		}
+	}
+
+	MeshletMesh BuildMeshlets(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices)
+	{
+		// Identical vertices share a meshlet slot, identical positions connect triangles across UV and normal seams
+		static_assert(offsetof(VertexIn, position) == 0, "Position welding compares the leading bytes");
+		const std::vector<uint32_t> weldedIndices{ WeldVertices(vertices, sizeof(VertexIn)) };
+		const std::vector<uint32_t> positionIndices{ WeldVertices(vertices, sizeof(Vector3)) };
+		const size_t numTriangles{ indices.size() / 3 };
+
+		// Welded corners and unit normals (zero for zero area) per triangle
+		std::vector<uint32_t> corners(numTriangles * 3);
+		std::vector<Vector3> normals(numTriangles);
+		for (size_t triangle{}; triangle < numTriangles; ++triangle)
+		{
+			for (size_t corner{}; corner < 3; ++corner)
+			{
+				corners[triangle * 3 + corner] = weldedIndices[indices[triangle * 3 + corner]];
+			}
+
+			const Vector3& p0{ vertices[corners[triangle * 3]].position };
+			const Vector3 normal{ Vector3::Cross(vertices[corners[triangle * 3 + 1]].position - p0, vertices[corners[triangle * 3 + 2]].position - p0) };
+			normals[triangle] = normal.SqrMagnitude() > 0.f ? normal.Normalized() : Vector3{};
+		}
+
+		// Triangles around every position (offsets + list)
+		std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1);
+		for (size_t i{}; i < numTriangles * 3; ++i)
+		{
+			++adjacencyOffsets[positionIndices[indices[i]] + 1];
+		}
+		for (size_t vertex{}; vertex < vertices.size(); ++vertex)
+		{
+			adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+		}
+		std::vector<uint32_t> adjacentTriangles(numTriangles * 3);
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i{}; i < numTriangles * 3; ++i)
+			{
+				adjacentTriangles[fill[positionIndices[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		MeshletMesh meshletMesh{};
+		meshletMesh.triangles.reserve(indices.size());
+
+		// Local slot of every welded vertex in the open meshlet
+		constexpr uint8_t NO_SLOT{ 0xFF };
+		std::vector<uint8_t> localSlots(vertices.size(), NO_SLOT);
+		std::vector<uint32_t> meshletVertices{};
+		meshletVertices.reserve(MeshletMesh::MAX_VERTICES);
+		std::vector<uint8_t> isTriangleUsed(numTriangles, 0);
+
+		Meshlet meshlet{};
+		Vector3 meshletNormalSum{};
+
+		const auto closeMeshlet{ [&]()
+			{
+				if (meshlet.triangleCount == 0)
+					return;
+
+				meshlet.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+				for (uint32_t vertex : meshletVertices)
+				{
+					meshletMesh.vertices.emplace_back(vertices[vertex]);
+					localSlots[vertex] = NO_SLOT;
+				}
+
+				// Pad with copies of the last vertex up to the next batch, they are never transformed
+				while (meshletMesh.vertices.size() % MeshletMesh::VERTEX_ALIGNMENT != 0)
+				{
+					meshletMesh.vertices.emplace_back(meshletMesh.vertices.back());
+				}
+
+				ComputeMeshletBounds(meshletMesh, meshlet);
+				meshletMesh.meshlets.emplace_back(meshlet);
+
+				meshletVertices.clear();
+				meshletNormalSum = Vector3{};
+				meshlet = Meshlet{};
+				meshlet.vertexOffset = static_cast<uint32_t>(meshletMesh.vertices.size());
+				meshlet.triangleOffset = static_cast<uint32_t>(meshletMesh.triangles.size() / 3);
+			} };
+
+		const auto countNewVertices{ [&](size_t triangle)
+			{
+				const uint32_t* pCorners{ &corners[triangle * 3] };
+				size_t numNewVertices{ localSlots[pCorners[0]] == NO_SLOT ? 1u : 0u };
+				numNewVertices += localSlots[pCorners[1]] == NO_SLOT && pCorners[1] != pCorners[0] ? 1 : 0;
+				numNewVertices += localSlots[pCorners[2]] == NO_SLOT && pCorners[2] != pCorners[0] && pCorners[2] != pCorners[1] ? 1 : 0;
+				return numNewVertices;
+			} };
+
+		// Greedy growth: the neighbour that adds the fewest vertices and bends the normal cone the least
+		// Tight clusters => small spheres for the frustum test and narrow cones for the backface test
+		constexpr float CONE_WEIGHT{ 2.f };
+		constexpr float MIN_CONE_DOT{ 0.5f }; // 60 degrees, smaller meshlets but nearly all of them get a usable cone
+		size_t nextSeed{};
+
+		for (size_t numAdded{}; numAdded < numTriangles; ++numAdded)
+		{
+			size_t bestTriangle{ numTriangles };
+			float bestScore{ INFINITY };
+
+			const Vector3 meshletAxis{ meshletNormalSum.SqrMagnitude() > 0.f ? meshletNormalSum.Normalized() : Vector3{} };
+			for (uint32_t vertex : meshletVertices)
+			{
+				const uint32_t position{ positionIndices[vertex] };
+				for (uint32_t i{ adjacencyOffsets[position] }; i < adjacencyOffsets[position + 1]; ++i)
+				{
+					const uint32_t triangle{ adjacentTriangles[i] };
+					if (isTriangleUsed[triangle])
+						continue;
+
+					const size_t numNewVertices{ countNewVertices(triangle) };
+					if (meshletVertices.size() + numNewVertices > MeshletMesh::MAX_VERTICES)
+						continue;
+
+					// Too far from the meshlet normal => the cone would get too wide for the backface test
+					const float axisDot{ Vector3::Dot(meshletAxis, normals[triangle]) };
+					if (axisDot < MIN_CONE_DOT && normals[triangle].SqrMagnitude() > 0.f)
+						continue;
+
+					const float score{ numNewVertices + CONE_WEIGHT * (1.f - axisDot) };
+					if (score < bestScore)
+					{
+						bestScore = score;
+						bestTriangle = triangle;
+					}
+				}
+			}
+
+			// Nothing connected fits anymore => start a new meshlet at the first unused triangle
+			if (bestTriangle == numTriangles)
+			{
+				closeMeshlet();
+
+				while (isTriangleUsed[nextSeed])
+				{
+					++nextSeed;
+				}
+				bestTriangle = nextSeed;
+			}
+
+			isTriangleUsed[bestTriangle] = 1;
+			meshletNormalSum += normals[bestTriangle];
+
+			for (size_t corner{}; corner < 3; ++corner)
+			{
+				const uint32_t vertex{ corners[bestTriangle * 3 + corner] };
+				if (localSlots[vertex] == NO_SLOT)
+				{
+					localSlots[vertex] = static_cast<uint8_t>(meshletVertices.size());
+					meshletVertices.emplace_back(vertex);
+				}
+
+				meshletMesh.triangles.emplace_back(localSlots[vertex]);
+			}
+			++meshlet.triangleCount;
+
+			if (meshlet.triangleCount == MeshletMesh::MAX_TRIANGLES || meshletVertices.size() == MeshletMesh::MAX_VERTICES)
+				closeMeshlet();
+		}
+		closeMeshlet();
+
+		return meshletMesh;
+	}
+
+	MeshletCuller::MeshletCuller(const Matrix& worldMatrix, const Frustum& worldFrustum, const Vector3& cameraOrigin, bool isBackfaceCullingEnabled) :
+		m_WorldMatrix{ worldMatrix },
+		m_Frustum{ worldFrustum }
+	{
+		const float scaleX{ worldMatrix.GetAxisX().Magnitude() };
+		const float scaleY{ worldMatrix.GetAxisY().Magnitude() };
+		const float scaleZ{ worldMatrix.GetAxisZ().Magnitude() };
+		m_RadiusScale = std::max(scaleX, std::max(scaleY, scaleZ));
+
+		// Angles only survive a uniform scale
+		const float minScale{ std::min(scaleX, std::min(scaleY, scaleZ)) };
+		m_IsConeTestEnabled = isBackfaceCullingEnabled && minScale > 0.f && m_RadiusScale - minScale <= m_RadiusScale * 1e-3f;
+
+		if (m_IsConeTestEnabled)
+		{
+			m_ObjectCameraOrigin = Matrix::Inverse(worldMatrix).TransformPoint(cameraOrigin);
+		}
+	}
+
+	MeshletVisibility MeshletCuller::Classify(const Meshlet& meshlet) const
+	{
+		if (m_Frustum.IsSphereOutside(m_WorldMatrix.TransformPoint(meshlet.bounds.center), meshlet.bounds.radius * m_RadiusScale))
+			return MeshletVisibility::OutsideFrustum;
+
+		if (m_IsConeTestEnabled && meshlet.coneCutoff < 1.f)
+		{
+			const Vector3 apexDirection{ meshlet.coneApex - m_ObjectCameraOrigin };
+			if (Vector3::Dot(apexDirection, meshlet.coneAxis) >= meshlet.coneCutoff * apexDirection.Magnitude())
+				return MeshletVisibility::Backfacing;
+		}
+
+		return MeshletVisibility::Visible;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "BoundingVolumes.h"
+
+namespace dae
+{
+	// Cluster of a triangle list - culled as a whole before any of its vertices are transformed
+	struct Meshlet
+	{
+		uint32_t vertexOffset{}; // Into MeshletMesh::vertices, a multiple of MeshletMesh::VERTEX_ALIGNMENT
+		uint32_t vertexCount{};
+		uint32_t triangleOffset{}; // Into MeshletMesh::triangles, in triangles
+		uint32_t triangleCount{};
+
+		// Object space
+		BoundingSphere bounds{};
+		Vector3 coneApex{};
+		Vector3 coneAxis{}; // Average front face normal
+		float coneCutoff{ 1.f }; // Every triangle faces away when dot(normalize(coneApex - camera), coneAxis) >= coneCutoff, 1 never culls
+	};
+
+	// Mesh shader sized clusters (64 vertices, 124 triangles) with their own copy of the vertices
+	struct MeshletMesh
+	{
+		static constexpr uint32_t MAX_VERTICES{ 64 };
+		static constexpr uint32_t MAX_TRIANGLES{ 124 };
+		static constexpr uint32_t VERTEX_ALIGNMENT{ 8 }; // VertexStreams::BATCH_SIZE => every meshlet starts a new vertex batch
+
+		std::vector<Meshlet> meshlets{};
+		std::vector<VertexIn> vertices{}; // Meshlet order, vertices shared by meshlets are duplicated, padded per meshlet
+		std::vector<uint8_t> triangles{}; // 3 meshlet local vertex indices per triangle
+
+		size_t GetTriangleCount() const { return triangles.size() / 3; };
+	};
+
+	// Triangle list with absolute indices. Meshlets grow over shared vertices and prefer triangles facing the same way
+	// Identical vertices are welded first, so OBJ corners that were never shared still share meshlet slots
+	MeshletMesh BuildMeshlets(const std::vector<VertexIn>& vertices, const std::vector<uint32_t>& indices);
+
+	enum class MeshletVisibility
+	{
+		Visible,
+		OutsideFrustum,
+		Backfacing
+	};
+
+	// Per draw - bounds go to world space for the frustum test, the camera goes to object space once for the cone test
+	class MeshletCuller final
+	{
+	public:
+		// The world matrix may not mirror, a non uniform scale disables the cone test
+		MeshletCuller(const Matrix& worldMatrix, const Frustum& worldFrustum, const Vector3& cameraOrigin, bool isBackfaceCullingEnabled);
+
+		MeshletVisibility Classify(const Meshlet& meshlet) const;
+
+	private:
+		Matrix m_WorldMatrix;
+		const Frustum& m_Frustum;
+		float m_RadiusScale{};
+		Vector3 m_ObjectCameraOrigin{};
+		bool m_IsConeTestEnabled{};
+	};
+}
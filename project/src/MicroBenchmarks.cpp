@@ -0,0 +1,432 @@
+// Microbenchmarks of the math and sampling kernels - no window, no renderer, fixed data sets
+// Usage: DualRasterizerMicroBenchmarks [--filter <substring>] [--repetitions <count>]
+
+//External includes
+#include "SDL.h"
+#undef main
+
+//Standard includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+//Project includes
+#include "Math.h"
+#include "Texture.h"
+#include "Utils.h"
+#include "VertexStreams.h"
+#include "BVH.h"
+#include "OcclusionBuffer.h"
+
+using namespace dae;
+
+namespace
+{
+	// Every kernel folds its results in here, so the compiler cannot drop the work
+	volatile float g_Sink{};
+
+	constexpr size_t DATA_SET_SIZE{ 4096 };
+	constexpr uint32_t DATA_SET_SEED{ 2024 };
+
+	struct MicroBenchmarkResult
+	{
+		std::string name{};
+		uint64_t numOps{}; // Per repetition
+		double minTime{}; // ns per op, fastest repetition
+		double medianTime{}; // ns per op
+	};
+
+	// Runs function (which does numOps operations) once to warm up, then numRepetitions times
+	template <typename Function>
+	MicroBenchmarkResult RunMicroBenchmark(const std::string& name, uint64_t numOps, int numRepetitions, Function&& function)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		g_Sink = g_Sink + function();
+
+		std::vector<double> times{};
+		times.reserve(numRepetitions);
+		for (int repetition{}; repetition < numRepetitions; ++repetition)
+		{
+			const auto start{ Clock::now() };
+			const float checksum{ function() };
+			const auto end{ Clock::now() };
+
+			g_Sink = g_Sink + checksum;
+			times.emplace_back(std::chrono::duration<double, std::nano>{ end - start }.count() / numOps);
+		}
+
+		std::sort(times.begin(), times.end());
+		return MicroBenchmarkResult{ name, numOps, times.front(), times[times.size() / 2] };
+	}
+
+	void PrintMicroBenchmarkResult(const MicroBenchmarkResult& result)
+	{
+		std::cout << std::left << std::setw(28) << result.name << std::right
+			<< std::setw(12) << result.numOps
+			<< std::setw(14) << std::fixed << std::setprecision(2) << result.minTime
+			<< std::setw(14) << result.medianTime
+			<< std::setw(16) << std::defaultfloat << std::setprecision(4) << 1e9 / result.minTime << '\n';
+	}
+
+	// --- DATA SETS --- (same seed => same data on every run)
+	struct DataSets
+	{
+		std::vector<Matrix> matrices{};
+		std::vector<Vector3> vectors{};
+		std::vector<Vector4> points{};
+
+		// Screen triangles with their pixels, roughly half of the pixels are inside
+		std::vector<std::array<VertexOut, 3>> triangles{};
+		std::vector<VertexIn> pixels{};
+
+		// Only pixels inside their triangle, with the area ratios of the edge test
+		std::vector<std::array<VertexOut, 3>> coveredTriangles{};
+		std::vector<VertexIn> coveredPixels{};
+		std::vector<std::array<float, 3>> coveredAreaRatios{};
+
+		std::vector<Vector2> uvs{};
+	};
+
+	DataSets CreateDataSets()
+	{
+		std::mt19937 generator{ DATA_SET_SEED };
+		std::uniform_real_distribution<float> unit{ -1.f, 1.f };
+		std::uniform_real_distribution<float> screen{ 0.f, 64.f };
+		std::uniform_real_distribution<float> depth{ 0.9f, 0.999f };
+		std::uniform_real_distribution<float> invW{ 0.01f, 0.1f };
+		std::uniform_real_distribution<float> uv{ 0.f, 1.f };
+
+		const auto randomVector{ [&]() { return Vector3{ unit(generator), unit(generator), unit(generator) }; } };
+
+		DataSets dataSets{};
+
+		for (size_t i{}; i < DATA_SET_SIZE; ++i)
+		{
+			dataSets.matrices.emplace_back(Matrix::CreateRotation(randomVector() * PI) * Matrix::CreateTranslation(randomVector() * 10.f));
+			dataSets.vectors.emplace_back(randomVector() * 10.f);
+			dataSets.points.emplace_back(Vector4{ randomVector() * 10.f, 1.f });
+			dataSets.uvs.emplace_back(Vector2{ uv(generator), uv(generator) });
+		}
+
+		while (dataSets.triangles.size() < DATA_SET_SIZE)
+		{
+			std::array<VertexOut, 3> triangle{};
+			for (VertexOut& vertex : triangle)
+			{
+				vertex = VertexOut{ Vector4{ screen(generator), screen(generator), depth(generator), invW(generator) },
+					Vector2{ uv(generator), uv(generator) }, randomVector().Normalized(), randomVector().Normalized(), randomVector() };
+			}
+
+			// The edge test only accepts one winding (see SoftwareRasterizer::PassTriangleOptimizations)
+			const Vector2 v0{ triangle[0].position.x, triangle[0].position.y };
+			const float signedArea{ Vector2::Cross(Vector2{ triangle[1].position.x, triangle[1].position.y } - v0,
+				Vector2{ triangle[2].position.x, triangle[2].position.y } - v0) };
+			if (signedArea < 1.f)
+				continue;
+
+			VertexIn pixel{ Vector3{ screen(generator), screen(generator), 1.f } };
+			dataSets.triangles.emplace_back(triangle);
+			dataSets.pixels.emplace_back(pixel);
+
+			std::array<float, 3> areaRatios{};
+			if (IsPixelIn_Triangle(triangle, pixel, areaRatios))
+			{
+				dataSets.coveredTriangles.emplace_back(triangle);
+				dataSets.coveredPixels.emplace_back(pixel);
+				dataSets.coveredAreaRatios.emplace_back(areaRatios);
+			}
+		}
+
+		return dataSets;
+	}
+}
+
+int main(int argc, char* args[])
+{
+	std::string filter{};
+	int numRepetitions{ 7 };
+
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ args[i] };
+		const bool hasValue{ i + 1 < argc };
+
+		if (argument == "--filter" && hasValue)
+			filter = args[++i];
+		else if (argument == "--repetitions" && hasValue)
+			numRepetitions = std::max(1, std::stoi(args[++i]));
+		else
+			std::cout << "Unknown argument: " << argument << '\n';
+	}
+
+	// No video subsystem, only what IMG_Load needs
+	SDL_Init(0);
+
+	const DataSets dataSets{ CreateDataSets() };
+
+	const std::unique_ptr<Texture> pTexture{ Texture::LoadFromFile("resources/vehicle_diffuse.png") };
+	const std::string objPath{ "resources/vehicle.obj" };
+
+	const auto run{ [&](const std::string& name, uint64_t numOps, auto&& function)
+		{
+			if (!filter.empty() && name.find(filter) == std::string::npos)
+				return;
+
+			PrintMicroBenchmarkResult(RunMicroBenchmark(name, numOps, numRepetitions, function));
+		} };
+
+	// Fixed passes over the data sets => the same number of ops on every run and machine
+	constexpr int numPasses{ 256 };
+	const uint64_t numDataSetOps{ DATA_SET_SIZE * numPasses };
+
+	std::cout << std::left << std::setw(28) << "kernel" << std::right << std::setw(12) << "ops" << std::setw(14) << "min ns/op"
+		<< std::setw(14) << "median ns/op" << std::setw(16) << "ops/s (min)" << '\n';
+
+	run("Matrix::operator*", numDataSetOps, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				for (size_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					const Matrix product{ dataSets.matrices[i] * dataSets.matrices[(i + 1) % DATA_SET_SIZE] };
+					checksum += product[3].x;
+				}
+			}
+			return checksum;
+		});
+
+	run("Matrix::TransformPoint", numDataSetOps, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				const Matrix& matrix{ dataSets.matrices[pass] };
+				for (size_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					checksum += matrix.TransformPoint(dataSets.points[i]).w;
+				}
+			}
+			return checksum;
+		});
+
+	// Whole vertex stage of the software rasterizer, ops = vertices
+	std::vector<VertexIn> streamVertices{};
+	for (size_t i{}; i < DATA_SET_SIZE; ++i)
+	{
+		streamVertices.emplace_back(VertexIn{ dataSets.points[i].GetXYZ(), dataSets.uvs[i], dataSets.vectors[i].Normalized(),
+			dataSets.vectors[(i + 1) % DATA_SET_SIZE].Normalized() });
+	}
+	const VertexStreams vertexStreams{ VertexStreams::FromVertices(streamVertices) };
+	const VertexStreams quantizedStreams{ VertexStreams::FromVertices(QuantizeVertices(streamVertices)) };
+	std::vector<VertexOut> transformedVertices(DATA_SET_SIZE);
+
+	const auto transformStreams{ [&](const VertexStreams& streams)
+		{
+			const Matrix projection{ Matrix::CreatePerspectiveFovLH(1.f, 4.f / 3.f, 0.1f, 100.f) };
+
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				const Matrix& world{ dataSets.matrices[pass] };
+				const VertexTransformConstants constants{ world * Matrix::CreateTranslation(0.f, 0.f, 30.f) * projection, world,
+					Vector3{ 0.f, 0.f, -30.f }, 640.f, 480.f };
+
+				TransformVertexStreams(streams, 0, DATA_SET_SIZE, constants, transformedVertices.data());
+				checksum += transformedVertices[pass].position.w;
+			}
+			return checksum;
+		} };
+
+	run("TransformVertexStreams", numDataSetOps, [&]() { return transformStreams(vertexStreams); });
+	run("TransformQuantizedStreams", numDataSetOps, [&]() { return transformStreams(quantizedStreams); });
+
+	run("Vector3::Normalized", numDataSetOps, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				for (size_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					checksum += dataSets.vectors[i].Normalized().x;
+				}
+			}
+			return checksum;
+		});
+
+	run("IsPixelIn_Triangle", numDataSetOps, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				for (size_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					VertexIn pixel{ dataSets.pixels[i] };
+					std::array<float, 3> areaRatios{};
+					if (IsPixelIn_Triangle(dataSets.triangles[i], pixel, areaRatios))
+						checksum += pixel.position.z;
+				}
+			}
+			return checksum;
+		});
+
+	const uint64_t numCovered{ dataSets.coveredPixels.size() };
+	run("InterpolateVertex", numCovered * numPasses, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				for (size_t i{}; i < numCovered; ++i)
+				{
+					VertexIn pixel{ dataSets.coveredPixels[i] };
+					InterpolateVertex(dataSets.coveredAreaRatios[i], dataSets.coveredTriangles[i], pixel);
+					checksum += pixel.UVCoordinate.x;
+				}
+			}
+			return checksum;
+		});
+
+	if (pTexture)
+	{
+		run("Texture::Sample", numDataSetOps, [&]()
+			{
+				float checksum{};
+				for (int pass{}; pass < numPasses; ++pass)
+				{
+					for (size_t i{}; i < DATA_SET_SIZE; ++i)
+					{
+						checksum += pTexture->Sample(dataSets.uvs[i]).r;
+					}
+				}
+				return checksum;
+			});
+	}
+	else
+		std::cout << "Texture::Sample skipped, resources/vehicle_diffuse.png not found\n";
+
+	run("Phong", numDataSetOps, [&]()
+		{
+			const Vector3 lightDirection{ Vector3{ 0.577f, -0.577f, 0.577f }.Normalized() };
+
+			float checksum{};
+			for (int pass{}; pass < numPasses; ++pass)
+			{
+				for (size_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					const VertexOut& vertex{ dataSets.triangles[i][0] };
+					checksum += Phong(ColorRGB{ 0.5f, 0.5f, 0.5f }, 0.5f, 25.f * vertex.UVCoordinate.x, lightDirection,
+						vertex.tangent, vertex.normal).r;
+				}
+			}
+			return checksum;
+		});
+
+	// Every data set matrix is an object of a scene BVH, they all move a little between refits - ops = objects
+	const AABB unitBox{ Vector3{ -1.f, -1.f, -1.f }, Vector3{ 1.f, 1.f, 1.f } };
+	std::vector<AABB> objectBoxes{};
+	BVH bvh{};
+	for (uint32_t i{}; i < DATA_SET_SIZE; ++i)
+	{
+		objectBoxes.emplace_back(unitBox.Transformed(dataSets.matrices[i]));
+		bvh.Insert(i, objectBoxes[i]);
+	}
+	bvh.Refit();
+
+	constexpr int numRefits{ 64 };
+	run("BVH::Refit", DATA_SET_SIZE * numRefits, [&]()
+		{
+			for (int refit{}; refit < numRefits; ++refit)
+			{
+				for (uint32_t i{}; i < DATA_SET_SIZE; ++i)
+				{
+					const Vector3 offset{ dataSets.vectors[(i + refit) % DATA_SET_SIZE] * 0.01f };
+					bvh.SetBox(i, AABB{ objectBoxes[i].min + offset, objectBoxes[i].max + offset });
+				}
+				bvh.Refit();
+			}
+			return bvh.GetBounds().max.x;
+		});
+
+	run("BVH::Query (frustum)", DATA_SET_SIZE * numRefits, [&]()
+		{
+			const Matrix viewProjMatrix{ Matrix::CreateLookAtLH(Vector3{ 0.f, 0.f, -30.f }, Vector3::UnitZ, Vector3::UnitY)
+				* Matrix::CreatePerspectiveFovLH(0.4f, 4.f / 3.f, 0.1f, 100.f) };
+			const Frustum frustum{ Frustum::FromViewProjection(viewProjMatrix) };
+
+			float checksum{};
+			for (int query{}; query < numRefits; ++query)
+			{
+				bvh.Query(Vector3{ 0.f, 0.f, -30.f }, [&](const AABB& box) { return frustum.Classify(box); },
+					[&](BVH::ObjectId object, bool) { checksum += static_cast<float>(object); });
+			}
+			return checksum;
+		});
+
+	// Data set vectors as triangles in front of the camera, both windings => half of them are rasterized - ops = triangles
+	const Matrix occlusionViewProjMatrix{ Matrix::CreateLookAtLH(Vector3{ 0.f, 0.f, -30.f }, Vector3::UnitZ, Vector3::UnitY)
+		* Matrix::CreatePerspectiveFovLH(0.4f, 4.f / 3.f, 0.1f, 100.f) };
+	std::vector<Vector3> occluderTriangles{};
+	for (size_t i{}; i + 2 < DATA_SET_SIZE; i += 3)
+	{
+		for (size_t corner{}; corner < 3; ++corner)
+		{
+			occluderTriangles.emplace_back(dataSets.vectors[i + corner]);
+		}
+	}
+
+	OcclusionBuffer occlusionBuffer{ 1280, 720 };
+	constexpr int numOccluderPasses{ 16 };
+	run("OcclusionBuffer::Render", occluderTriangles.size() / 3 * numOccluderPasses, [&]()
+		{
+			for (int pass{}; pass < numOccluderPasses; ++pass)
+			{
+				occlusionBuffer.Clear(occlusionViewProjMatrix);
+				occlusionBuffer.RenderOccluder(occluderTriangles, Matrix{});
+			}
+			return static_cast<float>(occlusionBuffer.GetOccluderTriangleCount());
+		});
+
+	run("OcclusionBuffer::IsBoxVisible", DATA_SET_SIZE * numOccluderPasses, [&]()
+		{
+			float checksum{};
+			for (int pass{}; pass < numOccluderPasses; ++pass)
+			{
+				for (const AABB& box : objectBoxes)
+				{
+					checksum += occlusionBuffer.IsBoxVisible(box) ? 1.f : 0.f;
+				}
+			}
+			return checksum;
+		});
+
+	std::vector<VertexIn> objVertices{};
+	std::vector<uint32_t> objIndices{};
+	if (Utils::ParseOBJ(objPath, objVertices, objIndices))
+	{
+		constexpr int numParses{ 4 };
+		run("ParseOBJ (vehicle.obj)", numParses, [&]()
+			{
+				float checksum{};
+				for (int parse{}; parse < numParses; ++parse)
+				{
+					Utils::ParseOBJ(objPath, objVertices, objIndices);
+					checksum += static_cast<float>(objIndices.size());
+				}
+				return checksum;
+			});
+	}
+	else
+		std::cout << "ParseOBJ skipped, " << objPath << " not found\n";
+
+	std::cout << "checksum " << g_Sink << '\n';
+
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,177 @@
+#include "NullBackend.h"
+#include <iostream>
+#include <cstring>
+
+using namespace dae;
+
+BufferHandle NullBackend::CreateVertexBuffer(const std::vector<VertexIn>& vertices)
+{
+	(void)vertices;
+	return ++m_NumBuffers;
+}
+
+BufferHandle NullBackend::CreateVertexBuffer(const QuantizedVertexBuffer& vertices)
+{
+	(void)vertices;
+	return ++m_NumBuffers;
+}
+
+BufferHandle NullBackend::CreateIndexBuffer(const std::vector<uint16_t>& indices)
+{
+	(void)indices;
+	return ++m_NumBuffers;
+}
+
+BufferHandle NullBackend::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+{
+	(void)indices;
+	return ++m_NumBuffers;
+}
+
+TextureHandle NullBackend::CreateTexture(const Texture* pTexture)
+{
+	if (!pTexture)
+		return INVALID_HANDLE;
+
+	return ++m_NumTextures;
+}
+
+// Submission cost of the index buffer draws is what this backend measures
+BufferHandle NullBackend::CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat)
+{
+	(void)meshlets;
+	(void)vertexFormat;
+	return INVALID_HANDLE;
+}
+
+void NullBackend::BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos)
+{
+	(void)clearColor;
+	(void)viewProjMatrix;
+	(void)cameraPos;
+
+	// Capacity is kept, so recording doesn't allocate once the first frame is done
+	m_Commands.clear();
+	m_FrameStats = Stats{};
+
+	Record(CommandType::BeginFrame);
+}
+
+void NullBackend::EndFrame()
+{
+	Record(CommandType::EndFrame);
+
+	m_TotalStats.numCommands += m_FrameStats.numCommands;
+	m_TotalStats.numDraws += m_FrameStats.numDraws;
+	m_TotalStats.numIndices += m_FrameStats.numIndices;
+	m_TotalStats.numInstances += m_FrameStats.numInstances;
+	m_TotalStats.numStateChanges += m_FrameStats.numStateChanges;
+	m_TotalStats.numRedundantStateChanges += m_FrameStats.numRedundantStateChanges;
+
+	m_IsStateBound = true;
+}
+
+void NullBackend::SetPipelineState(const PipelineState& pipelineState)
+{
+	RecordStateChange(CommandType::SetPipelineState, pipelineState == m_PipelineState,
+		static_cast<uint32_t>(pipelineState.blendMode), static_cast<uint32_t>(pipelineState.cullMode));
+	m_PipelineState = pipelineState;
+}
+
+void NullBackend::SetVertexBuffer(BufferHandle vertexBuffer)
+{
+	RecordStateChange(CommandType::SetVertexBuffer, vertexBuffer == m_VertexBuffer, vertexBuffer);
+	m_VertexBuffer = vertexBuffer;
+}
+
+void NullBackend::SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology)
+{
+	RecordStateChange(CommandType::SetIndexBuffer, indexBuffer == m_IndexBuffer && topology == m_Topology,
+		indexBuffer, static_cast<uint32_t>(topology));
+	m_IndexBuffer = indexBuffer;
+	m_Topology = topology;
+}
+
+void NullBackend::SetTexture(TextureSlot slot, TextureHandle texture)
+{
+	const int slotIndex{ static_cast<int>(slot) };
+
+	RecordStateChange(CommandType::SetTexture, texture == m_Textures[slotIndex], static_cast<uint32_t>(slotIndex), texture);
+	m_Textures[slotIndex] = texture;
+}
+
+void NullBackend::SetWorldMatrix(const Matrix& worldMatrix)
+{
+	RecordStateChange(CommandType::SetWorldMatrix, std::memcmp(&worldMatrix, &m_WorldMatrix, sizeof(Matrix)) == 0);
+	m_WorldMatrix = worldMatrix;
+}
+
+// The transforms are per draw data like a dynamic buffer upload, never redundant
+void NullBackend::SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	(void)pWorldMatrices;
+	Record(CommandType::SetInstanceTransforms, instanceCount);
+}
+
+void NullBackend::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	Record(CommandType::DrawIndexed, indexCount, startIndex, baseVertex);
+
+	++m_FrameStats.numDraws;
+	m_FrameStats.numIndices += indexCount;
+	++m_FrameStats.numInstances;
+}
+
+void NullBackend::DrawMeshlets(BufferHandle meshletBuffer)
+{
+	(void)meshletBuffer;
+}
+
+void NullBackend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex)
+{
+	Record(CommandType::DrawIndexedInstanced, indexCount, startIndex, baseVertex, instanceCount);
+
+	++m_FrameStats.numDraws;
+	m_FrameStats.numIndices += indexCount;
+	m_FrameStats.numInstances += instanceCount;
+}
+
+void NullBackend::DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount)
+{
+	for (const Mesh::Submesh& submesh : submeshes)
+	{
+		DrawIndexedInstanced(submesh.indexCount, instanceCount, submesh.startIndex, submesh.baseVertex);
+	}
+}
+
+void NullBackend::DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount)
+{
+	(void)meshletBuffer;
+	(void)instanceCount;
+}
+
+void NullBackend::PrintStats() const
+{
+	std::wcout << L"**NULL BACKEND** (last frame)\n";
+	std::wcout << L">> COMMANDS = " << m_FrameStats.numCommands << L" | DRAWS = " << m_FrameStats.numDraws
+		<< L" | INDICES = " << m_FrameStats.numIndices << L" | INSTANCES = " << m_FrameStats.numInstances << L"\n";
+	std::wcout << L">> STATE CHANGES = " << m_FrameStats.numStateChanges
+		<< L" | REDUNDANT = " << m_FrameStats.numRedundantStateChanges << L"\n";
+}
+
+void NullBackend::Record(CommandType type, uint32_t arg0, uint32_t arg1, int32_t arg2, uint32_t arg3)
+{
+	m_Commands.emplace_back(Command{ type, arg0, arg1, arg2, arg3 });
+	++m_FrameStats.numCommands;
+}
+
+void NullBackend::RecordStateChange(CommandType type, bool isRedundant, uint32_t arg0, uint32_t arg1)
+{
+	Record(type, arg0, arg1);
+
+	++m_FrameStats.numStateChanges;
+	if (isRedundant && m_IsStateBound)
+	{
+		++m_FrameStats.numRedundantStateChanges;
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "RenderBackend.h"
+
+namespace dae
+{
+	// Draws nothing - records every command of a frame and counts (redundant) state changes
+	// Measures CPU side submission cost without any GPU or rasterization work
+	class NullBackend final : public RenderBackend
+	{
+	public:
+		enum class CommandType
+		{
+			BeginFrame,
+			EndFrame,
+			SetPipelineState,
+			SetVertexBuffer,
+			SetIndexBuffer,
+			SetTexture,
+			SetWorldMatrix,
+			SetInstanceTransforms,
+			DrawIndexed,
+			DrawIndexedInstanced
+		};
+
+		struct Command
+		{
+			CommandType type{};
+			uint32_t arg0{}; // Handle / slot / index count, depending on the type
+			uint32_t arg1{};
+			int32_t arg2{}; // Base vertex of a draw
+			uint32_t arg3{}; // Instance count of an instanced draw
+		};
+
+		struct Stats
+		{
+			uint64_t numCommands{};
+			uint64_t numDraws{};
+			uint64_t numIndices{}; // Once per draw, not per instance
+			uint64_t numInstances{}; // A draw that isn't instanced counts as one
+			uint64_t numStateChanges{};
+			uint64_t numRedundantStateChanges{}; // Set to the value that was already bound
+		};
+
+		NullBackend() = default;
+		virtual ~NullBackend() override = default;
+
+		NullBackend(const NullBackend&) = delete;
+		NullBackend(NullBackend&&) noexcept = delete;
+		NullBackend& operator=(const NullBackend&) = delete;
+		NullBackend& operator=(NullBackend&&) noexcept = delete;
+
+		virtual const char* GetName() const override { return "Null"; };
+
+		virtual BufferHandle CreateVertexBuffer(const std::vector<VertexIn>& vertices) override;
+		virtual BufferHandle CreateVertexBuffer(const QuantizedVertexBuffer& vertices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint16_t>& indices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint32_t>& indices) override;
+		virtual TextureHandle CreateTexture(const Texture* pTexture) override;
+		virtual BufferHandle CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat) override;
+
+		virtual void BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos) override;
+		virtual void EndFrame() override;
+
+		virtual void SetPipelineState(const PipelineState& pipelineState) override;
+		virtual void SetVertexBuffer(BufferHandle vertexBuffer) override;
+		virtual void SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology) override;
+		virtual void SetTexture(TextureSlot slot, TextureHandle texture) override;
+		virtual void SetWorldMatrix(const Matrix& worldMatrix) override;
+		virtual void SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount) override;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawMeshlets(BufferHandle meshletBuffer) override;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount) override; // One instanced draw per submesh
+		virtual void DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount) override;
+
+		// Commands and stats of the last frame, totals since creation
+		const std::vector<Command>& GetCommands() const { return m_Commands; };
+		const Stats& GetFrameStats() const { return m_FrameStats; };
+		const Stats& GetTotalStats() const { return m_TotalStats; };
+		void PrintStats() const;
+
+	private:
+		uint32_t m_NumBuffers{};
+		uint32_t m_NumTextures{};
+
+		std::vector<Command> m_Commands{};
+		Stats m_FrameStats{};
+		Stats m_TotalStats{};
+
+		// Bound state, compared against to find redundant changes
+		bool m_IsStateBound{ false }; // Nothing counts as redundant before the first frame binds it
+		PipelineState m_PipelineState{};
+		BufferHandle m_VertexBuffer{ INVALID_HANDLE };
+		BufferHandle m_IndexBuffer{ INVALID_HANDLE };
+		PrimitiveTopology m_Topology{ PrimitiveTopology::TriangleList };
+		std::array<TextureHandle, TEXTURE_SLOT_COUNT> m_Textures{};
+		Matrix m_WorldMatrix{};
+
+		void Record(CommandType type, uint32_t arg0 = 0, uint32_t arg1 = 0, int32_t arg2 = 0, uint32_t arg3 = 0);
+		void RecordStateChange(CommandType type, bool isRedundant, uint32_t arg0 = 0, uint32_t arg1 = 0);
+	};
+}
@@ -0,0 +1,385 @@
+#include "OcclusionBuffer.h"
+#include "SIMD.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace dae
+{
+	namespace
+	{
+		using RowMasks = std::array<uint32_t, OcclusionBuffer::TILE_HEIGHT>;
+
+		// Edge function a * x + b * y + c, >= 0 inside
+		struct Edge
+		{
+			float a;
+			float b;
+			float c;
+		};
+
+		// Keeps spans of edges that barely slope inside the int range, far outside any buffer
+		constexpr float SPAN_LIMIT{ 1048576.f };
+
+		// Inward margin of the edges, in pixels - covers the rounding differences with the vertex stage of the rasterizers
+		constexpr float CONSERVATIVE_EPSILON{ 1.f / 64.f };
+
+#if defined(DAE_SIMD_SSE)
+		// Exact for |x| < 2^31, SSE2 has no floor
+		inline __m128 Floor(__m128 x)
+		{
+			const __m128i truncated{ _mm_cvttps_epi32(x) };
+			const __m128 truncatedFloat{ _mm_cvtepi32_ps(truncated) };
+			return _mm_sub_ps(truncatedFloat, _mm_and_ps(_mm_cmplt_ps(x, truncatedFloat), _mm_set1_ps(1.f)));
+		}
+
+		// ~0u << k for 0 <= k <= 32 in every lane - 2^k built in the float exponent, SSE2 has no variable shift
+		// 2^31 converts to 0x80000000 which is exactly what the shift gives, 2^32 does too and is masked out
+		inline __m128i OnesShiftedLeft(__m128i k)
+		{
+			const __m128 powerOfTwo{ _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(k, _mm_set1_epi32(127)), 23)) };
+			const __m128i shifted{ _mm_sub_epi32(_mm_setzero_si128(), _mm_cvttps_epi32(powerOfTwo)) };
+			return _mm_andnot_si128(_mm_cmpeq_epi32(k, _mm_set1_epi32(32)), shifted);
+		}
+
+		// Covered pixels of four rows are [left, right), one row per lane
+		void ComputeRowSpans(const std::array<Edge, 3>& edges, float firstRowCenter, float* pLeft, float* pRight)
+		{
+			const __m128 rowCenters{ _mm_add_ps(_mm_set1_ps(firstRowCenter), _mm_set_ps(3.f, 2.f, 1.f, 0.f)) };
+			const __m128 limit{ _mm_set1_ps(SPAN_LIMIT) };
+			const __m128 negativeLimit{ _mm_set1_ps(-SPAN_LIMIT) };
+			const __m128 half{ _mm_set1_ps(0.5f) };
+
+			__m128 left{ negativeLimit };
+			__m128 right{ limit };
+
+			for (const Edge& edge : edges)
+			{
+				const __m128 rowValues{ MultiplyAdd(_mm_set1_ps(edge.b), rowCenters, _mm_set1_ps(edge.c)) };
+
+				if (edge.a == 0.f)
+				{
+					// Horizontal edge, whole rows are inside or outside
+					const __m128 isInside{ _mm_cmpge_ps(rowValues, _mm_setzero_ps()) };
+					left = _mm_max_ps(left, _mm_or_ps(_mm_and_ps(isInside, negativeLimit), _mm_andnot_ps(isInside, limit)));
+					continue;
+				}
+
+				// Pixel center x + 0.5 on the edge
+				const __m128 crossing{ _mm_min_ps(_mm_max_ps(_mm_mul_ps(rowValues, _mm_set1_ps(-1.f / edge.a)), negativeLimit), limit) };
+				if (edge.a > 0.f)
+				{
+					// First pixel inside = ceil(crossing - 0.5)
+					const __m128 first{ _mm_sub_ps(_mm_setzero_ps(), Floor(_mm_sub_ps(half, crossing))) };
+					left = _mm_max_ps(left, first);
+				}
+				else
+				{
+					// One past the last pixel inside = floor(crossing - 0.5) + 1
+					right = _mm_min_ps(right, Floor(_mm_add_ps(crossing, half)));
+				}
+			}
+
+			_mm_store_ps(pLeft, left);
+			_mm_store_ps(pRight, right);
+		}
+
+		// Bits of [left, right) inside the tile starting at tileX, integer valued spans
+		RowMasks GetSpanMasks(const float* pLeft, const float* pRight, float tileX)
+		{
+			const __m128 tileOrigin{ _mm_set1_ps(tileX) };
+			const __m128 zero{ _mm_setzero_ps() };
+			const __m128 tileWidth{ _mm_set1_ps(static_cast<float>(OcclusionBuffer::TILE_WIDTH)) };
+
+			const __m128i first{ _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(pLeft), tileOrigin), zero), tileWidth)) };
+			const __m128i end{ _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(pRight), tileOrigin), zero), tileWidth)) };
+
+			alignas(16) RowMasks masks;
+			_mm_store_si128(reinterpret_cast<__m128i*>(masks.data()), _mm_andnot_si128(OnesShiftedLeft(end), OnesShiftedLeft(first)));
+			return masks;
+		}
+#else
+		inline uint32_t OnesShiftedLeft(int k)
+		{
+			return k >= 32 ? 0u : ~0u << k;
+		}
+
+		void ComputeRowSpans(const std::array<Edge, 3>& edges, float firstRowCenter, float* pLeft, float* pRight)
+		{
+			for (int row{}; row < OcclusionBuffer::TILE_HEIGHT; ++row)
+			{
+				const float rowCenter{ firstRowCenter + static_cast<float>(row) };
+				float left{ -SPAN_LIMIT };
+				float right{ SPAN_LIMIT };
+
+				for (const Edge& edge : edges)
+				{
+					const float rowValue{ edge.b * rowCenter + edge.c };
+
+					if (edge.a == 0.f)
+					{
+						left = std::max(left, rowValue >= 0.f ? -SPAN_LIMIT : SPAN_LIMIT);
+						continue;
+					}
+
+					const float crossing{ std::clamp(-rowValue / edge.a, -SPAN_LIMIT, SPAN_LIMIT) };
+					if (edge.a > 0.f)
+						left = std::max(left, std::ceil(crossing - 0.5f));
+					else
+						right = std::min(right, std::floor(crossing + 0.5f));
+				}
+
+				pLeft[row] = left;
+				pRight[row] = right;
+			}
+		}
+
+		RowMasks GetSpanMasks(const float* pLeft, const float* pRight, float tileX)
+		{
+			constexpr float tileWidth{ static_cast<float>(OcclusionBuffer::TILE_WIDTH) };
+
+			RowMasks masks{};
+			for (int row{}; row < OcclusionBuffer::TILE_HEIGHT; ++row)
+			{
+				const int first{ static_cast<int>(std::clamp(pLeft[row] - tileX, 0.f, tileWidth)) };
+				const int end{ static_cast<int>(std::clamp(pRight[row] - tileX, 0.f, tileWidth)) };
+				masks[row] = OnesShiftedLeft(first) & ~OnesShiftedLeft(end);
+			}
+			return masks;
+		}
+#endif
+	}
+
+	OcclusionBuffer::OcclusionBuffer(int screenWidth, int screenHeight) :
+		m_ScreenWidth{ screenWidth },
+		m_ScreenHeight{ screenHeight }
+	{
+		m_NumTilesX = (screenWidth + TILE_WIDTH - 1) / TILE_WIDTH;
+		m_NumTilesY = (screenHeight + TILE_HEIGHT - 1) / TILE_HEIGHT;
+		m_Width = m_NumTilesX * TILE_WIDTH;
+		m_Height = m_NumTilesY * TILE_HEIGHT;
+		m_Tiles.resize(static_cast<size_t>(m_NumTilesX) * m_NumTilesY);
+	}
+
+	void OcclusionBuffer::Clear(const Matrix& viewProjMatrix)
+	{
+		std::fill(m_Tiles.begin(), m_Tiles.end(), Tile{});
+		m_ViewProjMatrix = viewProjMatrix;
+		m_NumOccluderTriangles = 0;
+	}
+
+	void OcclusionBuffer::RenderOccluder(const std::vector<Vector3>& trianglePositions, const Matrix& worldMatrix)
+	{
+		const Matrix worldViewProjMatrix{ worldMatrix * m_ViewProjMatrix };
+		const float screenWidth{ static_cast<float>(m_ScreenWidth) };
+		const float screenHeight{ static_cast<float>(m_ScreenHeight) };
+
+		for (size_t i{}; i + 2 < trianglePositions.size(); i += 3)
+		{
+			std::array<Vector3, 3> screenVertices{};
+			bool isDrawn{ true };
+
+			for (size_t corner{}; corner < 3 && isDrawn; ++corner)
+			{
+				const Vector4 clip{ worldViewProjMatrix.TransformPoint(Vector4{ trianglePositions[i + corner], 1.f }) };
+				if (clip.w <= 0.f)
+				{
+					isDrawn = false;
+					break;
+				}
+
+				// Same mapping as the vertex stage, then the same rejections as SoftwareRasterizer::PassTriangleOptimizations
+				const float invW{ 1.f / clip.w };
+				Vector3& vertex{ screenVertices[corner] };
+				vertex = Vector3{ (clip.x * invW + 1.f) * 0.5f * screenWidth, (1.f - clip.y * invW) * 0.5f * screenHeight, clip.z * invW };
+
+				isDrawn = vertex.x >= 0.f && vertex.x < screenWidth && vertex.y >= 0.f && vertex.y < screenHeight
+					&& vertex.z >= 0.f && vertex.z <= 1.f;
+			}
+
+			if (!isDrawn)
+				continue;
+
+			const Vector2 v0{ screenVertices[0].x, screenVertices[0].y };
+			const float signedArea{ Vector2::Cross(Vector2{ screenVertices[1].x, screenVertices[1].y } - v0,
+				Vector2{ screenVertices[2].x, screenVertices[2].y } - v0) };
+			if (signedArea <= 0.f)
+				continue;
+
+			RasterizeTriangle(screenVertices[0], screenVertices[1], screenVertices[2]);
+			++m_NumOccluderTriangles;
+		}
+	}
+
+	void OcclusionBuffer::RasterizeTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2)
+	{
+		const std::array<const Vector3*, 3> vertices{ &v0, &v1, &v2 };
+
+		// Same pixel center samples as the rasterizers, a center has to be inside by a margin to count
+		std::array<Edge, 3> edges{};
+		for (size_t i{}; i < 3; ++i)
+		{
+			const Vector3& from{ *vertices[i] };
+			const Vector3& to{ *vertices[(i + 1) % 3] };
+
+			Edge& edge{ edges[i] };
+			edge.a = from.y - to.y;
+			edge.b = to.x - from.x;
+			edge.c = -(edge.a * from.x + edge.b * from.y) - CONSERVATIVE_EPSILON * (std::abs(edge.a) + std::abs(edge.b));
+		}
+
+		// z / w is linear in screen space, both rasterizers interpolate it that way or lower (harmonic)
+		const Vector3 edge1{ v1 - v0 };
+		const Vector3 edge2{ v2 - v0 };
+		const float determinant{ edge1.x * edge2.y - edge2.x * edge1.y };
+		const float depthSlopeX{ (edge1.z * edge2.y - edge2.z * edge1.y) / determinant };
+		const float depthSlopeY{ (edge2.z * edge1.x - edge1.z * edge2.x) / determinant };
+		const float maxDepth{ std::max({ v0.z, v1.z, v2.z }) };
+
+		// Largest depth over a tile sits at one of its corners
+		const float depthRiseX{ std::max(0.f, depthSlopeX * TILE_WIDTH) };
+		const float depthRiseY{ std::max(0.f, depthSlopeY * TILE_HEIGHT) };
+
+		const float minX{ std::min({ v0.x, v1.x, v2.x }) };
+		const float maxX{ std::max({ v0.x, v1.x, v2.x }) };
+		const float minY{ std::min({ v0.y, v1.y, v2.y }) };
+		const float maxY{ std::max({ v0.y, v1.y, v2.y }) };
+
+		const int firstTileX{ std::max(0, static_cast<int>(minX) / TILE_WIDTH) };
+		const int lastTileX{ std::min(m_NumTilesX - 1, static_cast<int>(maxX) / TILE_WIDTH) };
+		const int firstTileY{ std::max(0, static_cast<int>(minY) / TILE_HEIGHT) };
+		const int lastTileY{ std::min(m_NumTilesY - 1, static_cast<int>(maxY) / TILE_HEIGHT) };
+
+		alignas(16) float left[TILE_HEIGHT];
+		alignas(16) float right[TILE_HEIGHT];
+
+		for (int tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+		{
+			const float tileTop{ static_cast<float>(tileY * TILE_HEIGHT) };
+			ComputeRowSpans(edges, tileTop + 0.5f, left, right);
+
+			for (int tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+			{
+				const float tileLeft{ static_cast<float>(tileX * TILE_WIDTH) };
+				const RowMasks coverage{ GetSpanMasks(left, right, tileLeft) };
+				if ((coverage[0] | coverage[1] | coverage[2] | coverage[3]) == 0)
+					continue;
+
+				const float tileDepth{ v0.z + depthSlopeX * (tileLeft - v0.x) + depthSlopeY * (tileTop - v0.y) + depthRiseX + depthRiseY };
+				UpdateTile(m_Tiles[tileY * m_NumTilesX + tileX], coverage, std::min(tileDepth, maxDepth));
+			}
+		}
+	}
+
+	void OcclusionBuffer::UpdateTile(Tile& tile, const RowMasks& coverage, float zMax) const
+	{
+		// Nothing the tile does not know already
+		if (zMax >= tile.zMax0)
+			return;
+
+		// A triangle far in front of the working layer starts a new one, keeping both would only push zMax1 back
+		if (tile.zMax1 - zMax > tile.zMax0 - tile.zMax1)
+		{
+			tile.mask = {};
+			tile.zMax1 = 0.f;
+		}
+
+		bool isFull{ true };
+		for (int row{}; row < TILE_HEIGHT; ++row)
+		{
+			tile.mask[row] |= coverage[row];
+			isFull = isFull && tile.mask[row] == ~0u;
+		}
+		tile.zMax1 = std::max(tile.zMax1, zMax);
+
+		// Every pixel is nearer than zMax1 => it becomes the reference layer
+		if (isFull)
+		{
+			tile.zMax0 = tile.zMax1;
+			tile.zMax1 = 0.f;
+			tile.mask = {};
+		}
+	}
+
+	bool OcclusionBuffer::IsBoxVisible(const AABB& worldBox) const
+	{
+		float minX{ FLT_MAX };
+		float maxX{ -FLT_MAX };
+		float minY{ FLT_MAX };
+		float maxY{ -FLT_MAX };
+		float minDepth{ FLT_MAX };
+
+		const float screenScaleX{ 0.5f * static_cast<float>(m_ScreenWidth) };
+		const float screenScaleY{ 0.5f * static_cast<float>(m_ScreenHeight) };
+
+		for (int corner{}; corner < 8; ++corner)
+		{
+			const Vector3 position{ (corner & 1) ? worldBox.max.x : worldBox.min.x, (corner & 2) ? worldBox.max.y : worldBox.min.y,
+				(corner & 4) ? worldBox.max.z : worldBox.min.z };
+			const Vector4 clip{ m_ViewProjMatrix.TransformPoint(Vector4{ position, 1.f }) };
+
+			// Reaches behind the camera, the projection is unbounded
+			if (clip.w <= 0.f)
+				return true;
+
+			const float invW{ 1.f / clip.w };
+			const float x{ (clip.x * invW + 1.f) * screenScaleX };
+			const float y{ (1.f - clip.y * invW) * screenScaleY };
+
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+			minY = std::min(minY, y);
+			maxY = std::max(maxY, y);
+			minDepth = std::min(minDepth, clip.z * invW); // Nearest point of a box is a corner, z / w only grows with distance
+		}
+
+		// Every pixel whose center the box may cover
+		const int firstX{ static_cast<int>(std::floor(std::clamp(minX, -1.f, static_cast<float>(m_Width)))) };
+		const int lastX{ static_cast<int>(std::floor(std::clamp(maxX, -1.f, static_cast<float>(m_Width)))) };
+		const int firstY{ static_cast<int>(std::floor(std::clamp(minY, -1.f, static_cast<float>(m_Height)))) };
+		const int lastY{ static_cast<int>(std::floor(std::clamp(maxY, -1.f, static_cast<float>(m_Height)))) };
+
+		const int x0{ std::max(firstX, 0) };
+		const int x1{ std::min(lastX, m_Width - 1) };
+		const int y0{ std::max(firstY, 0) };
+		const int y1{ std::min(lastY, m_Height - 1) };
+
+		// Off the screen - the frustum test decides about those
+		if (x0 > x1 || y0 > y1)
+			return true;
+
+		alignas(16) float left[TILE_HEIGHT];
+		alignas(16) float right[TILE_HEIGHT];
+
+		for (int tileY{ y0 / TILE_HEIGHT }; tileY <= y1 / TILE_HEIGHT; ++tileY)
+		{
+			for (int row{}; row < TILE_HEIGHT; ++row)
+			{
+				const int y{ tileY * TILE_HEIGHT + row };
+				const bool isInside{ y >= y0 && y <= y1 };
+				left[row] = isInside ? static_cast<float>(x0) : SPAN_LIMIT;
+				right[row] = isInside ? static_cast<float>(x1 + 1) : SPAN_LIMIT;
+			}
+
+			for (int tileX{ x0 / TILE_WIDTH }; tileX <= x1 / TILE_WIDTH; ++tileX)
+			{
+				const Tile& tile{ m_Tiles[tileY * m_NumTilesX + tileX] };
+				const RowMasks rect{ GetSpanMasks(left, right, static_cast<float>(tileX * TILE_WIDTH)) };
+
+				// Visible when it can get in front of the working layer or of the reference layer where the working layer is not
+				bool overlapsWorkingLayer{ false };
+				bool overlapsReferenceLayer{ false };
+				for (int row{}; row < TILE_HEIGHT; ++row)
+				{
+					overlapsWorkingLayer = overlapsWorkingLayer || (rect[row] & tile.mask[row]) != 0;
+					overlapsReferenceLayer = overlapsReferenceLayer || (rect[row] & ~tile.mask[row]) != 0;
+				}
+
+				if ((overlapsWorkingLayer && minDepth <= tile.zMax1) || (overlapsReferenceLayer && minDepth <= tile.zMax0))
+					return true;
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "BoundingVolumes.h"
+
+namespace dae
+{
+	// Low resolution CPU depth for occlusion culling, masked occlusion style (Hasselgren, Andersson, Akenine-Moller)
+	// Every tile keeps a coverage mask and two depths instead of a depth per pixel:
+	// pixels in the mask are nearer than zMax1, every pixel of the tile is nearer than zMax0
+	// Depth is z / w of the projection (0 near, 1 far) like both rasterizers
+	// Coverage is sampled at the pixel centers of the screen => adjacent occluder triangles leave no gaps between them
+	class OcclusionBuffer final
+	{
+	public:
+		static constexpr int TILE_WIDTH{ 32 }; // One bit per pixel in a row mask
+		static constexpr int TILE_HEIGHT{ 4 }; // One SIMD lane per row
+
+		OcclusionBuffer(int screenWidth, int screenHeight);
+
+		// Empty buffer for the next frame, occluders and occludees are projected with viewProjMatrix
+		void Clear(const Matrix& viewProjMatrix);
+
+		// Object space triangle list, three positions per triangle
+		// Only triangles both rasterizers are guaranteed to draw count (front facing, fully on screen and in depth range)
+		// and only pixel centers they cover => culling never changes the image
+		void RenderOccluder(const std::vector<Vector3>& trianglePositions, const Matrix& worldMatrix);
+
+		// False only when every pixel the box may cover is strictly behind rendered occluders
+		bool IsBoxVisible(const AABB& worldBox) const;
+
+		uint64_t GetOccluderTriangleCount() const { return m_NumOccluderTriangles; }; // Rasterized since Clear
+
+	private:
+		struct Tile
+		{
+			alignas(16) std::array<uint32_t, TILE_HEIGHT> mask{};
+			float zMax0{ 1.f };
+			float zMax1{ 0.f };
+		};
+
+		int m_ScreenWidth{};
+		int m_ScreenHeight{};
+		int m_Width{}; // Whole tiles, the last column and row may reach past the screen
+		int m_Height{};
+		int m_NumTilesX{};
+		int m_NumTilesY{};
+		std::vector<Tile> m_Tiles{};
+
+		Matrix m_ViewProjMatrix{};
+		uint64_t m_NumOccluderTriangles{};
+
+		// Screen pixel coordinates, z / w depth, positive screen winding
+		void RasterizeTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+		void UpdateTile(Tile& tile, const std::array<uint32_t, TILE_HEIGHT>& coverage, float zMax) const;
+	};
+}
@@ -1,7 +1,7 @@
 #include "OpaqueEffect.h"
 #include <iostream>
 #include <sstream> // string stream for wstringstream
-#include "Texture.h"
+#include "D3D11Texture.h"
 
 OpaqueEffect::OpaqueEffect(ID3D11Device* pDevice)
 	: Effect::Effect(pDevice, L"resources/PosCol3D.fx")
@@ -71,7 +71,7 @@ ID3DX11EffectVectorVariable* OpaqueEffect::GetCameraPos() const
 	return m_pCameraPosVariable;
 }
 
-void OpaqueEffect::SetNormalMap(Texture* pNormalTexture)
+void OpaqueEffect::SetNormalMap(D3D11Texture* pNormalTexture)
 {
 	if (m_pNormalMapVairable && pNormalTexture)
 	{
@@ -79,7 +79,7 @@ void OpaqueEffect::SetNormalMap(Texture* pNormalTexture)
 	}
 }
 
-void OpaqueEffect::SetSpecularMap(Texture* pSpecularTexture)
+void OpaqueEffect::SetSpecularMap(D3D11Texture* pSpecularTexture)
 {
 	if (m_pSpecularMapVairable && pSpecularTexture)
 	{
@@ -87,7 +87,7 @@ void OpaqueEffect::SetSpecularMap(Texture* pSpecularTexture)
 	}
 }
 
-void OpaqueEffect::SetGlossMap(Texture* pGlossTexture)
+void OpaqueEffect::SetGlossMap(D3D11Texture* pGlossTexture)
 {
 	if (m_pGlossMapVairable && pGlossTexture)
 	{
@@ -16,9 +16,9 @@ public:
 	virtual ID3DX11EffectMatrixVariable* GetWorldMatrix() const override;
 	virtual ID3DX11EffectVectorVariable* GetCameraPos() const override;
 
-	virtual void SetNormalMap(Texture* pNormalTexture) override;
-	virtual void SetSpecularMap(Texture* pSpecularTexture) override;
-	virtual void SetGlossMap(Texture* pGlossTexture) override;
+	virtual void SetNormalMap(D3D11Texture* pNormalTexture) override;
+	virtual void SetSpecularMap(D3D11Texture* pSpecularTexture) override;
+	virtual void SetGlossMap(D3D11Texture* pGlossTexture) override;
 	
 private:
 
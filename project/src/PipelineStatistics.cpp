@@ -0,0 +1,24 @@
+#include "PipelineStatistics.h"
+#include <iostream>
+
+namespace dae
+{
+	void PipelineStatistics::Print() const
+	{
+		std::wcout << L"**PIPELINE STATISTICS** (last frame)\n";
+		std::wcout << L">> MESHES = " << meshesSubmitted << L" | CULLED: FRUSTUM = " << meshesCulledFrustum
+			<< L" OCCLUSION = " << meshesCulledOcclusion << L" (" << GetMeshCullRate() * 100.0 << L"%) | OCCLUDER TRIANGLES = "
+			<< occluderTriangles << L" | BVH UPDATE = " << bvhUpdateTime * 1e-6 << L" ms\n";
+		std::wcout << L">> MESH TRIANGLES = " << meshTriangles << L" | SKIPPED BY LOD = " << meshTrianglesSkippedLod
+			<< L" (" << GetLodSkipRate() * 100.0 << L"%)\n";
+		std::wcout << L">> VERTICES = " << verticesTransformed << L" (" << GetVerticesPerSecond() * 1e-6 << L" M/s) | TRIANGLES = "
+			<< trianglesSubmitted << L" | RASTERIZED = " << trianglesRasterized << L"\n";
+		std::wcout << L">> CLUSTERS = " << clustersSubmitted << L" | CULLED: FRUSTUM = " << clustersCulledFrustum
+			<< L" | BACKFACE = " << clustersCulledBackface << L" (" << GetClusterCullRate() * 100.0 << L"%)\n";
+		std::wcout << L">> CULLED: OFFSCREEN = " << trianglesCulledOffscreen << L" | DEPTH RANGE = " << trianglesCulledDepthRange
+			<< L" | FACING = " << trianglesCulledFacing << L" | ZERO AREA = " << trianglesCulledZeroArea << L"\n";
+		std::wcout << L">> PIXELS: TESTED = " << pixelsTested << L" | COVERED = " << pixelsCovered
+			<< L" | DEPTH PASS = " << depthPasses << L" | DEPTH FAIL = " << depthFailures << L"\n";
+		std::wcout << L">> SHADER INVOCATIONS = " << shaderInvocations << L" | TEXTURE SAMPLES = " << textureSamples << L"\n";
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+
+namespace dae
+{
+	// Software equivalent of D3D11_QUERY_DATA_PIPELINE_STATISTICS, counted per frame
+	struct PipelineStatistics
+	{
+		uint64_t meshesSubmitted{}; // Mesh draws of the scene, culled against the frustum and the occlusion buffer before they reach the backend
+		uint64_t meshesCulledFrustum{};
+		uint64_t meshesCulledOcclusion{}; // Inside the frustum but behind the occluders rendered into the occlusion buffer
+		uint64_t occluderTriangles{};
+		uint64_t meshTriangles{}; // Of the meshes that reach the backend, at the level of detail they are drawn with
+		uint64_t meshTrianglesSkippedLod{}; // Left out by coarser levels of detail
+		uint64_t bvhUpdateTime{}; // ns spent on the world boxes and the refit of the scene BVH
+
+		double GetMeshCullRate() const { return meshesSubmitted > 0 ? static_cast<double>(meshesCulledFrustum + meshesCulledOcclusion) / meshesSubmitted : 0.0; };
+		double GetLodSkipRate() const
+		{
+			const uint64_t fullDetailTriangles{ meshTriangles + meshTrianglesSkippedLod };
+			return fullDetailTriangles > 0 ? static_cast<double>(meshTrianglesSkippedLod) / fullDetailTriangles : 0.0;
+		};
+
+		uint64_t verticesTransformed{};
+		uint64_t vertexTransformTime{}; // ns spent in the vertex stage, not a D3D11 counter but summed the same way
+
+		double GetVerticesPerSecond() const { return vertexTransformTime > 0 ? verticesTransformed * 1e9 / vertexTransformTime : 0.0; };
+
+		uint64_t clustersSubmitted{}; // Meshlets of meshlet draws, culled before the vertex stage
+		uint64_t clustersCulledFrustum{};
+		uint64_t clustersCulledBackface{}; // Normal cone faces away from the camera
+
+		double GetClusterCullRate() const
+		{
+			return clustersSubmitted > 0 ? static_cast<double>(clustersCulledFrustum + clustersCulledBackface) / clustersSubmitted : 0.0;
+		};
+
+		uint64_t trianglesSubmitted{};
+		uint64_t trianglesCulledOffscreen{};  // A vertex outside the screen (no clipping)
+		uint64_t trianglesCulledDepthRange{}; // A vertex outside [0, 1] depth
+		uint64_t trianglesCulledFacing{};     // Wrong winding, the edge test can never cover a pixel
+		uint64_t trianglesCulledZeroArea{};
+		uint64_t trianglesRasterized{};
+
+		uint64_t pixelsTested{};  // Inside the bounding box
+		uint64_t pixelsCovered{}; // Passed the edge test
+		uint64_t depthPasses{};
+		uint64_t depthFailures{};
+		uint64_t shaderInvocations{};
+		uint64_t textureSamples{};
+
+		PipelineStatistics& operator+=(const PipelineStatistics& other)
+		{
+			ZipCounters(other, [](uint64_t& counter, uint64_t otherCounter) { counter += otherCounter; });
+			return *this;
+		};
+
+		// Calls function(name, value) for every counter, names are snake_case (JSON keys)
+		template <typename Function>
+		void ForEachCounter(Function&& function) const
+		{
+			function("meshes_submitted", meshesSubmitted);
+			function("meshes_culled_frustum", meshesCulledFrustum);
+			function("meshes_culled_occlusion", meshesCulledOcclusion);
+			function("occluder_triangles", occluderTriangles);
+			function("mesh_triangles", meshTriangles);
+			function("mesh_triangles_skipped_lod", meshTrianglesSkippedLod);
+			function("bvh_update_ns", bvhUpdateTime);
+			function("vertices_transformed", verticesTransformed);
+			function("vertex_transform_ns", vertexTransformTime);
+			function("clusters_submitted", clustersSubmitted);
+			function("clusters_culled_frustum", clustersCulledFrustum);
+			function("clusters_culled_backface", clustersCulledBackface);
+			function("triangles_submitted", trianglesSubmitted);
+			function("triangles_culled_offscreen", trianglesCulledOffscreen);
+			function("triangles_culled_depth_range", trianglesCulledDepthRange);
+			function("triangles_culled_facing", trianglesCulledFacing);
+			function("triangles_culled_zero_area", trianglesCulledZeroArea);
+			function("triangles_rasterized", trianglesRasterized);
+			function("pixels_tested", pixelsTested);
+			function("pixels_covered", pixelsCovered);
+			function("depth_passes", depthPasses);
+			function("depth_failures", depthFailures);
+			function("shader_invocations", shaderInvocations);
+			function("texture_samples", textureSamples);
+		};
+
+		void Print() const;
+
+	private:
+		template <typename Function>
+		void ZipCounters(const PipelineStatistics& other, Function&& function)
+		{
+			function(meshesSubmitted, other.meshesSubmitted);
+			function(meshesCulledFrustum, other.meshesCulledFrustum);
+			function(meshesCulledOcclusion, other.meshesCulledOcclusion);
+			function(occluderTriangles, other.occluderTriangles);
+			function(meshTriangles, other.meshTriangles);
+			function(meshTrianglesSkippedLod, other.meshTrianglesSkippedLod);
+			function(bvhUpdateTime, other.bvhUpdateTime);
+			function(verticesTransformed, other.verticesTransformed);
+			function(vertexTransformTime, other.vertexTransformTime);
+			function(clustersSubmitted, other.clustersSubmitted);
+			function(clustersCulledFrustum, other.clustersCulledFrustum);
+			function(clustersCulledBackface, other.clustersCulledBackface);
+			function(trianglesSubmitted, other.trianglesSubmitted);
+			function(trianglesCulledOffscreen, other.trianglesCulledOffscreen);
+			function(trianglesCulledDepthRange, other.trianglesCulledDepthRange);
+			function(trianglesCulledFacing, other.trianglesCulledFacing);
+			function(trianglesCulledZeroArea, other.trianglesCulledZeroArea);
+			function(trianglesRasterized, other.trianglesRasterized);
+			function(pixelsTested, other.pixelsTested);
+			function(pixelsCovered, other.pixelsCovered);
+			function(depthPasses, other.depthPasses);
+			function(depthFailures, other.depthFailures);
+			function(shaderInvocations, other.shaderInvocations);
+			function(textureSamples, other.textureSamples);
+		};
+	};
+
+	// Both software transparency modes blended over the same opaque frame (SoftwareRasterizer::CompareTransparencyModes)
+	struct TransparencyComparison
+	{
+		uint64_t numTriangles{}; // 0 => the frame had no transparent triangles, nothing was compared
+		float sortedTime{}; // ms
+		float oitTime{}; // ms
+		double meanChannelError{}; // 0..255, over every RGB channel of the frame
+		int maxChannelError{};
+
+		// Sums everything but the max error, which keeps the largest
+		TransparencyComparison& operator+=(const TransparencyComparison& other)
+		{
+			numTriangles += other.numTriangles;
+			sortedTime += other.sortedTime;
+			oitTime += other.oitTime;
+			meanChannelError += other.meanChannelError;
+			maxChannelError = maxChannelError > other.maxChannelError ? maxChannelError : other.maxChannelError;
+			return *this;
+		};
+	};
+}
@@ -0,0 +1,162 @@
+#include "PixelFormat.h"
+#include <array>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#define DAE_PIXEL_SSE2
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		constexpr int SRGB_LUT_SIZE{ 4096 };
+
+		// Linear [0, 1] (quantized to 12 bits) -> sRGB 8 bit
+		const std::array<uint8_t, SRGB_LUT_SIZE>& GetLinearToSRGBTable()
+		{
+			static const std::array<uint8_t, SRGB_LUT_SIZE> table{ []()
+				{
+					std::array<uint8_t, SRGB_LUT_SIZE> lut{};
+					for (int i{}; i < SRGB_LUT_SIZE; ++i)
+					{
+						const float linear{ static_cast<float>(i) / (SRGB_LUT_SIZE - 1) };
+						const float encoded{ linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.f / 2.4f) - 0.055f };
+						lut[i] = static_cast<uint8_t>(encoded * 255.f + 0.5f);
+					}
+					return lut;
+				}() };
+			return table;
+		}
+
+		// sRGB 8 bit -> Linear [0, 1]
+		const std::array<float, 256>& GetSRGBToLinearTable()
+		{
+			static const std::array<float, 256> table{ []()
+				{
+					std::array<float, 256> lut{};
+					for (int i{}; i < 256; ++i)
+					{
+						const float encoded{ i / 255.f };
+						lut[i] = encoded <= 0.04045f ? encoded / 12.92f : powf((encoded + 0.055f) / 1.055f, 2.4f);
+					}
+					return lut;
+				}() };
+			return table;
+		}
+
+		// Brightest channel, at least one => dividing by it keeps every channel in [0, 1]
+		inline float GetMaxChannel(const ColorRGB& color)
+		{
+			return std::max(1.f, std::max(color.r, std::max(color.g, color.b)));
+		}
+	}
+
+	uint32_t PackColor(const ColorRGB& color, bool sRGBEncoding)
+	{
+		const float maxChannel{ GetMaxChannel(color) };
+
+		if (sRGBEncoding)
+		{
+			const auto& lut{ GetLinearToSRGBTable() };
+			constexpr float lutRange{ SRGB_LUT_SIZE - 1 };
+
+			return PackRGB(lut[static_cast<int>(std::max(0.f, color.r / maxChannel) * lutRange)],
+				lut[static_cast<int>(std::max(0.f, color.g / maxChannel) * lutRange)],
+				lut[static_cast<int>(std::max(0.f, color.b / maxChannel) * lutRange)]);
+		}
+
+		return PackRGB(static_cast<uint8_t>(std::max(0.f, color.r / maxChannel) * 255.f),
+			static_cast<uint8_t>(std::max(0.f, color.g / maxChannel) * 255.f),
+			static_cast<uint8_t>(std::max(0.f, color.b / maxChannel) * 255.f));
+	}
+
+	void PackColorSpan(const float* pRed, const float* pGreen, const float* pBlue, uint32_t* pOut, int count, bool sRGBEncoding)
+	{
+		int i{};
+
+		if (sRGBEncoding)
+		{
+			// Table lookups don't vectorize, the LUT still removes every powf from the per pixel path
+			for (; i < count; ++i)
+			{
+				pOut[i] = PackColor(ColorRGB{ pRed[i], pGreen[i], pBlue[i] }, true);
+			}
+			return;
+		}
+
+#if defined(__AVX2__)
+		{
+			const __m256 one{ _mm256_set1_ps(1.f) };
+			const __m256 zero{ _mm256_setzero_ps() };
+			const __m256 range{ _mm256_set1_ps(255.f) };
+			const __m256i alpha{ _mm256_set1_epi32(static_cast<int>(0xFF000000u)) };
+
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 r{ _mm256_loadu_ps(pRed + i) };
+				const __m256 g{ _mm256_loadu_ps(pGreen + i) };
+				const __m256 b{ _mm256_loadu_ps(pBlue + i) };
+
+				const __m256 maxChannel{ _mm256_max_ps(one, _mm256_max_ps(r, _mm256_max_ps(g, b))) };
+
+				const __m256i ri{ _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_max_ps(zero, _mm256_div_ps(r, maxChannel)), range)) };
+				const __m256i gi{ _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_max_ps(zero, _mm256_div_ps(g, maxChannel)), range)) };
+				const __m256i bi{ _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_max_ps(zero, _mm256_div_ps(b, maxChannel)), range)) };
+
+				const __m256i packed{ _mm256_or_si256(_mm256_or_si256(alpha, _mm256_slli_epi32(ri, 16)),
+					_mm256_or_si256(_mm256_slli_epi32(gi, 8), bi)) };
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), packed);
+			}
+		}
+#endif
+
+#if defined(DAE_PIXEL_SSE2)
+		{
+			const __m128 one{ _mm_set1_ps(1.f) };
+			const __m128 zero{ _mm_setzero_ps() };
+			const __m128 range{ _mm_set1_ps(255.f) };
+			const __m128i alpha{ _mm_set1_epi32(static_cast<int>(0xFF000000u)) };
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128 r{ _mm_loadu_ps(pRed + i) };
+				const __m128 g{ _mm_loadu_ps(pGreen + i) };
+				const __m128 b{ _mm_loadu_ps(pBlue + i) };
+
+				const __m128 maxChannel{ _mm_max_ps(one, _mm_max_ps(r, _mm_max_ps(g, b))) };
+
+				const __m128i ri{ _mm_cvttps_epi32(_mm_mul_ps(_mm_max_ps(zero, _mm_div_ps(r, maxChannel)), range)) };
+				const __m128i gi{ _mm_cvttps_epi32(_mm_mul_ps(_mm_max_ps(zero, _mm_div_ps(g, maxChannel)), range)) };
+				const __m128i bi{ _mm_cvttps_epi32(_mm_mul_ps(_mm_max_ps(zero, _mm_div_ps(b, maxChannel)), range)) };
+
+				const __m128i packed{ _mm_or_si128(_mm_or_si128(alpha, _mm_slli_epi32(ri, 16)),
+					_mm_or_si128(_mm_slli_epi32(gi, 8), bi)) };
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), packed);
+			}
+		}
+#endif
+
+		// Tail
+		for (; i < count; ++i)
+		{
+			pOut[i] = PackColor(ColorRGB{ pRed[i], pGreen[i], pBlue[i] }, false);
+		}
+	}
+
+	ColorRGB UnpackColor(uint32_t pixel, bool sRGBEncoding)
+	{
+		const uint8_t r{ static_cast<uint8_t>((pixel >> 16) & 0xFF) };
+		const uint8_t g{ static_cast<uint8_t>((pixel >> 8) & 0xFF) };
+		const uint8_t b{ static_cast<uint8_t>(pixel & 0xFF) };
+
+		if (sRGBEncoding)
+		{
+			const auto& lut{ GetSRGBToLinearTable() };
+			return ColorRGB{ lut[r], lut[g], lut[b] };
+		}
+
+		return ColorRGB{ r / 255.f, g / 255.f, b / 255.f };
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL_pixels.h>
+#include <cstdint>
+
+#include "ColorRGB.h"
+
+namespace dae
+{
+	// Native layout of the software back buffer, fixed at creation => 0xAARRGGBB
+	constexpr uint32_t BACK_BUFFER_PIXEL_FORMAT{ SDL_PIXELFORMAT_ARGB8888 };
+
+	inline uint32_t PackRGB(uint8_t r, uint8_t g, uint8_t b)
+	{
+		return 0xFF000000u | (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | static_cast<uint32_t>(b);
+	}
+
+	// Colors above one are scaled down by their max channel (same as ColorRGB::MaxToOne), negatives clamp to zero
+	uint32_t PackColor(const ColorRGB& color, bool sRGBEncoding = false);
+
+	// SIMD pack of a whole span of SoA float colors (8 pixels per step with AVX2, 4 with SSE2)
+	void PackColorSpan(const float* pRed, const float* pGreen, const float* pBlue, uint32_t* pOut, int count, bool sRGBEncoding = false);
+
+	ColorRGB UnpackColor(uint32_t pixel, bool sRGBEncoding = false);
+}
@@ -0,0 +1,126 @@
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+
+namespace dae
+{
+	std::atomic<uint32_t> Profiler::s_FrameIndex{ 0 };
+	std::atomic<bool> Profiler::s_IsEnabled{ true };
+
+	namespace
+	{
+		struct ThreadBuffer
+		{
+			uint32_t threadIndex{};
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<uint64_t> numEvents{ 0 }; // Total ever written, the ring index is numEvents % capacity
+			std::unique_ptr<Profiler::Event[]> pEvents{ std::make_unique<Profiler::Event[]>(Profiler::EVENTS_PER_THREAD) };
+		};
+
+		// Buffers are never freed, pool threads may exit before the trace is written
+		std::mutex g_RegistryMutex{};
+		std::vector<std::unique_ptr<ThreadBuffer>> g_ThreadBuffers{};
+
+		ThreadBuffer* RegisterThread()
+		{
+			const std::lock_guard lock{ g_RegistryMutex };
+
+			g_ThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+			g_ThreadBuffers.back()->threadIndex = static_cast<uint32_t>(g_ThreadBuffers.size() - 1);
+			return g_ThreadBuffers.back().get();
+		}
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			// Registry lock only on the first event of a thread
+			thread_local ThreadBuffer* pThreadBuffer{ RegisterThread() };
+			return *pThreadBuffer;
+		}
+	}
+
+	void Profiler::SetThreadName(const char* name)
+	{
+		GetThreadBuffer().name.store(name, std::memory_order_relaxed);
+	}
+
+	uint64_t Profiler::GetTimestamp()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void Profiler::Record(const char* name, uint64_t startTime, uint64_t endTime, uint32_t frameIndex)
+	{
+		ThreadBuffer& buffer{ GetThreadBuffer() };
+
+		// Single writer per buffer => relaxed load, release store publishes the event
+		const uint64_t eventIndex{ buffer.numEvents.load(std::memory_order_relaxed) };
+		buffer.pEvents[eventIndex & (EVENTS_PER_THREAD - 1)] = Event{ name, startTime, endTime, frameIndex };
+		buffer.numEvents.store(eventIndex + 1, std::memory_order_release);
+	}
+
+	bool Profiler::WriteChromeTrace(const std::string& filePath, uint32_t firstFrame, uint32_t lastFrame)
+	{
+		std::ofstream file(filePath);
+		if (!file)
+			return false;
+
+		const std::lock_guard lock{ g_RegistryMutex };
+
+		// Timestamps relative to the first exported event, Chrome wants microseconds
+		uint64_t baseTime{ UINT64_MAX };
+		auto forEachEvent = [&](auto&& eventFunction)
+			{
+				for (const auto& pBuffer : g_ThreadBuffers)
+				{
+					const uint64_t numEvents{ pBuffer->numEvents.load(std::memory_order_acquire) };
+					const uint64_t firstEvent{ numEvents > EVENTS_PER_THREAD ? numEvents - EVENTS_PER_THREAD : 0 };
+
+					for (uint64_t eventIndex{ firstEvent }; eventIndex < numEvents; ++eventIndex)
+					{
+						const Event& event{ pBuffer->pEvents[eventIndex & (EVENTS_PER_THREAD - 1)] };
+						if (event.frameIndex >= firstFrame && event.frameIndex <= lastFrame)
+							eventFunction(*pBuffer, event);
+					}
+				}
+			};
+
+		forEachEvent([&](const ThreadBuffer&, const Event& event) { baseTime = std::min(baseTime, event.startTime); });
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool isFirstEvent{ true };
+		for (const auto& pBuffer : g_ThreadBuffers)
+		{
+			file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << pBuffer->threadIndex
+				<< ",\"args\":{\"name\":\"";
+
+			if (const char* name{ pBuffer->name.load(std::memory_order_relaxed) })
+				file << name;
+			else
+				file << "Worker " << pBuffer->threadIndex;
+
+			file << "\"}}";
+			isFirstEvent = false;
+		}
+
+		forEachEvent([&](const ThreadBuffer& buffer, const Event& event)
+			{
+				file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer.threadIndex
+					<< ",\"ts\":" << (event.startTime - baseTime) / 1000.0
+					<< ",\"dur\":" << (event.endTime - event.startTime) / 1000.0
+					<< ",\"args\":{\"frame\":" << event.frameIndex << "}}";
+				isFirstEvent = false;
+			});
+
+		file << "\n]}\n";
+
+		return static_cast<bool>(file);
+	}
+}
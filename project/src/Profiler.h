@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace dae
+{
+	// Scoped CPU profiler - every thread writes into its own ring buffer, no locks on the hot path
+	// Only the newest EVENTS_PER_THREAD events of a thread are kept, older ones are overwritten
+	class Profiler final
+	{
+	public:
+		struct Event
+		{
+			const char* name{}; // String literal, never copied
+			uint64_t startTime{}; // ns
+			uint64_t endTime{}; // ns
+			uint32_t frameIndex{};
+		};
+
+		static constexpr uint32_t EVENTS_PER_THREAD{ 1 << 15 }; // Power of two => cheap wrap around
+
+		static void BeginFrame() { s_FrameIndex.fetch_add(1, std::memory_order_relaxed); };
+		static uint32_t GetFrameIndex() { return s_FrameIndex.load(std::memory_order_relaxed); };
+
+		// Recording can be paused at runtime, the scopes stay compiled in
+		static void SetEnabled(bool isEnabled) { s_IsEnabled.store(isEnabled, std::memory_order_relaxed); };
+		static bool IsEnabled() { return s_IsEnabled.load(std::memory_order_relaxed); };
+
+		static void SetThreadName(const char* name); // Shown in the trace, unnamed threads are "Worker N"
+
+		static uint64_t GetTimestamp(); // ns, monotonic
+		static void Record(const char* name, uint64_t startTime, uint64_t endTime, uint32_t frameIndex);
+
+		// Chrome / Perfetto trace event JSON of every event that began in [firstFrame, lastFrame]
+		// Call between frames - threads still recording may overwrite events while they are written
+		static bool WriteChromeTrace(const std::string& filePath, uint32_t firstFrame, uint32_t lastFrame);
+
+	private:
+		static std::atomic<uint32_t> s_FrameIndex;
+		static std::atomic<bool> s_IsEnabled;
+	};
+
+	class ProfileScope final
+	{
+	public:
+		explicit ProfileScope(const char* name) :
+			m_Name{ name },
+			m_FrameIndex{ Profiler::GetFrameIndex() },
+			m_StartTime{ Profiler::IsEnabled() ? Profiler::GetTimestamp() : 0 }
+		{
+		};
+		~ProfileScope()
+		{
+			if (m_StartTime != 0)
+				Profiler::Record(m_Name, m_StartTime, Profiler::GetTimestamp(), m_FrameIndex);
+		};
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope(ProfileScope&&) noexcept = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		ProfileScope& operator=(ProfileScope&&) noexcept = delete;
+
+	private:
+		const char* m_Name;
+		uint32_t m_FrameIndex;
+		uint64_t m_StartTime;
+	};
+}
+
+// DAE_PROFILER is set by CMake (DAE_PROFILER_ENABLED), without it every scope compiles to nothing
+#if defined(DAE_PROFILER)
+#define DAE_PROFILE_CONCAT_INNER(a, b) a##b
+#define DAE_PROFILE_CONCAT(a, b) DAE_PROFILE_CONCAT_INNER(a, b)
+#define DAE_PROFILE_SCOPE(name) const dae::ProfileScope DAE_PROFILE_CONCAT(profileScope, __LINE__){ name }
+#define DAE_PROFILE_FRAME() dae::Profiler::BeginFrame()
+#define DAE_PROFILE_THREAD(name) dae::Profiler::SetThreadName(name)
+#else
+#define DAE_PROFILE_SCOPE(name)
+#define DAE_PROFILE_FRAME()
+#define DAE_PROFILE_THREAD(name)
+#endif
@@ -0,0 +1,373 @@
+// Golden image regression - renders reference scenes headlessly with the software rasterizer and compares them
+// against stored images (per tile PSNR + max channel error) and stored frame time budgets
+// Usage: DualRasterizerRegression [--golden-dir <dir>] [--output <dir>] [--update] [--budget-scale <scale>]
+// Exit code 0 => every scene passed
+
+//External includes
+#include "SDL.h"
+#undef main
+
+//Standard includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cmath>
+#include <cstdlib>
+#include <charconv>
+
+//Project includes
+#include "Renderer.h"
+#include "Benchmark.h"
+
+using namespace dae;
+
+namespace
+{
+	// Fixed points on the benchmark timelines
+	struct ReferenceScene
+	{
+		const char* name{};
+		BenchmarkScenario scenario{};
+		float time{}; // s
+		uint32_t maxSubmeshVertices{}; // > 0 => the meshes are split into 16-bit submeshes (see Renderer::AddMesh)
+		bool isLodActive{ true }; // Same switch as --lod
+		SoftwareRasterizer::TransparencyMode transparencyMode{ SoftwareRasterizer::TransparencyMode::Sorted }; // Same switch as --transparency
+	};
+
+	constexpr std::array<ReferenceScene, 7> REFERENCE_SCENES{ {
+		{ "orbit", BenchmarkScenario::Orbit, 2.5f },
+		{ "orbit_oit", BenchmarkScenario::Orbit, 2.5f, 0, true, SoftwareRasterizer::TransparencyMode::WeightedBlendedOIT },
+		{ "fly_through", BenchmarkScenario::FlyThrough, 4.f },
+		{ "close_up", BenchmarkScenario::CloseUp, 1.f },
+		{ "many_instances", BenchmarkScenario::ManyInstances, 0.5f },
+		{ "many_instances_lod_off", BenchmarkScenario::ManyInstances, 0.5f, 0, false }, // Full detail instancing reference
+		{ "close_up_split_16bit", BenchmarkScenario::CloseUp, 1.f, 8192 } // Several submeshes with a base vertex each
+	} };
+
+	constexpr int SCENE_WIDTH{ 320 };
+	constexpr int SCENE_HEIGHT{ 240 };
+	constexpr int COMPARE_TILE_SIZE{ 32 };
+
+	constexpr int NUM_WARM_UP_FRAMES{ 2 };
+	constexpr int NUM_TIMED_FRAMES{ 9 };
+
+	// Written next to a new golden image, edit the .json to loosen or tighten a single scene
+	constexpr double DEFAULT_MIN_PSNR{ 40.0 }; // dB, per tile
+	constexpr int DEFAULT_MAX_CHANNEL_ERROR{ 64 }; // Per tile, a few pixels flipping on an edge stays below this
+	constexpr double BUDGET_HEADROOM{ 2.0 }; // New budgets are the measured median times this
+
+	struct Limits
+	{
+		double minPSNR{ DEFAULT_MIN_PSNR };
+		int maxChannelError{ DEFAULT_MAX_CHANNEL_ERROR };
+		double frameBudget{}; // ms
+	};
+
+	struct ImageComparison
+	{
+		double worstPSNR{ INFINITY }; // dB, lowest of all tiles
+		int worstPSNRTile{ -1 };
+		int maxChannelError{};
+		int maxChannelErrorTile{ -1 };
+	};
+
+	// --- FILES ---
+	bool WritePPM(const std::filesystem::path& filePath, const std::vector<uint32_t>& pixels, int width, int height)
+	{
+		std::ofstream file(filePath, std::ios::binary);
+		if (!file)
+			return false;
+
+		file << "P6\n" << width << " " << height << "\n255\n";
+		for (uint32_t pixel : pixels)
+		{
+			const char rgb[3]{ static_cast<char>((pixel >> 16) & 0xFF), static_cast<char>((pixel >> 8) & 0xFF), static_cast<char>(pixel & 0xFF) };
+			file.write(rgb, 3);
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	bool ReadPPM(const std::filesystem::path& filePath, std::vector<uint32_t>& pixels, int& width, int& height)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+			return false;
+
+		std::string magic{};
+		int maxValue{};
+		file >> magic >> width >> height >> maxValue;
+		file.get(); // Single whitespace before the data
+
+		if (magic != "P6" || maxValue != 255 || width <= 0 || height <= 0)
+			return false;
+
+		pixels.resize(static_cast<size_t>(width) * height);
+		for (uint32_t& pixel : pixels)
+		{
+			unsigned char rgb[3]{};
+			file.read(reinterpret_cast<char*>(rgb), 3);
+			pixel = (rgb[0] << 16) | (rgb[1] << 8) | rgb[2];
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	// Flat JSON object with numeric values only, missing keys keep their default
+	double ReadNumber(const std::string& text, const std::string& key, double defaultValue)
+	{
+		const size_t keyPosition{ text.find("\"" + key + "\"") };
+		if (keyPosition == std::string::npos)
+			return defaultValue;
+
+		const size_t colonPosition{ text.find(':', keyPosition) };
+		if (colonPosition == std::string::npos)
+			return defaultValue;
+
+		return std::strtod(text.c_str() + colonPosition + 1, nullptr);
+	}
+
+	bool ReadLimits(const std::filesystem::path& filePath, Limits& limits)
+	{
+		std::ifstream file(filePath);
+		if (!file)
+			return false;
+
+		std::stringstream text{};
+		text << file.rdbuf();
+
+		limits.minPSNR = ReadNumber(text.str(), "min_psnr_db", DEFAULT_MIN_PSNR);
+		limits.maxChannelError = static_cast<int>(ReadNumber(text.str(), "max_channel_error", DEFAULT_MAX_CHANNEL_ERROR));
+		limits.frameBudget = ReadNumber(text.str(), "frame_budget_ms", 0.0);
+		return true;
+	}
+
+	bool WriteLimits(const std::filesystem::path& filePath, const Limits& limits)
+	{
+		std::ofstream file(filePath);
+		if (!file)
+			return false;
+
+		file << "{\n";
+		file << "  \"min_psnr_db\": " << limits.minPSNR << ",\n";
+		file << "  \"max_channel_error\": " << limits.maxChannelError << ",\n";
+		file << "  \"frame_budget_ms\": " << limits.frameBudget << "\n";
+		file << "}\n";
+
+		return static_cast<bool>(file);
+	}
+
+	// --- COMPARISON ---
+	ImageComparison CompareImages(const std::vector<uint32_t>& actual, const std::vector<uint32_t>& golden, int width, int height)
+	{
+		ImageComparison comparison{};
+
+		const int numTilesX{ (width + COMPARE_TILE_SIZE - 1) / COMPARE_TILE_SIZE };
+		const int numTilesY{ (height + COMPARE_TILE_SIZE - 1) / COMPARE_TILE_SIZE };
+
+		for (int tileIndex{}; tileIndex < numTilesX * numTilesY; ++tileIndex)
+		{
+			const int minX{ (tileIndex % numTilesX) * COMPARE_TILE_SIZE };
+			const int minY{ (tileIndex / numTilesX) * COMPARE_TILE_SIZE };
+			const int maxX{ std::min(minX + COMPARE_TILE_SIZE, width) };
+			const int maxY{ std::min(minY + COMPARE_TILE_SIZE, height) };
+
+			double squaredErrorSum{};
+			int tileMaxError{};
+
+			for (int py{ minY }; py < maxY; ++py)
+			{
+				for (int px{ minX }; px < maxX; ++px)
+				{
+					const int pixelNr{ GetPixelNumber(px, py, width) };
+					for (int shift : { 16, 8, 0 })
+					{
+						const int error{ std::abs(static_cast<int>((actual[pixelNr] >> shift) & 0xFF) - static_cast<int>((golden[pixelNr] >> shift) & 0xFF)) };
+						squaredErrorSum += error * error;
+						tileMaxError = std::max(tileMaxError, error);
+					}
+				}
+			}
+
+			const double meanSquaredError{ squaredErrorSum / ((maxX - minX) * (maxY - minY) * 3) };
+			const double psnr{ meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : INFINITY };
+
+			if (psnr < comparison.worstPSNR)
+			{
+				comparison.worstPSNR = psnr;
+				comparison.worstPSNRTile = tileIndex;
+			}
+
+			if (tileMaxError > comparison.maxChannelError)
+			{
+				comparison.maxChannelError = tileMaxError;
+				comparison.maxChannelErrorTile = tileIndex;
+			}
+		}
+
+		return comparison;
+	}
+
+	// Absolute difference, scaled up so small errors are visible
+	std::vector<uint32_t> CreateDifferenceImage(const std::vector<uint32_t>& actual, const std::vector<uint32_t>& golden)
+	{
+		std::vector<uint32_t> difference(actual.size());
+		for (size_t i{}; i < actual.size(); ++i)
+		{
+			for (int shift : { 16, 8, 0 })
+			{
+				const int error{ std::abs(static_cast<int>((actual[i] >> shift) & 0xFF) - static_cast<int>((golden[i] >> shift) & 0xFF)) };
+				difference[i] |= static_cast<uint32_t>(std::min(255, error * 8)) << shift;
+			}
+		}
+		return difference;
+	}
+
+	// Median of the timed frames, ms - the last frame stays in the renderer
+	double RenderScene(Renderer& renderer, const ReferenceScene& scene)
+	{
+		renderer.ApplyBenchmarkFrame(EvaluateScenario(scene.scenario, scene.time));
+
+		std::vector<double> frameTimes{};
+		for (int frame{ -NUM_WARM_UP_FRAMES }; frame < NUM_TIMED_FRAMES; ++frame)
+		{
+			const auto frameStart{ std::chrono::steady_clock::now() };
+			renderer.Render();
+			const auto frameEnd{ std::chrono::steady_clock::now() };
+
+			if (frame >= 0)
+				frameTimes.emplace_back(std::chrono::duration<double, std::milli>{ frameEnd - frameStart }.count());
+		}
+
+		std::sort(frameTimes.begin(), frameTimes.end());
+		return frameTimes[frameTimes.size() / 2];
+	}
+}
+
+int main(int argc, char* args[])
+{
+	std::filesystem::path goldenDirectory{ DAE_GOLDEN_DIR };
+	std::filesystem::path outputDirectory{ "regression" };
+	bool isUpdating{ false };
+	double budgetScale{ 1.0 }; // Slower machines scale the stored budgets up, 0 => no budgets
+
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ args[i] };
+		const bool hasValue{ i + 1 < argc };
+
+		if (argument == "--golden-dir" && hasValue)
+			goldenDirectory = args[++i];
+		else if (argument == "--output" && hasValue)
+			outputDirectory = args[++i];
+		else if (argument == "--update")
+			isUpdating = true;
+		else if (argument == "--budget-scale" && hasValue)
+		{
+			// A typo keeps the stored budgets instead of throwing
+			const std::string scale{ args[++i] };
+			double value{};
+			const auto [pLast, error] { std::from_chars(scale.data(), scale.data() + scale.size(), value) };
+			if (error == std::errc{} && pLast == scale.data() + scale.size())
+				budgetScale = std::max(0.0, value);
+			else
+				std::cout << "Invalid budget scale " << scale << ", using " << budgetScale << '\n';
+		}
+		else
+			std::cout << "Unknown argument: " << argument << '\n';
+	}
+
+	SDL_Init(0);
+
+	std::filesystem::create_directories(isUpdating ? goldenDirectory : outputDirectory);
+
+	int numFailures{};
+	for (const ReferenceScene& scene : REFERENCE_SCENES)
+	{
+		// Meshes are prepared when they are added => a renderer per scene
+		Renderer renderer{ SCENE_WIDTH, SCENE_HEIGHT, RasterizerMode::Software, VertexFormat::Float32, scene.maxSubmeshVertices };
+		renderer.SetLodActive(scene.isLodActive);
+		renderer.SetTransparencyMode(scene.transparencyMode);
+
+		const double frameTime{ RenderScene(renderer, scene) };
+		const std::vector<uint32_t> actual{ renderer.GetFramePixels() };
+
+		const std::string baseName{ std::string{ scene.name } + "_" + std::to_string(SCENE_WIDTH) + "x" + std::to_string(SCENE_HEIGHT) };
+		const std::filesystem::path goldenImagePath{ goldenDirectory / (baseName + ".ppm") };
+		const std::filesystem::path limitsPath{ goldenDirectory / (baseName + ".json") };
+
+		if (isUpdating)
+		{
+			// Keep hand edited tolerances, only the budget follows this machine
+			Limits limits{};
+			ReadLimits(limitsPath, limits);
+			limits.frameBudget = std::ceil(frameTime * BUDGET_HEADROOM * 10.0) / 10.0;
+
+			if (WritePPM(goldenImagePath, actual, SCENE_WIDTH, SCENE_HEIGHT) && WriteLimits(limitsPath, limits))
+				std::cout << "UPDATED " << baseName << " | " << frameTime << " ms, budget " << limits.frameBudget << " ms\n";
+			else
+			{
+				std::cout << "FAILED to write " << goldenImagePath.string() << '\n';
+				++numFailures;
+			}
+			continue;
+		}
+
+		std::vector<uint32_t> golden{};
+		int goldenWidth{};
+		int goldenHeight{};
+		Limits limits{};
+
+		if (!ReadPPM(goldenImagePath, golden, goldenWidth, goldenHeight) || !ReadLimits(limitsPath, limits))
+		{
+			std::cout << "FAIL " << baseName << " | missing golden image or limits in " << goldenDirectory.string() << " (run with --update)\n";
+			++numFailures;
+			continue;
+		}
+
+		if (goldenWidth != SCENE_WIDTH || goldenHeight != SCENE_HEIGHT)
+		{
+			std::cout << "FAIL " << baseName << " | golden image is " << goldenWidth << "x" << goldenHeight << '\n';
+			++numFailures;
+			continue;
+		}
+
+		const ImageComparison comparison{ CompareImages(actual, golden, SCENE_WIDTH, SCENE_HEIGHT) };
+		const double frameBudget{ limits.frameBudget * budgetScale };
+
+		const bool isImageMatching{ comparison.worstPSNR >= limits.minPSNR && comparison.maxChannelError <= limits.maxChannelError };
+		const bool isWithinBudget{ frameBudget <= 0.0 || frameTime <= frameBudget };
+
+		const int numTilesX{ (SCENE_WIDTH + COMPARE_TILE_SIZE - 1) / COMPARE_TILE_SIZE };
+		std::cout << (isImageMatching && isWithinBudget ? "PASS " : "FAIL ") << baseName
+			<< " | worst tile PSNR " << comparison.worstPSNR << " dB";
+		if (comparison.worstPSNRTile >= 0)
+			std::cout << " (tile " << comparison.worstPSNRTile % numTilesX << "," << comparison.worstPSNRTile / numTilesX << ")";
+		std::cout << " min " << limits.minPSNR
+			<< " | max channel error " << comparison.maxChannelError << " max " << limits.maxChannelError
+			<< " | " << frameTime << " ms budget " << frameBudget << " ms\n";
+
+		if (!isImageMatching)
+		{
+			// Evidence for the failure, next to each other in the output directory
+			WritePPM(outputDirectory / (baseName + "_actual.ppm"), actual, SCENE_WIDTH, SCENE_HEIGHT);
+			WritePPM(outputDirectory / (baseName + "_diff.ppm"), CreateDifferenceImage(actual, golden), SCENE_WIDTH, SCENE_HEIGHT);
+		}
+
+		if (!isImageMatching || !isWithinBudget)
+			++numFailures;
+	}
+
+	SDL_Quit();
+
+	if (numFailures > 0)
+		std::cout << numFailures << " of " << REFERENCE_SCENES.size() << " scenes failed\n";
+
+	return numFailures > 0 ? 1 : 0;
+}
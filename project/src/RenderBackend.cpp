@@ -0,0 +1,112 @@
+#include "RenderBackend.h"
+
+namespace dae
+{
+	BackendMesh UploadMesh(RenderBackend& backend, const Mesh& mesh)
+	{
+		BackendMesh backendMesh{};
+		backendMesh.pMesh = &mesh;
+
+		if (mesh.HasMeshlets())
+		{
+			backendMesh.meshletBuffer = backend.CreateMeshletBuffer(mesh.GetMeshlets(), mesh.GetVertexFormat());
+		}
+
+		// The meshlets hold their own vertices
+		if (backendMesh.meshletBuffer == INVALID_HANDLE)
+		{
+			backendMesh.vertexBuffer = mesh.GetVertexFormat() == VertexFormat::Quantized ?
+				backend.CreateVertexBuffer(QuantizeVertices(mesh.GetVertices())) : backend.CreateVertexBuffer(mesh.GetVertices());
+			backendMesh.indexBuffer = mesh.GetIndexFormat() == IndexFormat::UInt16 ?
+				backend.CreateIndexBuffer(mesh.GetIndices16()) : backend.CreateIndexBuffer(mesh.GetIndices32());
+		}
+
+		backendMesh.textures[static_cast<int>(TextureSlot::Diffuse)] = backend.CreateTexture(mesh.GetDiffuseTexture());
+		backendMesh.textures[static_cast<int>(TextureSlot::Normal)] = backend.CreateTexture(mesh.GetNormalTexture());
+		backendMesh.textures[static_cast<int>(TextureSlot::Specular)] = backend.CreateTexture(mesh.GetSpecularTexture());
+		backendMesh.textures[static_cast<int>(TextureSlot::Gloss)] = backend.CreateTexture(mesh.GetGlossTexture());
+
+		// Levels of detail follow the choice of the full detail mesh, meshlets or indices into its vertex buffer
+		for (size_t lod{ 1 }; lod < mesh.GetLodCount(); ++lod)
+		{
+			const Mesh::Lod& meshLod{ mesh.GetLod(lod) };
+			BackendLod& backendLod{ backendMesh.lods.emplace_back() };
+
+			if (backendMesh.meshletBuffer != INVALID_HANDLE)
+				backendLod.meshletBuffer = backend.CreateMeshletBuffer(meshLod.meshlets, mesh.GetVertexFormat());
+			else
+				backendLod.indexBuffer = meshLod.indexFormat == IndexFormat::UInt16 ?
+					backend.CreateIndexBuffer(meshLod.indices16) : backend.CreateIndexBuffer(meshLod.indices32);
+		}
+
+		return backendMesh;
+	}
+
+	void DrawMesh(RenderBackend& backend, const BackendMesh& backendMesh)
+	{
+		DrawMesh(backend, backendMesh, backendMesh.pMesh->GetWorldMatrix());
+	}
+
+	void DrawMesh(RenderBackend& backend, const BackendMesh& backendMesh, const Matrix& worldMatrix)
+	{
+		const Mesh& mesh{ *backendMesh.pMesh };
+
+		for (int slot{}; slot < TEXTURE_SLOT_COUNT; ++slot)
+		{
+			backend.SetTexture(static_cast<TextureSlot>(slot), backendMesh.textures[slot]);
+		}
+
+		backend.SetWorldMatrix(worldMatrix);
+
+		if (backendMesh.meshletBuffer != INVALID_HANDLE)
+		{
+			backend.DrawMeshlets(backendMesh.meshletBuffer);
+			return;
+		}
+
+		backend.SetVertexBuffer(backendMesh.vertexBuffer);
+		backend.SetIndexBuffer(backendMesh.indexBuffer, mesh.GetMeshPrimitiveTopology());
+		for (const Mesh::Submesh& submesh : mesh.GetSubmeshes())
+		{
+			backend.DrawIndexed(submesh.indexCount, submesh.startIndex, submesh.baseVertex);
+		}
+	}
+
+	void DrawMeshInstanced(RenderBackend& backend, const BackendMesh& backendMesh, const Matrix* pWorldMatrices, uint32_t instanceCount, size_t lod)
+	{
+		const Mesh& mesh{ *backendMesh.pMesh };
+
+		for (int slot{}; slot < TEXTURE_SLOT_COUNT; ++slot)
+		{
+			backend.SetTexture(static_cast<TextureSlot>(slot), backendMesh.textures[slot]);
+		}
+
+		backend.SetInstanceTransforms(pWorldMatrices, instanceCount);
+
+		if (lod > 0)
+		{
+			const BackendLod& backendLod{ backendMesh.lods[lod - 1] };
+			if (backendLod.meshletBuffer != INVALID_HANDLE)
+			{
+				backend.DrawMeshletsInstanced(backendLod.meshletBuffer, instanceCount);
+				return;
+			}
+
+			// Absolute indices => a single draw, even for meshes split into submeshes
+			backend.SetVertexBuffer(backendMesh.vertexBuffer);
+			backend.SetIndexBuffer(backendLod.indexBuffer, PrimitiveTopology::TriangleList);
+			backend.DrawIndexedInstanced(static_cast<uint32_t>(mesh.GetLodTriangleCount(lod) * 3), instanceCount, 0, 0);
+			return;
+		}
+
+		if (backendMesh.meshletBuffer != INVALID_HANDLE)
+		{
+			backend.DrawMeshletsInstanced(backendMesh.meshletBuffer, instanceCount);
+			return;
+		}
+
+			backend.SetVertexBuffer(backendMesh.vertexBuffer);
+		backend.SetIndexBuffer(backendMesh.indexBuffer, mesh.GetMeshPrimitiveTopology());
+		backend.DrawSubmeshesInstanced(mesh.GetSubmeshes(), instanceCount);
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "Mesh.h"
+
+namespace dae
+{
+	// Opaque ids handed out by a backend, 0 is never a valid resource
+	using BufferHandle = uint32_t;
+	using TextureHandle = uint32_t;
+	constexpr uint32_t INVALID_HANDLE{ 0 };
+
+	enum class SamplerType
+	{
+		Point = 0,
+		Linear = 1,
+		Anisotropic = 2
+	};
+
+	enum class BlendMode
+	{
+		Opaque,
+		Transparent // Depth test, no depth write, blended after every opaque draw
+	};
+
+	enum class TextureSlot
+	{
+		Diffuse,
+		Normal,
+		Specular,
+		Gloss,
+		Count
+	};
+	constexpr int TEXTURE_SLOT_COUNT{ static_cast<int>(TextureSlot::Count) };
+
+	struct PipelineState
+	{
+		BlendMode blendMode{ BlendMode::Opaque };
+		CullMode cullMode{ CullMode::Back };
+		SamplerType samplerType{ SamplerType::Point };
+
+		bool operator==(const PipelineState&) const = default;
+	};
+
+	// Resources, pipeline state and draws - implemented by SoftwareBackend, D3D11Backend and NullBackend
+	// Bound state stays bound until it is set again, like the D3D11 immediate context
+	class RenderBackend
+	{
+	public:
+		RenderBackend() = default;
+		virtual ~RenderBackend() = default;
+
+		RenderBackend(const RenderBackend&) = delete;
+		RenderBackend(RenderBackend&&) noexcept = delete;
+		RenderBackend& operator=(const RenderBackend&) = delete;
+		RenderBackend& operator=(RenderBackend&&) noexcept = delete;
+
+		virtual const char* GetName() const = 0;
+
+		// Resources - vertices are copied, the backend may keep pointers to index data and textures, they have to outlive the backend
+		virtual BufferHandle CreateVertexBuffer(const std::vector<VertexIn>& vertices) = 0;
+		virtual BufferHandle CreateVertexBuffer(const QuantizedVertexBuffer& vertices) = 0;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint16_t>& indices) = 0;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint32_t>& indices) = 0;
+		virtual TextureHandle CreateTexture(const Texture* pTexture) = 0;
+
+		// Meshlets are optional - backends that cull per cluster return a handle, the others INVALID_HANDLE
+		// Like vertices the meshlet vertices are copied in the given format, the meshlet mesh itself has to outlive the backend
+		virtual BufferHandle CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat) = 0;
+
+		// Frame
+		virtual void BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos) = 0;
+		virtual void EndFrame() = 0;
+
+		// State
+		virtual void SetPipelineState(const PipelineState& pipelineState) = 0;
+		virtual void SetVertexBuffer(BufferHandle vertexBuffer) = 0;
+		virtual void SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology) = 0;
+		virtual void SetTexture(TextureSlot slot, TextureHandle texture) = 0;
+		virtual void SetWorldMatrix(const Matrix& worldMatrix) = 0;
+
+		// World matrix per instance of the instanced draws, they ignore the bound world matrix
+		// pWorldMatrices has to stay valid until the last draw using it returns, backends copy what they keep (dynamic buffer)
+		virtual void SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount) = 0;
+
+		// Draws - baseVertex is added to every index, the index width is the one of the bound index buffer
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+		virtual void DrawMeshlets(BufferHandle meshletBuffer) = 0; // Every meshlet, with the bound pipeline state, textures and world matrix
+
+		// The first instanceCount instance transforms, same vertex and index data for every instance
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex) = 0;
+		virtual void DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount) = 0; // Every submesh of the bound buffers
+		virtual void DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount) = 0;
+	};
+
+	// A simplified level of a mesh (see Mesh::BuildLods), drawn with the vertex buffer and textures of the mesh
+	struct BackendLod
+	{
+		BufferHandle indexBuffer{ INVALID_HANDLE };
+		BufferHandle meshletBuffer{ INVALID_HANDLE }; // Replaces the index buffer when valid
+	};
+
+	// A Mesh uploaded to one backend
+	struct BackendMesh
+	{
+		const Mesh* pMesh{};
+		BufferHandle vertexBuffer{ INVALID_HANDLE };
+		BufferHandle indexBuffer{ INVALID_HANDLE };
+		BufferHandle meshletBuffer{ INVALID_HANDLE }; // Replaces the vertex and index buffer when valid
+		std::array<TextureHandle, TEXTURE_SLOT_COUNT> textures{};
+		std::vector<BackendLod> lods{}; // Level 1 and up, level 0 are the buffers above
+	};
+
+	BackendMesh UploadMesh(RenderBackend& backend, const Mesh& mesh);
+	void DrawMesh(RenderBackend& backend, const BackendMesh& backendMesh);
+	void DrawMesh(RenderBackend& backend, const BackendMesh& backendMesh, const Matrix& worldMatrix);
+	void DrawMeshInstanced(RenderBackend& backend, const BackendMesh& backendMesh, const Matrix* pWorldMatrices, uint32_t instanceCount, size_t lod = 0);
+}
@@ -4,117 +4,205 @@
 
 // Standard includes
 #include <iostream>
+#include <execution>
+#include <numeric>
+#include <chrono>
+#include <fstream>
 
 //Project includes
 #include "Renderer.h"
 
 #include "Utils.h"
-#include "Effect.h"
-
-#define SAFE_RELEASE(p) \
-if (p) {p->Release(); p = nullptr; }
+#include "Profiler.h"
 
 using namespace dae;
 
-Renderer::Renderer(SDL_Window* pWindow) :
+Renderer::Renderer(SDL_Window* pWindow, VertexFormat vertexFormat, uint32_t maxSubmeshVertices) :
+#if defined(DAE_D3D11)
+	Renderer(pWindow, 0, 0, RasterizerMode::Hardware, vertexFormat, maxSubmeshVertices)
+#else
+	Renderer(pWindow, 0, 0, RasterizerMode::Software, vertexFormat, maxSubmeshVertices)
+#endif
+{
+}
+
+Renderer::Renderer(int width, int height, RasterizerMode rasterizerMode, VertexFormat vertexFormat, uint32_t maxSubmeshVertices) :
+	Renderer(nullptr, width, height, rasterizerMode == RasterizerMode::Null ? RasterizerMode::Null : RasterizerMode::Software, vertexFormat, maxSubmeshVertices)
+{
+}
+
+Renderer::Renderer(SDL_Window* pWindow, int width, int height, RasterizerMode rasterizerMode, VertexFormat vertexFormat, uint32_t maxSubmeshVertices) :
 	m_pWindow(pWindow),
+	m_IsHeadless{ pWindow == nullptr },
+	m_Width{ width },
+	m_Height{ height },
+	m_VertexFormat{ vertexFormat },
 	m_RotationFrozen{ true },
-	m_CurrentRasterizerMode{ RasterizerMode::Hardware },
+	m_CurrentRasterizerMode{ rasterizerMode },
 	m_UniformClearColorActive{ false },
 	m_CurrentCullMode{ CullMode::Back },
-	m_ShowFireMesh{ m_CurrentRasterizerMode == RasterizerMode::Hardware },
+	m_ShowFireMesh{ true },
+	m_OcclusionCullingActive{ true },
+	m_LodActive{ true },
 	m_CurrentSamplerType{ SamplerType::Point },
 	m_CurrentLightingMode{ LightingMode::Combined },
 	m_ShowNormalMap{ true },
 	m_CurrentPixelColorState{ PixelColorState::FinalColor },
-	m_ShowBoundingBox{ false }
+	m_ShowBoundingBox{ false },
+	m_SRGBEncodingActive{ false },
+	m_CurrentTransparencyMode{ TransparencyMode::Sorted },
+	m_ClusterCullingActive{ true }
 {
 	// Initialize
-	SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+	if (!m_IsHeadless)
+	{
+		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+	}
 
 	// --- SOFTWARE ---
 	// Create Buffers
-	m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-	m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+	m_pFrontBuffer = m_IsHeadless ? nullptr : SDL_GetWindowSurface(pWindow);
+	m_pBackBuffer = SDL_CreateRGBSurfaceWithFormat(0, m_Width, m_Height, 32, BACK_BUFFER_PIXEL_FORMAT); // Fixed layout, pixels are packed directly
+	m_pSoftwareBackend = std::make_unique<SoftwareBackend>(m_Width, m_Height);
+	m_pNullBackend = std::make_unique<NullBackend>();
+	m_pOcclusionBuffer = std::make_unique<OcclusionBuffer>(m_Width, m_Height);
 
-	m_pDepthBufferPixels = std::make_unique<float[]>(m_Width * m_Height);
-	std::fill_n(m_pDepthBufferPixels.get(), m_Width * m_Height, std::numeric_limits<float>::max()); // Depth buffer elements are initalized with float max
+	m_IsDirectPresentSupported = IsDirectPresentSupported();
+	m_CurrentPresentMode = m_IsDirectPresentSupported ? PresentMode::Direct : PresentMode::Blit;
 
 	// Initialize DirectX pipeline
-	const HRESULT result = InitializeDirectX();
-	if (result == S_OK)
+#if defined(DAE_D3D11)
+	if (m_IsHeadless)
+	{
+		std::cout << "Headless mode, DirectX is skipped\n";
+	}
+	else if (m_pD3D11Backend = std::make_unique<D3D11Backend>(pWindow, m_Width, m_Height); m_pD3D11Backend->IsInitialized())
 	{
 		m_IsDXInitialized = true;
 
-		CreateSamplerStates(m_pDevice);
-
 		std::cout << "DirectX is initialized and ready!\n";
 	}
 	else
 	{
 		std::cout << "DirectX initialization failed!\n";
 	}
+#else
+	std::cout << "Built without DirectX 11, software rasterizer only\n";
+#endif
+
+	// Meshes are uploaded by AddMesh to every backend of a scene
+	m_SoftwareScene.pBackend = m_pSoftwareBackend.get();
+	m_NullScene.pBackend = m_pNullBackend.get();
+#if defined(DAE_D3D11)
+	// GPU copies, only with a device
+	if (m_IsDXInitialized)
+	{
+		m_D3D11Scene.pBackend = m_pD3D11Backend.get();
+	}
+#endif
 	
-	std::wcout << L"\n[Key Bindings - SHARED] \n [F1]  Toggle Rasterizer Mode(HARDWARE / SOFTWARE) \n [F2]  Toggle Vehicle Rotation(ON / OFF) \n [F9]  Cycle CullMode(BACK / FRONT / NONE) \n";
-	std::wcout << L" [F10] Toggle Uniform ClearColor(ON / OFF) \n [F11] Toggle Print FPS(ON / OFF) \n\n[Key Bindings - HARDWARE] \n [F3] Toggle FireFX(ON / OFF) \n";
+	std::wcout << L"\n[Key Bindings - SHARED] \n [F1]  Cycle Rasterizer Mode(HARDWARE / SOFTWARE / NULL) \n [F2]  Toggle Vehicle Rotation(ON / OFF) \n [F3]  Toggle FireFX(ON / OFF) \n [F9]  Cycle CullMode(BACK / FRONT / NONE) \n";
+	std::wcout << L" [F10] Toggle Uniform ClearColor(ON / OFF) \n [F11] Toggle Print FPS + Pipeline Statistics(ON / OFF) \n [F12] Write CPU Trace(last 60 frames) \n";
+	std::wcout << L" [O]   Toggle Occlusion Culling(ON / OFF) \n [L]   Toggle Level Of Detail(ON / OFF) \n [MMB] Pick Mesh Under Cursor \n\n[Key Bindings - HARDWARE] \n";
 	std::wcout << L" [F4] Cycle Sampler State(POINT / LINEAR / ANISOTROPIC) \n\n[Key Bindings - SOFTWARE] \n [F5] Cycle Shading Mode(COMBINED / OBSERVED_AREA / DIFFUSE / SPECULAR) \n";
-	std::wcout << L" [F6] Toggle NormalMap(ON / OFF)\n [F7] Toggle DepthBuffer Visualization(ON / OFF) \n [F8] Toggle BoundingBox Visualization(ON / OFF)\n\n";
+	std::wcout << L" [F6] Toggle NormalMap(ON / OFF)\n [F7] Cycle Pixel Visualization(FINAL_COLOR / DEPTH_BUFFER / OVERDRAW / TILE_SHADING_TIME / TILE_TRIANGLES) \n [F8] Toggle BoundingBox Visualization(ON / OFF)\n";
+	std::wcout << L" [T]  Toggle Transparency Mode(SORTED / WEIGHTED_BLENDED_OIT)\n [B]  Benchmark Transparency Modes\n [G]  Toggle sRGB Encoding(ON / OFF)\n [P]  Toggle Present Mode(DIRECT / BLIT)\n [F]  Cycle Frames In Flight(1 / 2 / 3)\n";
+	std::wcout << L" [C]  Toggle Cluster Culling(ON / OFF)\n\n";
 
 
 	m_Camera.Initialize(45.f, { 0.f, 0.f, 0.f }, 0.1f, 100.f);
 
 	// Initial Mesh costructor doesn't care about Software or Hardware states
-	m_OpaqueMeshes.reserve(2);
-	m_OpaqueMeshes.emplace_back(std::make_unique<Mesh<OpaqueEffect>>(
-		m_pDevice,
+	auto pVehicleMesh{ std::make_unique<Mesh>(
 		"resources/vehicle.obj",
 		PrimitiveTopology::TriangleList,
 		"resources/vehicle_diffuse.png",
 		"resources/vehicle_normal.png",
 		"resources/vehicle_specular.png",
 		"resources/vehicle_gloss.png"
-	));
-	m_OpaqueMeshes[0]->Translate({ 0.f, 0.f, 50.f });
+	) };
+	pVehicleMesh->Translate({ 0.f, 0.f, 50.f });
+	AddMesh(std::move(pVehicleMesh), BlendMode::Opaque, maxSubmeshVertices);
 
-	m_TransparentMeshes.reserve(1);
-	m_TransparentMeshes.emplace_back(std::make_unique<Mesh<TransparencyEffect>>(
-		m_pDevice,
+	auto pFireMesh{ std::make_unique<Mesh>(
 		"resources/fireFX.obj",
 		PrimitiveTopology::TriangleList,
-		"resources/fireFX_diffuse.png"));
-	m_TransparentMeshes[0]->Translate({ 0.f, 0.f, 50.f });
+		"resources/fireFX_diffuse.png") };
+	pFireMesh->Translate({ 0.f, 0.f, 50.f });
+	AddMesh(std::move(pFireMesh), BlendMode::Transparent, maxSubmeshVertices);
+
+	// Vertex buffers of every backend use the same layout, index widths are picked per mesh
+	size_t numVertices{};
+	size_t numIndexBytes{};
+	size_t num16BitMeshes{};
+	size_t numSubmeshes{};
+	size_t numDuplicatedVertices{};
+	size_t numMeshlets{};
+	size_t numMeshletTriangles{};
+	size_t numOccluderTriangles{};
+	size_t numOpaqueMeshes{};
+	size_t numLods{};
+	size_t numTriangles{};
+	size_t numCoarsestTriangles{};
+	for (const SceneMesh& sceneMesh : m_SceneMeshes)
+	{
+		const Mesh& mesh{ *sceneMesh.pMesh };
+		numVertices += mesh.GetVertices().size();
+
+		const bool is16Bit{ mesh.GetIndexFormat() == IndexFormat::UInt16 };
+		numIndexBytes += mesh.GetIndexCount() * (is16Bit ? sizeof(uint16_t) : sizeof(uint32_t));
+		num16BitMeshes += is16Bit ? 1 : 0;
+		numSubmeshes += mesh.GetSubmeshes().size();
+		numDuplicatedVertices += mesh.GetDuplicatedVertexCount();
+
+		numMeshlets += mesh.GetMeshlets().meshlets.size();
+		numMeshletTriangles += mesh.GetMeshlets().GetTriangleCount();
+
+		numOccluderTriangles += mesh.GetOccluderTriangles().size() / 3;
+		numLods += mesh.GetLodCount() - 1;
+		numCoarsestTriangles += mesh.GetLodTriangleCount(mesh.GetLodCount() - 1);
+		numTriangles += mesh.GetTriangleCount();
+		numOpaqueMeshes += sceneMesh.blendMode == BlendMode::Opaque ? 1 : 0;
+	}
+	std::cout << "Vertex format " << GetVertexFormatName(vertexFormat) << ": " << GetVertexSize(vertexFormat) << " bytes per vertex, "
+		<< numVertices * GetVertexSize(vertexFormat) / 1024 << " KiB of vertex data\n";
+	std::cout << "Index buffers: " << num16BitMeshes << "/" << m_SceneMeshes.size() << " meshes with 16-bit indices, "
+		<< numIndexBytes / 1024 << " KiB of index data, " << numSubmeshes << " submeshes (" << numDuplicatedVertices << " vertices duplicated by splits)\n";
+	std::cout << "Occluders: " << numOccluderTriangles << " triangles over " << numOpaqueMeshes << " opaque meshes\n";
+	std::cout << "Levels of detail: " << numLods << " below full detail, " << numTriangles << " triangles -> "
+		<< numCoarsestTriangles << " at the coarsest levels\n";
+	std::cout << "Meshlets: " << numMeshlets << " (" << (numMeshlets > 0 ? numMeshletTriangles / numMeshlets : 0) << " triangles on average)\n";
 }
 
 Renderer::~Renderer()
 {
-	SDL_DestroyWindow(m_pWindow);
-	m_pWindow = nullptr;
-
-	// --- HARDWARE ---
-	// 1. Unbind Render Target view and Depth Stencil view from Device Context
-	if (m_pDeviceContext)
+	// --- SOFTWARE ---
+	// Render returns only once the raster thread is done, it is idle here
+	if (m_RasterThread.joinable())
 	{
-		m_pDeviceContext->ClearState();
-		m_pDeviceContext->Flush();
+		m_IsRasterThreadRunning = false;
+		m_IsRasterPending = true;
+		m_IsRasterPending.notify_one(); // Wake up to exit
+		m_RasterThread.join();
 	}
 
-	// 2. Release Views
-	SAFE_RELEASE(m_pDepthStencilView);
-	SAFE_RELEASE(m_pRenderTargetView);
-
-	// 3. Release Buffers
-	SAFE_RELEASE(m_pDepthStencilBuffer);
-	SAFE_RELEASE(m_pRenderTargetBuffer);
+	for (auto& pFrameSurface : m_FrameSurfaces)
+	{
+		SDL_FreeSurface(pFrameSurface);
+		pFrameSurface = nullptr;
+	}
 
-	// 4. Release Swap Chain
-	SAFE_RELEASE(m_pSwapChain);
+	SDL_FreeSurface(m_pBackBuffer);
+	m_pBackBuffer = nullptr;
 
-	// 5. Handle Device Context BEFORE Device
-	SAFE_RELEASE(m_pDeviceContext);
+	SDL_DestroyWindow(m_pWindow);
+	m_pWindow = nullptr;
 
-	// 6. Release Device
-	SAFE_RELEASE(m_pDevice);
+#if defined(DAE_D3D11)
+	// --- HARDWARE ---
+	// Device, swap chain and GPU resources are released by the backend
+	m_pD3D11Backend.reset();
+#endif
 }
 
 void Renderer::Update(const Timer* pTimer)
@@ -126,344 +214,632 @@ void Renderer::Update(const Timer* pTimer)
 	if (!m_RotationFrozen)
 	{
 		const float rotationSpeed{ PI_DIV_4 * pTimer->GetElapsed() };
-		for (auto& pOpaqMesh : m_OpaqueMeshes)
-		{
-			pOpaqMesh->RotateY(rotationSpeed);
-		}
-
-		for (auto& pTrMesh : m_TransparentMeshes)
+		for (SceneMesh& sceneMesh : m_SceneMeshes)
 		{
-			pTrMesh->RotateY(rotationSpeed);
+			sceneMesh.pMesh->RotateY(rotationSpeed);
 		}
 	}
 
 	m_Camera.Update(pTimer, aspectRatio, m_CurrentRasterizerMode);
-
-	if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
-	{
-		switch (m_CurrentSamplerType)
-		{
-		case SamplerType::Point:
-			m_CurrentSampler = m_pPointSampler;
-			break;
-		case SamplerType::Linear:
-			m_CurrentSampler = m_pLinearSampler;
-			break;
-		case SamplerType::Anisotropic:
-			m_CurrentSampler = m_pAnisotropicSampler;
-			break;
-		}
-	}
 }
 
 void Renderer::Render()
 {
-	if (!m_IsDXInitialized)
+	if (m_CurrentRasterizerMode == RasterizerMode::Hardware && !m_IsDXInitialized)
 		return;
 
+	DAE_PROFILE_FRAME();
+	DAE_PROFILE_SCOPE("Render");
+
 	Matrix viewProjMatrix{ m_Camera.viewMatrix * m_Camera.projectionMatrix };
 
+	const auto renderStart{ std::chrono::high_resolution_clock::now() };
+
 	// ------- START OF FRAME --------
+	ColorRGB clearColor{};
+	BackendScene* pScene{};
+
 	if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
 	{
-		constexpr float hardwareColor[3] = { 0.39f, 0.59f, 0.93f };
-		constexpr float uniformHardwareClearColor[3] = { 0.1f, 0.1f, 0.1f };
-		const float* currentHardwareBackgroundColor{ m_UniformClearColorActive ? uniformHardwareClearColor : hardwareColor };
+		// Software frames still queued go to the window first, later they would overwrite the swap chain output
+		PresentQueuedFrames();
 
-		// Clear Views at the start of each Frame
-		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, currentHardwareBackgroundColor);
-		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+		constexpr ColorRGB hardwareColor{ 0.39f, 0.59f, 0.93f };
+		constexpr ColorRGB uniformHardwareClearColor{ 0.1f, 0.1f, 0.1f };
+		clearColor = m_UniformClearColorActive ? uniformHardwareClearColor : hardwareColor;
+		pScene = &m_D3D11Scene;
 	}
-	else
+	else if (m_CurrentRasterizerMode == RasterizerMode::Software)
 	{
-		constexpr UINT8 softwareColor[3] = { UINT8(0.39f * 255), UINT8(0.39f * 255), UINT8(0.39f * 255) };
-		constexpr UINT8 uniformSoftwareClearColor[3] = { UINT8(0.1f * 255), UINT8(0.1f * 255), UINT8(0.1f * 255) };
-		const UINT8* currentSoftwareBackgroundColor{ m_UniformClearColorActive ? uniformSoftwareClearColor : softwareColor };
+		constexpr ColorRGB softwareColor{ 0.39f, 0.39f, 0.39f };
+		constexpr ColorRGB uniformSoftwareClearColor{ 0.1f, 0.1f, 0.1f };
+		clearColor = m_UniformClearColorActive ? uniformSoftwareClearColor : softwareColor;
+		pScene = &m_SoftwareScene;
 
 		// START SDL
-		SDL_LockSurface(m_pBackBuffer);
+		if (m_FramesInFlight > 1)
+		{
+			// At most m_FramesInFlight - 1 frames are queued, the ones before this => the next surface of the ring is free
+			m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % m_FramesInFlight;
+			m_pRenderTargetSurface = m_FrameSurfaces[m_CurrentFrameIndex];
+		}
+		else
+		{
+			m_pRenderTargetSurface = m_CurrentPresentMode == PresentMode::Direct ? m_pFrontBuffer : m_pBackBuffer;
+		}
+		SDL_LockSurface(m_pRenderTargetSurface);
+
+		m_pSoftwareBackend->SetColorTarget(static_cast<uint32_t*>(m_pRenderTargetSurface->pixels));
+		m_pSoftwareBackend->SetSettings(SoftwareRasterizer::Settings{ m_CurrentLightingMode, m_ShowNormalMap, m_CurrentPixelColorState,
+			m_ShowBoundingBox, m_SRGBEncodingActive, m_CurrentCullMode, m_CurrentTransparencyMode, m_ClusterCullingActive });
+	}
+	else
+	{
+		pScene = &m_NullScene;
+	}
 
-		std::fill_n(m_pDepthBufferPixels.get(), m_Width * m_Height, std::numeric_limits<float>::max());
+	// ----------- RENDER FRAME -------------
+	// The hardware backend presents the swap chain in EndFrame
+	UpdateSceneBVH();
+	CullSceneObjects();
 
-		// CLEAR THE BUFFER
-		SDL_FillRect(
-			m_pBackBuffer,
-			nullptr, // null fills the whole surface
-			SDL_MapRGB(m_pBackBuffer->format,
-				currentSoftwareBackgroundColor[0],
-				currentSoftwareBackgroundColor[1],
-				currentSoftwareBackgroundColor[2]) // Background color
-		);
+	if (m_CurrentRasterizerMode == RasterizerMode::Software && m_FramesInFlight > 1 && !m_IsHeadless)
+	{
+		m_RasterJob = RasterJob{ pScene, clearColor, viewProjMatrix };
+		m_IsRasterPending = true;
+		m_IsRasterPending.notify_one();
+
+		// The oldest frame goes to the window while this one rasterizes, a full queue would leave no surface for the next frame
+		if (m_NumQueuedFrames == m_FramesInFlight - 1)
+		{
+			PresentOldestFrame();
+		}
+
+		DAE_PROFILE_SCOPE("WaitForRaster");
+		m_IsRasterPending.wait(true);
+	}
+	else
+	{
+		DrawScene(*pScene, clearColor, viewProjMatrix);
 	}
 
-	// ----------- RENDER FRAME -------------	
-	// Draw Opaque Meshes first
-	for (auto& pOpaqMesh : m_OpaqueMeshes)
+	// -------- END OF FRAME --------
+	const auto presentStart{ std::chrono::high_resolution_clock::now() };
+
+	if (m_CurrentRasterizerMode == RasterizerMode::Software)
 	{
-		pOpaqMesh->Render(m_CurrentRasterizerMode, viewProjMatrix, m_Camera.origin, m_pDeviceContext, m_CurrentSampler, m_CurrentCullMode);
+		DAE_PROFILE_SCOPE("Present");
+
+		// Update SDL Surface
+		SDL_UnlockSurface(m_pRenderTargetSurface);
 
-		// After World Matrix calculations in Mesh::Render
-		if (m_CurrentRasterizerMode == RasterizerMode::Software)
+		if (m_IsHeadless)
+		{
+			// Nothing to present, the frame stays in the back buffer (see SaveFrame)
+		}
+		else if (m_FramesInFlight > 1)
 		{
-			RenderSoftwareMesh(*pOpaqMesh, viewProjMatrix);
+			// Presented while a later frame rasterizes, which measures present time and latency
+			m_QueuedFrames[m_NumQueuedFrames++] = FinishedFrame{ m_CurrentFrameIndex, renderStart };
+			return;
 		}
+
+		else
+		{
+			if (m_CurrentPresentMode == PresentMode::Blit)
+			{
+				SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
+			}
+
+			SDL_UpdateWindowSurface(m_pWindow);
+		}
+	}
+
+	const auto presentEnd{ std::chrono::high_resolution_clock::now() };
+	m_PresentTime = std::chrono::duration<float, std::milli>{ presentEnd - presentStart }.count();
+	m_FrameLatency = std::chrono::duration<float, std::milli>{ presentEnd - renderStart }.count();
+}
+
+Renderer::MeshId dae::Renderer::AddMesh(std::unique_ptr<Mesh> pMesh, BlendMode blendMode, uint32_t maxSubmeshVertices)
+{
+	pMesh->SetVertexFormat(m_VertexFormat);
+
+	// Meshlets and levels of detail index the split vertices
+	if (maxSubmeshVertices > 0 && !pMesh->SplitInto16BitSubmeshes(maxSubmeshVertices))
+		std::cout << "Only triangle lists can be split into 16-bit submeshes, keeping a single submesh\n";
+
+	pMesh->BuildMeshlets();
+	pMesh->BuildLods();
+
+	// Transparent meshes hide nothing
+	if (blendMode == BlendMode::Opaque)
+		pMesh->BuildOccluder();
+
+	for (BackendScene* pScene : { &m_SoftwareScene, &m_NullScene, &m_D3D11Scene })
+	{
+		if (pScene->pBackend)
+			pScene->meshes.emplace_back(UploadMesh(*pScene->pBackend, *pMesh));
+	}
+
+	m_SceneMeshes.emplace_back(SceneMesh{ std::move(pMesh), blendMode });
+	m_IsObjectLayoutDirty = true;
+
+	return static_cast<MeshId>(m_SceneMeshes.size() - 1);
+}
+
+void dae::Renderer::SetInstances(MeshId mesh, const std::vector<Matrix>& instanceTransforms)
+{
+	if (mesh >= m_SceneMeshes.size())
+	{
+		std::wcout << L"SetInstances: unknown mesh " << mesh << L"\n";
+		return;
 	}
+
+	// Same count => every object keeps its id and its BVH leaf, only the boxes move
+	std::vector<Matrix>& currentTransforms{ m_SceneMeshes[mesh].instanceTransforms };
+	if (currentTransforms.size() != instanceTransforms.size())
+		m_IsObjectLayoutDirty = true;
+
+	currentTransforms = instanceTransforms;
+}
+
+void dae::Renderer::DrawScene(BackendScene& scene, const ColorRGB& clearColor, const Matrix& viewProjMatrix)
+{
+	DAE_PROFILE_SCOPE("DrawScene");
+
+	RenderBackend& backend{ *scene.pBackend };
+
+	backend.BeginFrame(clearColor, viewProjMatrix, m_Camera.origin);
+
+	// Visible objects are sorted by id => one run per mesh, one instanced draw per level of detail of the run
+	const auto drawMeshes{ [&](BlendMode blendMode)
+		{
+			for (size_t first{}; first < m_VisibleObjects.size();)
+			{
+				const MeshId mesh{ m_ObjectMeshes[m_VisibleObjects[first]] };
+				const bool isDrawn{ m_SceneMeshes[mesh].blendMode == blendMode };
+
+				size_t last{ first };
+				while (last < m_VisibleObjects.size() && m_ObjectMeshes[m_VisibleObjects[last]] == mesh)
+				{
+					++last;
+				}
+
+				// One instanced draw per level of detail in use
+				const size_t numLods{ isDrawn ? m_SceneMeshes[mesh].pMesh->GetLodCount() : 0 };
+				for (size_t lod{}; lod < numLods; ++lod)
+				{
+					m_InstanceBatch.clear();
+					for (size_t i{ first }; i < last; ++i)
+					{
+						if (m_ObjectLods[m_VisibleObjects[i]] == lod)
+							m_InstanceBatch.emplace_back(m_ObjectWorldMatrices[m_VisibleObjects[i]]);
+					}
+
+					if (!m_InstanceBatch.empty())
+						DrawMeshInstanced(backend, scene.meshes[mesh], m_InstanceBatch.data(), static_cast<uint32_t>(m_InstanceBatch.size()), lod);
+				}
+
+				first = last;
+			}
+		} };
+
+	// Draw Opaque Meshes first
+	backend.SetPipelineState(PipelineState{ BlendMode::Opaque, m_CurrentCullMode, m_CurrentSamplerType });
+	drawMeshes(BlendMode::Opaque);
+
 	// Draw Transparent Meshes AFTER
-	if (m_CurrentRasterizerMode == RasterizerMode::Hardware && m_ShowFireMesh)
+	if (m_ShowFireMesh)
+	{
+		backend.SetPipelineState(PipelineState{ BlendMode::Transparent, m_CurrentCullMode, m_CurrentSamplerType });
+		drawMeshes(BlendMode::Transparent);
+	}
+
+	backend.EndFrame();
+}
+
+const Mesh& dae::Renderer::GetObjectMesh(BVH::ObjectId object) const
+{
+	return *m_SceneMeshes[m_ObjectMeshes[object]].pMesh;
+}
+
+bool dae::Renderer::IsTransparentObject(BVH::ObjectId object) const
+{
+	return m_SceneMeshes[m_ObjectMeshes[object]].blendMode == BlendMode::Transparent;
+}
+
+void dae::Renderer::UpdateSceneBVH()
+{
+	DAE_PROFILE_SCOPE("UpdateSceneBVH");
+	const auto updateStart{ std::chrono::high_resolution_clock::now() };
+
+	m_SceneStatistics = PipelineStatistics{};
+
+	// The ids of every mesh after the one that changed moved => new leaves for all of them
+	if (m_IsObjectLayoutDirty)
 	{
-		for (auto& pTrMesh : m_TransparentMeshes)
+		m_ObjectMeshes.clear();
+		for (MeshId mesh{}; mesh < m_SceneMeshes.size(); ++mesh)
 		{
-			pTrMesh->Render(RasterizerMode::Hardware, viewProjMatrix, m_Camera.origin, m_pDeviceContext, m_CurrentSampler, m_CurrentCullMode);
+			m_SceneMeshes[mesh].firstObject = static_cast<BVH::ObjectId>(m_ObjectMeshes.size());
+			m_ObjectMeshes.insert(m_ObjectMeshes.end(), m_SceneMeshes[mesh].instanceTransforms.size(), mesh);
 		}
+
+		m_SceneBVH.Clear();
+		m_ObjectLods.clear();
+		m_IsObjectLayoutDirty = false;
 	}
 
-	// -------- END OF FRAME --------
-	if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
+	const uint32_t numObjects{ static_cast<uint32_t>(m_ObjectMeshes.size()) };
+	m_ObjectWorldMatrices.resize(numObjects);
+	m_ObjectBoxes.resize(numObjects);
+	m_ObjectLods.resize(numObjects);
+	const uint32_t numExistingObjects{ m_SceneBVH.GetObjectCount() };
+
+	const auto updateObjects{ [&](uint32_t firstObject)
+		{
+			const uint32_t lastObject{ std::min(firstObject + OBJECT_CHUNK_SIZE, numObjects) };
+			for (uint32_t object{ firstObject }; object < lastObject; ++object)
+			{
+				const SceneMesh& sceneMesh{ m_SceneMeshes[m_ObjectMeshes[object]] };
+				const Mesh& mesh{ *sceneMesh.pMesh };
+				m_ObjectWorldMatrices[object] = mesh.GetWorldMatrix() * sceneMesh.instanceTransforms[object - sceneMesh.firstObject];
+				m_ObjectBoxes[object] = mesh.GetBoundingBox().Transformed(m_ObjectWorldMatrices[object]);
+
+				if (object < numExistingObjects)
+					m_SceneBVH.SetBox(object, m_ObjectBoxes[object]);
+			}
+		} };
+
+	m_ObjectChunkStarts.clear();
+	for (uint32_t firstObject{}; firstObject < numObjects; firstObject += OBJECT_CHUNK_SIZE)
 	{
-		// Present BackBuffer (SWAP)
-		m_pSwapChain->Present(0, 0);
+		m_ObjectChunkStarts.emplace_back(firstObject);
 	}
+
+	// A handful of objects is not worth waking up the thread pool
+	if (m_ObjectChunkStarts.size() > 1)
+		std::for_each(std::execution::par, m_ObjectChunkStarts.begin(), m_ObjectChunkStarts.end(), updateObjects);
 	else
+		std::for_each(m_ObjectChunkStarts.begin(), m_ObjectChunkStarts.end(), updateObjects);
+
+	for (uint32_t object{ numExistingObjects }; object < numObjects; ++object)
 	{
-		// Update SDL Surface
-		SDL_UnlockSurface(m_pBackBuffer);
-		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-		SDL_UpdateWindowSurface(m_pWindow);
+		m_SceneBVH.Insert(object, m_ObjectBoxes[object]);
 	}
+
+	m_SceneBVH.Refit();
+
+	const auto updateEnd{ std::chrono::high_resolution_clock::now() };
+	m_SceneStatistics.bvhUpdateTime = std::chrono::duration_cast<std::chrono::nanoseconds>(updateEnd - updateStart).count();
 }
 
-void dae::Renderer::VertexTransformationFunction(const std::vector<VertexIn>& vertices_in, std::vector<VertexOut>& vertices_out, 
-	const Matrix& WVPMatrix, const Matrix& worldMatrix)
+void dae::Renderer::CullSceneObjects()
 {
-	if (vertices_out.capacity() < vertices_in.size())
+	DAE_PROFILE_SCOPE("CullSceneObjects");
+
+	// Without depth writes (front face culling) nothing drawn hides anything
+	const bool isOcclusionCullingActive{ m_OcclusionCullingActive && m_CurrentCullMode != CullMode::Front };
+	if (isOcclusionCullingActive)
+		m_pOcclusionBuffer->Clear(m_Camera.viewMatrix * m_Camera.projectionMatrix);
+
+	uint64_t numOccluded{};
+	m_VisibleObjects.clear();
+	m_SceneBVH.Query(m_Camera.origin,
+		[&](const AABB& box) { return m_Camera.frustum.Classify(box); },
+		[&](BVH::ObjectId object, bool isInside)
+		{
+			const bool isTransparent{ IsTransparentObject(object) };
+			if (!m_ShowFireMesh && isTransparent)
+				return;
+
+			// World boxes around rotated meshes are loose, the exact test only runs where a box touches a plane
+			const Mesh& mesh{ GetObjectMesh(object) };
+			const Matrix& worldMatrix{ m_ObjectWorldMatrices[object] };
+			if (!isInside && !IsMeshVisible(mesh, worldMatrix))
+				return;
+
+			// Nearest first => most occluders are in the buffer before the meshes they hide are tested
+			if (isOcclusionCullingActive)
+			{
+				if (!m_pOcclusionBuffer->IsBoxVisible(m_ObjectBoxes[object]))
+				{
+					++numOccluded;
+					return;
+				}
+
+				if (!isTransparent)
+					m_pOcclusionBuffer->RenderOccluder(mesh.GetOccluderTriangles(), worldMatrix);
+			}
+
+			m_VisibleObjects.emplace_back(object);
+
+			const size_t lod{ SelectObjectLod(object) };
+			m_SceneStatistics.meshTriangles += mesh.GetLodTriangleCount(lod);
+			m_SceneStatistics.meshTrianglesSkippedLod += mesh.GetTriangleCount() - mesh.GetLodTriangleCount(lod);
+		});
+
+	std::sort(m_VisibleObjects.begin(), m_VisibleObjects.end());
+
+	m_SceneStatistics.meshesSubmitted = 0;
+	for (const SceneMesh& sceneMesh : m_SceneMeshes)
 	{
-		vertices_out.reserve(vertices_in.size());
+		if (m_ShowFireMesh || sceneMesh.blendMode != BlendMode::Transparent)
+			m_SceneStatistics.meshesSubmitted += sceneMesh.instanceTransforms.size();
 	}
+	m_SceneStatistics.meshesCulledOcclusion = numOccluded;
+	m_SceneStatistics.meshesCulledFrustum = m_SceneStatistics.meshesSubmitted - m_VisibleObjects.size() - numOccluded;
+	m_SceneStatistics.occluderTriangles = isOcclusionCullingActive ? m_pOcclusionBuffer->GetOccluderTriangleCount() : 0;
+}
+
+bool dae::Renderer::IsMeshVisible(const Mesh& mesh, const Matrix& worldMatrix) const
+{
+	// Sphere first, it is cheaper and rejects most meshes that are far outside
+	const BoundingSphere& sphere{ mesh.GetBoundingSphere() };
+	const float radiusScale{ std::max(worldMatrix.GetAxisX().Magnitude(), std::max(worldMatrix.GetAxisY().Magnitude(), worldMatrix.GetAxisZ().Magnitude())) };
+
+	return !mesh.GetBoundingBox().IsEmpty()
+		&& !m_Camera.frustum.IsSphereOutside(worldMatrix.TransformPoint(sphere.center), sphere.radius * radiusScale)
+		&& !m_Camera.frustum.IsBoxOutside(mesh.GetBoundingBox(), worldMatrix);
+}
 
-	for (size_t i{}; i < vertices_in.size(); ++i)
+uint8_t dae::Renderer::SelectObjectLod(BVH::ObjectId object)
+{
+	const Mesh& mesh{ GetObjectMesh(object) };
+	uint8_t& lod{ m_ObjectLods[object] };
+	if (!m_LodActive || mesh.GetLodCount() == 1)
+		return lod = 0;
+
+	// Radius of the bounding sphere on screen in pixels, full detail with the camera inside the sphere
+	const Matrix& worldMatrix{ m_ObjectWorldMatrices[object] };
+	const BoundingSphere& sphere{ mesh.GetBoundingSphere() };
+	const float radiusScale{ std::max(worldMatrix.GetAxisX().Magnitude(), std::max(worldMatrix.GetAxisY().Magnitude(), worldMatrix.GetAxisZ().Magnitude())) };
+	const float radius{ sphere.radius * radiusScale };
+	const float distanceSquared{ (worldMatrix.TransformPoint(sphere.center) - m_Camera.origin).SqrMagnitude() };
+	if (distanceSquared <= radius * radius)
+		return lod = 0;
+
+	const float projectedRadius{ radius / (std::sqrt(distanceSquared - radius * radius) * m_Camera.fov) * m_Height * 0.5f };
+
+	// Errors are object space like the sphere => pixels of error per pixel of radius
+	const auto getCoarsestLod{ [&](float radiusInPixels)
+		{
+			uint8_t coarsestLod{};
+			while (coarsestLod + 1u < mesh.GetLodCount() && mesh.GetLodError(coarsestLod + 1u) / sphere.radius * radiusInPixels <= LOD_PIXEL_ERROR)
+			{
+				++coarsestLod;
+			}
+			return coarsestLod;
+		} };
+
+	// Coarser once even a slightly larger sphere allows it, finer once a slightly smaller one needs it
+	lod = std::clamp(lod, getCoarsestLod(projectedRadius * (1.f + LOD_HYSTERESIS)), getCoarsestLod(projectedRadius * (1.f - LOD_HYSTERESIS)));
+	return lod;
+}
+
+void dae::Renderer::PickObject(int mouseX, int mouseY) const
+{
+	// Ray through the pixel center, same field of view and aspect ratio as the projection matrix
+	const float aspectRatio{ static_cast<float>(m_Width) / static_cast<float>(m_Height) };
+	const float viewX{ (2.f * (static_cast<float>(mouseX) + 0.5f) / static_cast<float>(m_Width) - 1.f) * m_Camera.fov * aspectRatio };
+	const float viewY{ (1.f - 2.f * (static_cast<float>(mouseY) + 0.5f) / static_cast<float>(m_Height)) * m_Camera.fov };
+
+	const Matrix invViewMatrix{ Matrix::Inverse(m_Camera.viewMatrix) };
+	const Vector3 origin{ invViewMatrix.GetTranslation() };
+	const Vector3 direction{ invViewMatrix.TransformVector(Vector3{ viewX, viewY, 1.f }).Normalized() };
+
+	float distance{ m_Camera.farPlane };
+	const BVH::ObjectId object{ m_SceneBVH.Raycast(origin, direction, distance, [&](BVH::ObjectId candidate, float& hitDistance)
+		{
+			if (!m_ShowFireMesh && IsTransparentObject(candidate))
+				return false;
+
+			// The object space direction is not normalized => distances stay in world units
+			const Matrix invWorldMatrix{ Matrix::Inverse(m_ObjectWorldMatrices[candidate]) };
+			return GetObjectMesh(candidate).Raycast(invWorldMatrix.TransformPoint(origin), invWorldMatrix.TransformVector(direction), hitDistance);
+		}) };
+
+	if (object == BVH::INVALID_INDEX)
 	{
-		// Model -> View
-		const Vector4 viewPos{ WVPMatrix.TransformPoint(Vector4(vertices_in[i].position, 1.f)) };
+		std::wcout << L"Picked nothing\n";
+		return;
+	}
+
+	const MeshId mesh{ m_ObjectMeshes[object] };
+	std::wcout << L"Picked " << (IsTransparentObject(object) ? L"transparent mesh " : L"opaque mesh ")
+		<< mesh << L" instance " << object - m_SceneMeshes[mesh].firstObject
+		<< L" at distance " << distance << L"\n";
+}
 
-		const float invW{ 1.f / viewPos.w };
+void dae::Renderer::ApplyBenchmarkFrame(const BenchmarkFrame& frame)
+{
+	const float aspectRatio{ static_cast<float>(m_Width) / static_cast<float>(m_Height) };
+	m_Camera.farPlane = frame.farPlane;
+	m_Camera.LookAt(frame.cameraOrigin, frame.cameraTarget, aspectRatio);
 
-		// Perspective Divide
-		const Vector3 projectedPos{ Vector3(viewPos) * invW };
+	// Every mesh gets the offsets of the script, a single instance at the origin when there are none
+	std::vector<Matrix> instanceTransforms{};
+	for (const Vector3& offset : frame.instanceOffsets)
+	{
+		instanceTransforms.emplace_back(Matrix::CreateTranslation(offset));
+	}
 
-		// Perspective -> Screen
-		const Vector4 screenPos{ (projectedPos.x + 1.f) * 0.5f * m_Width,
-			(1.f - projectedPos.y) * 0.5f * m_Height,
-			projectedPos.z,
-			invW
-		};
+	if (instanceTransforms.empty())
+	{
+		instanceTransforms.emplace_back(Matrix{});
+	}
 
-		const auto perspectiveUV{ vertices_in[i].UVCoordinate * invW };
+	for (MeshId mesh{}; mesh < m_SceneMeshes.size(); ++mesh)
+	{
+		m_SceneMeshes[mesh].pMesh->SetRotationY(frame.meshYaw);
+		SetInstances(mesh, instanceTransforms);
+	}
+}
 
-		// Model -> World
-		const auto worldNormal{ worldMatrix.TransformVector(vertices_in[i].normal) };
-		const auto worldTangent{ worldMatrix.TransformVector(vertices_in[i].tangent) };
-		
-		const Vector3 worldPos{ worldMatrix.TransformPoint(vertices_in[i].position) };
-		const auto viewDir{ Vector3{ m_Camera.origin - worldPos }.Normalized() };
+const char* dae::Renderer::GetBackendName() const
+{
+	switch (m_CurrentRasterizerMode)
+	{
+	case RasterizerMode::Hardware:
+		return "D3D11";
+	case RasterizerMode::Null:
+		return m_pNullBackend->GetName();
+	default:
+		return m_pSoftwareBackend->GetName();
+	}
+}
 
-		vertices_out.emplace_back(VertexOut{ screenPos, perspectiveUV, worldNormal, worldTangent, viewDir });
+PipelineStatistics dae::Renderer::GetPipelineStatistics() const
+{
+	PipelineStatistics statistics{ m_SceneStatistics };
+	if (m_CurrentRasterizerMode == RasterizerMode::Software)
+	{
+		statistics += m_pSoftwareBackend->GetFrameStatistics();
 	}
+
+	return statistics;
 }
 
-bool dae::Renderer::PassTriangleOptimizations(const std::array<VertexOut, 3> screenTri) const
+void dae::Renderer::PrintPipelineStatistics() const
 {
-	// --- INSIDE SCREEN CHECK ---
-	if (std::any_of(screenTri.begin(), screenTri.end(),
-		[&](const VertexOut& v) {
-			return v.position.x < 0.f || v.position.x >= m_Width ||
-				v.position.y < 0.f || v.position.y >= m_Height;
-		}))
+	if (m_CurrentRasterizerMode == RasterizerMode::Software)
 	{
-		return false; // Skip triangle
+		GetPipelineStatistics().Print();
 	}
+}
 
-	// --- FRUSTRUM CULLING ---
-	if (std::any_of(screenTri.begin(), screenTri.end(),
-		[&](const VertexOut& v) {
-			return v.position.z < 0.f || v.position.z > 1.f;
-		}))
+void dae::Renderer::PrintBackendStats() const
+{
+	if (m_CurrentRasterizerMode == RasterizerMode::Null)
 	{
-		return false; // Skip triangle
+		m_pNullBackend->PrintStats();
 	}
-	return true;
 }
 
-void dae::Renderer::FillRectangle(int x0, int y0, int x1, int y1, const ColorRGB& color) const
+bool dae::Renderer::SaveFrame(const std::string& filePath) const
 {
-	auto drawPixel = [&](int x, int y) // Store Lambda function
+	const SDL_Surface* pSurface{ m_pRenderTargetSurface ? m_pRenderTargetSurface : m_pBackBuffer };
+
+	if (filePath.ends_with(".png"))
+	{
+		return IMG_SavePNG(const_cast<SDL_Surface*>(pSurface), filePath.c_str()) == 0;
+	}
+
+	// Binary PPM (P6), no dependencies
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	file << "P6\n" << pSurface->w << " " << pSurface->h << "\n255\n";
+
+	std::vector<uint8_t> row(static_cast<size_t>(pSurface->w) * 3);
+	for (int py{}; py < pSurface->h; ++py)
+	{
+		const uint32_t* pRowPixels{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pSurface->pixels) + py * pSurface->pitch) };
+		for (int px{}; px < pSurface->w; ++px)
 		{
-			int idx = GetPixelNumber(x, y, m_Width);
-			m_pBackBufferPixels[idx] = SDL_MapRGB(m_pBackBuffer->format,
-				uint8_t(color.r * 255),
-				uint8_t(color.g * 255),
-				uint8_t(color.b * 255));
-		};
+			row[px * 3] = static_cast<uint8_t>((pRowPixels[px] >> 16) & 0xFF);
+			row[px * 3 + 1] = static_cast<uint8_t>((pRowPixels[px] >> 8) & 0xFF);
+			row[px * 3 + 2] = static_cast<uint8_t>(pRowPixels[px] & 0xFF);
+		}
+		file.write(reinterpret_cast<const char*>(row.data()), row.size());
+	}
 
-	for (int y = y0; y <= y1; ++y)
+	return static_cast<bool>(file);
+}
+
+std::vector<uint32_t> dae::Renderer::GetFramePixels() const
+{
+	const SDL_Surface* pSurface{ m_pRenderTargetSurface ? m_pRenderTargetSurface : m_pBackBuffer };
+
+	std::vector<uint32_t> pixels(static_cast<size_t>(pSurface->w) * pSurface->h);
+	for (int py{}; py < pSurface->h; ++py)
 	{
-		for (int x = x0; x <= x1; ++x)
+		const uint32_t* pRowPixels{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pSurface->pixels) + py * pSurface->pitch) };
+		for (int px{}; px < pSurface->w; ++px)
 		{
-			int idx = GetPixelNumber(x, y, m_Width);
-			m_pBackBufferPixels[idx] = SDL_MapRGB(m_pBackBuffer->format,
-				uint8_t(color.r * 255),
-				uint8_t(color.g * 255),
-				uint8_t(color.b * 255));
+			pixels[GetPixelNumber(px, py, pSurface->w)] = pRowPixels[px] & 0x00FFFFFF;
 		}
 	}
+
+	return pixels;
 }
 
-void dae::Renderer::CreateSamplerStates(ID3D11Device* pDevice)
+void dae::Renderer::RasterThreadLoop()
 {
-	D3D11_SAMPLER_DESC desc{};
-	desc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	desc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	desc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-
-	// Point
-	desc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-	m_pPointSampler = nullptr;
-	pDevice->CreateSamplerState(&desc, &m_pPointSampler);
-
-	// Linear
-	desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-	m_pLinearSampler = nullptr;
-	pDevice->CreateSamplerState(&desc, &m_pLinearSampler);
-
-	// Anisotropic
-	desc.Filter = D3D11_FILTER_ANISOTROPIC;
-	desc.MaxAnisotropy = 16;
-	m_pAnisotropicSampler = nullptr;
-	pDevice->CreateSamplerState(&desc, &m_pAnisotropicSampler);
+	DAE_PROFILE_THREAD("Raster");
+
+	while (true)
+	{
+		m_IsRasterPending.wait(false); // Sleeps until Render hands off a frame
+
+		if (!m_IsRasterThreadRunning)
+			return;
+
+		DrawScene(*m_RasterJob.pScene, m_RasterJob.clearColor, m_RasterJob.viewProjMatrix);
+
+		m_IsRasterPending = false;
+		m_IsRasterPending.notify_one();
+	}
 }
 
-HRESULT Renderer::InitializeDirectX()
+void dae::Renderer::PresentOldestFrame()
 {
-	// 1. ----- Create Device and Device Context -----
-	D3D_FEATURE_LEVEL featureLevel{ D3D_FEATURE_LEVEL_11_1 };
-	uint32_t createDeviceFlag{ 0 };
-#if defined(DEBUG) || defined(_DEBUG)
-	createDeviceFlag |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
+	const FinishedFrame frame{ m_QueuedFrames[0] };
+	std::move(m_QueuedFrames.begin() + 1, m_QueuedFrames.begin() + m_NumQueuedFrames, m_QueuedFrames.begin());
+	--m_NumQueuedFrames;
 
-	// Create DXGI Factory
-	IDXGIFactory1* pDxgiFactory{};
-	HRESULT result{ CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**> (&pDxgiFactory)) };
-	if (FAILED(result))
-		return S_FALSE;
+	const auto presentStart{ std::chrono::high_resolution_clock::now() };
 
-	IDXGIAdapter* adapter = nullptr;
-	IDXGIAdapter* selectedAdapter = nullptr;
+	{
+		DAE_PROFILE_SCOPE("Present");
+
+		SDL_BlitSurface(m_FrameSurfaces[frame.frameIndex], 0, m_pFrontBuffer, 0);
+		SDL_UpdateWindowSurface(m_pWindow);
+	}
+
+	const auto presentEnd{ std::chrono::high_resolution_clock::now() };
+	m_PresentTime = std::chrono::duration<float, std::milli>{ presentEnd - presentStart }.count();
+	m_FrameLatency = std::chrono::duration<float, std::milli>{ presentEnd - frame.renderStart }.count();
+}
 
-	for (UINT i{ 0 }; pDxgiFactory->EnumAdapters(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+void dae::Renderer::PresentQueuedFrames()
+{
+	while (m_NumQueuedFrames > 0)
 	{
-		DXGI_ADAPTER_DESC desc;
-		adapter->GetDesc(&desc);
-		std::wcout << L"Adapter: " << i << L": " << desc.Description << L"\n";
+		PresentOldestFrame();
+	}
+}
 
-		if (desc.VendorId == 0x10DE) // NVIDIA vendor ID
-		{
-			selectedAdapter = adapter;
-			break;
-		}
+void dae::Renderer::SetFramesInFlight(int framesInFlight)
+{
+	// Frames queued for the old count go to the window first, the ring starts over
+	PresentQueuedFrames();
+
+	m_FramesInFlight = framesInFlight;
+	if (m_FramesInFlight == 1 || m_RasterThread.joinable())
+		return;
+
+	// First time more than one frame is in flight, single frames and headless runs never pay for the surfaces and the thread
+	for (auto& pFrameSurface : m_FrameSurfaces)
+	{
+		pFrameSurface = SDL_CreateRGBSurfaceWithFormat(0, m_Width, m_Height, 32, BACK_BUFFER_PIXEL_FORMAT);
 	}
 
-	if (selectedAdapter == nullptr)
-	{
-		std::wcout << L"No NVIDIA GPU found on machine\n";
-	}
-
-	result = D3D11CreateDevice(selectedAdapter, D3D_DRIVER_TYPE_UNKNOWN, 0, createDeviceFlag, &featureLevel,
-		1, D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
-	if (FAILED(result))
-		return S_FALSE;
-
-	// 2. ----- SWAPCHAIN ------
-	DXGI_SWAP_CHAIN_DESC swapChainDesc{};
-	swapChainDesc.BufferDesc.Width = m_Width;
-	swapChainDesc.BufferDesc.Height = m_Height;
-	swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
-	swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
-	swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; // 32 bit format
-	swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-	swapChainDesc.SampleDesc.Count = 1;
-	swapChainDesc.SampleDesc.Quality = 0;
-	swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT; // Buffers will be bound to Output Merger as a render target
-	swapChainDesc.BufferCount = 1;
-	swapChainDesc.Windowed = true;
-	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-	swapChainDesc.Flags = 0;
-
-	// Get Handle from SDL
-	SDL_SysWMinfo sysWMInfo{};
-	SDL_GetVersion(&sysWMInfo.version);
-	SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
-	swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
-
-	result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
-	if (FAILED(result))
-		return S_FALSE;
-
-	// 3. ----- Depth Stencil and Depth Stencil View -----
-	// Depth Stencil
-	D3D11_TEXTURE2D_DESC depthStencilDesc{};
-	depthStencilDesc.Width = m_Width;
-	depthStencilDesc.Height = m_Height;
-	depthStencilDesc.MipLevels = 1;
-	depthStencilDesc.ArraySize = 1;
-	depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	depthStencilDesc.SampleDesc.Count = 1;
-	depthStencilDesc.SampleDesc.Quality = 0;
-	depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
-	depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-	depthStencilDesc.CPUAccessFlags = 0;
-	depthStencilDesc.MiscFlags = 0;
-
-	// View
-	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
-	depthStencilViewDesc.Format = depthStencilDesc.Format;
-	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-	depthStencilViewDesc.Texture2D.MipSlice = 0;
-
-	result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
-	if (FAILED(result))
-		return S_FALSE;
-
-	result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
-	if (FAILED(result))
-		return S_FALSE;
-
-
-	// 4. ----- Render Target and Render Target View -----
-	result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**> (&m_pRenderTargetBuffer));
-	if (FAILED(result))
-		return S_FALSE;
-
-	result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
-	if (FAILED(result))
-		return S_FALSE;
-
-	// Output Merger Stage
-	// 5. ----- Binding RenderTargertView and DepthStencilView ------
-	m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
-
-
-	// 6. ----- ViewPort ------
-	D3D11_VIEWPORT viewPort{};
-	viewPort.Width = static_cast<float> (m_Width);
-	viewPort.Height = static_cast<float> (m_Height);
-	viewPort.TopLeftX = 0.f;
-	viewPort.TopLeftY = 0.f;
-	viewPort.MinDepth = 0.f;
-	viewPort.MaxDepth = 1.f;
-	m_pDeviceContext->RSSetViewports(1, &viewPort);
-
-	return S_OK;
+	m_IsRasterThreadRunning = true;
+	m_RasterThread = std::thread{ &Renderer::RasterThreadLoop, this };
+}
+
+bool dae::Renderer::IsDirectPresentSupported() const
+{
+	// The window surface has to match the packed back buffer layout (0x??RRGGBB) without row padding
+	if (!m_pFrontBuffer || m_pFrontBuffer->w != m_Width || m_pFrontBuffer->h != m_Height)
+		return false;
+
+	const SDL_PixelFormat* pFormat{ m_pFrontBuffer->format };
+	return pFormat->BytesPerPixel == 4 &&
+		pFormat->Rmask == 0x00FF0000 && pFormat->Gmask == 0x0000FF00 && pFormat->Bmask == 0x000000FF &&
+		m_pFrontBuffer->pitch == m_Width * static_cast<int>(sizeof(uint32_t));
 }
 
 void dae::Renderer::ProcessInput()
@@ -478,12 +854,24 @@ void dae::Renderer::ProcessInput()
 
 	if (wasF1Pressed && !isF1Pressed)
 	{
-		m_CurrentRasterizerMode = static_cast<RasterizerMode>((static_cast<int>(m_CurrentRasterizerMode) + 1) % 2);
-
+		m_CurrentRasterizerMode = static_cast<RasterizerMode>((static_cast<int>(m_CurrentRasterizerMode) + 1) % 3);
+#if !defined(DAE_D3D11)
 		if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
+			m_CurrentRasterizerMode = RasterizerMode::Software; // Built without DirectX 11
+#endif
+
+		switch (m_CurrentRasterizerMode)
+		{
+		case RasterizerMode::Hardware:
 			std::wcout << L"RASTERIZER MODE = HARDWARE\n";
-		else
+			break;
+		case RasterizerMode::Software:
 			std::wcout << L"RASTERIZER MODE = SOFTWARE\n";
+			break;
+		case RasterizerMode::Null:
+			std::wcout << L"RASTERIZER MODE = NULL (draws are recorded, nothing is rendered)\n";
+			break;
+		}
 	}
 	wasF1Pressed = isF1Pressed;
 
@@ -502,6 +890,21 @@ void dae::Renderer::ProcessInput()
 	}
 	wasF2Pressed = isF2Pressed;
 
+	// Toggle FireFX Mesh
+	static bool wasF3Pressed{ false };
+	bool isF3Pressed = pKeyboardState[SDL_SCANCODE_F3];
+
+	if (wasF3Pressed && !isF3Pressed)
+	{
+		m_ShowFireMesh = !m_ShowFireMesh;
+
+		if (m_ShowFireMesh)
+			std::wcout << L"FireFX ON\n";
+		else
+			std::wcout << L"FireFX OFF\n";
+	}
+	wasF3Pressed = isF3Pressed;
+
 	// Uniform Clear Color
 	static bool wasF10Pressed{ false };
 	bool isF10Pressed = pKeyboardState[SDL_SCANCODE_F10];
@@ -540,24 +943,50 @@ void dae::Renderer::ProcessInput()
 	}
 	wasF9Pressed = isF9Pressed;
 
-	// ------ HARDWARE ------
-	if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
+	// Occlusion Culling
+	static bool wasOPressed{ false };
+	bool isOPressed = pKeyboardState[SDL_SCANCODE_O];
+
+	if (wasOPressed && !isOPressed)
 	{
-		// Toggle FireFX Mesh
-		static bool wasF3Pressed{ false };
-		bool isF3Pressed = pKeyboardState[SDL_SCANCODE_F3];
+		m_OcclusionCullingActive = !m_OcclusionCullingActive;
 
-		if (wasF3Pressed && !isF3Pressed)
-		{
-			m_ShowFireMesh = !m_ShowFireMesh;
+		if (m_OcclusionCullingActive)
+			std::wcout << L"Occlusion Culling ON\n";
+		else
+			std::wcout << L"Occlusion Culling OFF\n";
+	}
+	wasOPressed = isOPressed;
 
-			if (m_ShowFireMesh)
-				std::wcout << L"FireFX ON\n";
-			else
-				std::wcout << L"FireFX OFF\n";
-		}
-		wasF3Pressed = isF3Pressed;
+	// Level Of Detail
+	static bool wasLPressed{ false };
+	bool isLPressed = pKeyboardState[SDL_SCANCODE_L];
+
+	if (wasLPressed && !isLPressed)
+	{
+		m_LodActive = !m_LodActive;
+
+		if (m_LodActive)
+			std::wcout << L"Level Of Detail ON\n";
+		else
+			std::wcout << L"Level Of Detail OFF\n";
+	}
+	wasLPressed = isLPressed;
 
+	// Picking
+	static bool wasMiddleMousePressed{ false };
+	int mouseX{}, mouseY{};
+	bool isMiddleMousePressed = (SDL_GetMouseState(&mouseX, &mouseY) & SDL_BUTTON_MMASK) != 0;
+
+	if (wasMiddleMousePressed && !isMiddleMousePressed)
+	{
+		PickObject(mouseX, mouseY);
+	}
+	wasMiddleMousePressed = isMiddleMousePressed;
+
+	// ------ HARDWARE ------
+	if (m_CurrentRasterizerMode == RasterizerMode::Hardware)
+	{
 		// Sampler State
 		static bool wasF4Pressed{ false };
 		bool isF4Pressed = pKeyboardState[SDL_SCANCODE_F4];
@@ -581,7 +1010,7 @@ void dae::Renderer::ProcessInput()
 		}
 		wasF4Pressed = isF4Pressed;
 	}
-	else // ------ SOFTWARE ONLY ------
+	else if (m_CurrentRasterizerMode == RasterizerMode::Software) // ------ SOFTWARE ONLY ------
 	{
 		// Switch Lighting Modes
 		static bool wasF5Pressed{ false };
@@ -629,7 +1058,7 @@ void dae::Renderer::ProcessInput()
 		}
 		wasF6Pressed = isF6Pressed;
 
-		// Depth Buffer Visualization
+		// Pixel Visualization (depth buffer + heatmaps)
 		static bool wasF7Pressed{ false };
 		bool isF7Pressed = pKeyboardState[SDL_SCANCODE_F7];
 
@@ -637,7 +1066,7 @@ void dae::Renderer::ProcessInput()
 		{
 			m_CurrentPixelColorState = static_cast<PixelColorState>(static_cast<int>(m_CurrentPixelColorState) + 1);
 
-			if (m_CurrentPixelColorState > PixelColorState::DepthBuffer)
+			if (m_CurrentPixelColorState > PixelColorState::TileTriangles)
 			{
 				m_CurrentPixelColorState = PixelColorState::FinalColor;
 			}
@@ -645,10 +1074,19 @@ void dae::Renderer::ProcessInput()
 			switch (m_CurrentPixelColorState)
 			{
 			case dae::Renderer::PixelColorState::FinalColor:
-				std::wcout << L"DepthBuffer Visualization OFF\n";
+				std::wcout << L"Pixel Visualization FINAL COLOR\n";
 				break;
 			case dae::Renderer::PixelColorState::DepthBuffer:
-				std::wcout << L"DepthBuffer Visualization ON\n";
+				std::wcout << L"Pixel Visualization DEPTH BUFFER\n";
+				break;
+			case dae::Renderer::PixelColorState::Overdraw:
+				std::wcout << L"Pixel Visualization OVERDRAW (blue = 1, red = 8+ shaded fragments)\n";
+				break;
+			case dae::Renderer::PixelColorState::TileShadingTime:
+				std::wcout << L"Pixel Visualization TILE SHADING TIME (red = slowest tile of the frame)\n";
+				break;
+			case dae::Renderer::PixelColorState::TileTriangles:
+				std::wcout << L"Pixel Visualization TILE TRIANGLES (blue = 1, red = 128+ triangles)\n";
 				break;
 			}
 		}
@@ -668,5 +1106,94 @@ void dae::Renderer::ProcessInput()
 				std::wcout << L"BoundingBox Visualization OFF\n";
 		}
 		wasF8Pressed = isF8Pressed;
+
+		// Transparency Mode
+		static bool wasTPressed{ false };
+		bool isTPressed = pKeyboardState[SDL_SCANCODE_T];
+
+		if (wasTPressed && !isTPressed)
+		{
+			m_CurrentTransparencyMode = static_cast<TransparencyMode>((static_cast<int>(m_CurrentTransparencyMode) + 1) % 2);
+
+			if (m_CurrentTransparencyMode == TransparencyMode::WeightedBlendedOIT)
+				std::wcout << L"Transparency Mode = WEIGHTED_BLENDED_OIT\n";
+			else
+				std::wcout << L"Transparency Mode = SORTED\n";
+		}
+		wasTPressed = isTPressed;
+
+		// Transparency Benchmark (runs once on the next frame)
+		static bool wasBPressed{ false };
+		bool isBPressed = pKeyboardState[SDL_SCANCODE_B];
+
+		if (wasBPressed && !isBPressed)
+		{
+			m_pSoftwareBackend->RequestTransparencyComparison(true);
+		}
+		wasBPressed = isBPressed;
+
+		// sRGB Encoding
+		static bool wasGPressed{ false };
+		bool isGPressed = pKeyboardState[SDL_SCANCODE_G];
+
+		if (wasGPressed && !isGPressed)
+		{
+			m_SRGBEncodingActive = !m_SRGBEncodingActive;
+
+			if (m_SRGBEncodingActive)
+				std::wcout << L"sRGB Encoding ON\n";
+			else
+				std::wcout << L"sRGB Encoding OFF\n";
+		}
+		wasGPressed = isGPressed;
+
+		// Present Mode
+		static bool wasPPressed{ false };
+		bool isPPressed = pKeyboardState[SDL_SCANCODE_P];
+
+		if (wasPPressed && !isPPressed)
+		{
+			if (!m_IsDirectPresentSupported)
+			{
+				std::wcout << L"Present Mode = BLIT (window surface format differs from the back buffer)\n";
+			}
+			else
+			{
+				m_CurrentPresentMode = static_cast<PresentMode>((static_cast<int>(m_CurrentPresentMode) + 1) % 2);
+
+				if (m_CurrentPresentMode == PresentMode::Direct)
+					std::wcout << L"Present Mode = DIRECT\n";
+				else
+					std::wcout << L"Present Mode = BLIT\n";
+			}
+		}
+		wasPPressed = isPPressed;
+
+		// Frames In Flight
+		static bool wasFPressed{ false };
+		bool isFPressed = pKeyboardState[SDL_SCANCODE_F];
+
+		if (wasFPressed && !isFPressed)
+		{
+			SetFramesInFlight(m_FramesInFlight % MAX_FRAMES_IN_FLIGHT + 1);
+
+			std::wcout << L"Frames In Flight = " << m_FramesInFlight << L"\n";
+		}
+		wasFPressed = isFPressed;
+
+		// Cluster Culling
+		static bool wasCPressed{ false };
+		bool isCPressed = pKeyboardState[SDL_SCANCODE_C];
+
+		if (wasCPressed && !isCPressed)
+		{
+			m_ClusterCullingActive = !m_ClusterCullingActive;
+
+			if (m_ClusterCullingActive)
+				std::wcout << L"Cluster Culling ON\n";
+			else
+				std::wcout << L"Cluster Culling OFF\n";
+		}
+		wasCPressed = isCPressed;
 	}
 }
@@ -1,27 +1,37 @@
 #pragma once
 // SDL Headers
 #include "SDL.h"
-#include "SDL_syswm.h"
 #include "SDL_surface.h"
 #include "SDL_image.h"
-// DirectX Headers
-#include <dxgi.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#include <d3dx11effect.h>
 // Framework Headers
 #include "Timer.h"
 
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include "Mesh.h" // Includes Mesh + dae structs + DataStructs + important enum classes
 #include "Camera.h"
+#include "PixelFormat.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareBackend.h"
+#include "NullBackend.h"
+#include "Benchmark.h"
+#include "BVH.h"
+#include "OcclusionBuffer.h"
+#if defined(DAE_D3D11)
+#include "D3D11Backend.h"
+#endif
 
 namespace dae
 {
 	class Renderer final
 	{
 	public:
-		Renderer(SDL_Window* pWindow);
+		// maxSubmeshVertices > 0 => the scene meshes are split into 16-bit submeshes of at most that many vertices (see AddMesh)
+		Renderer(SDL_Window* pWindow, VertexFormat vertexFormat = VertexFormat::Float32, uint32_t maxSubmeshVertices = 0);
+		Renderer(int width, int height, RasterizerMode rasterizerMode = RasterizerMode::Software,
+			VertexFormat vertexFormat = VertexFormat::Float32, uint32_t maxSubmeshVertices = 0); // Headless - no window, no D3D device, software or null
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -32,277 +42,156 @@ namespace dae
 		void Update(const Timer* pTimer);
 		void Render();
 
+		bool SaveFrame(const std::string& filePath) const; // .png or .ppm, last rendered software frame
+		std::vector<uint32_t> GetFramePixels() const; // Last rendered software frame, 0x00RRGGBB rows without padding
+
+		// Replaces Update in benchmark runs - camera and meshes follow the script, input is ignored
+		void ApplyBenchmarkFrame(const BenchmarkFrame& frame);
+		const char* GetBackendName() const;
+
+		float GetPresentTime() const { return m_PresentTime.load(std::memory_order_relaxed); }; // ms, last frame
+		float GetFrameLatency() const { return m_FrameLatency.load(std::memory_order_relaxed); }; // ms, start of Render -> frame on screen
+		void PrintBackendStats() const; // Command and state change counts of the null backend
+		PipelineStatistics GetPipelineStatistics() const; // Last frame - mesh counters for every backend, the rest software only
+		void PrintPipelineStatistics() const;
+
+		// Instancing - a mesh is registered and uploaded to every backend once, then drawn once per instance transform
+		// Instance transforms are applied after the world matrix of the mesh, a new mesh has a single identity instance
+		using MeshId = uint32_t;
+		// maxSubmeshVertices > 0 => Mesh::SplitInto16BitSubmeshes before anything is built from the indices, 0 keeps a single submesh
+		MeshId AddMesh(std::unique_ptr<Mesh> pMesh, BlendMode blendMode, uint32_t maxSubmeshVertices = 0);
+		void SetInstances(MeshId mesh, const std::vector<Matrix>& instanceTransforms); // Empty => the mesh isn't drawn
+
+		void SetLodActive(bool isLodActive) { m_LodActive = isLodActive; }; // Off => every mesh at full detail, also [L]
+		void SetTransparencyMode(SoftwareRasterizer::TransparencyMode transparencyMode) { m_CurrentTransparencyMode = transparencyMode; }; // Also [T]
+
+		// Software only - the next frame renders both transparency modes, the selected one stays on screen
+		void RequestTransparencyComparison() { m_pSoftwareBackend->RequestTransparencyComparison(false); };
+		const TransparencyComparison& GetTransparencyComparison() const { return m_pSoftwareBackend->GetTransparencyComparison(); };
+
 	private:
+		Renderer(SDL_Window* pWindow, int width, int height, RasterizerMode rasterizerMode, VertexFormat vertexFormat, uint32_t maxSubmeshVertices);
+
 		SDL_Window* m_pWindow{};
+		bool m_IsHeadless{ false };
 
 		int m_Width{};
 		int m_Height{};
 
 		Camera m_Camera{};
-		std::vector<std::unique_ptr<Mesh<OpaqueEffect>>> m_OpaqueMeshes{};
-		std::vector<std::unique_ptr<Mesh<TransparencyEffect>>> m_TransparentMeshes{};
+		VertexFormat m_VertexFormat{ VertexFormat::Float32 };
+
+		// A single copy of the object space data per mesh, whatever the instance count
+		struct SceneMesh
+		{
+			std::unique_ptr<Mesh> pMesh{};
+			BlendMode blendMode{ BlendMode::Opaque };
+			std::vector<Matrix> instanceTransforms{ Matrix{} };
+			BVH::ObjectId firstObject{}; // Instance i is object firstObject + i
+		};
+		std::vector<SceneMesh> m_SceneMeshes{};
+
+		// Every backend gets its own copy of the meshes, uploaded once by AddMesh, indexed by MeshId
+		struct BackendScene
+		{
+			RenderBackend* pBackend{};
+			std::vector<BackendMesh> meshes{};
+		};
+		BackendScene m_SoftwareScene{};
+		BackendScene m_NullScene{};
+		BackendScene m_D3D11Scene{};
+
+		std::vector<Matrix> m_InstanceBatch{}; // World matrices of the visible instances of one mesh, one instanced draw
+		void DrawScene(BackendScene& scene, const ColorRGB& clearColor, const Matrix& viewProjMatrix);
+
+		// Every instance of every mesh is one object of the scene BVH, ids are mesh by mesh, instance by instance
+		BVH m_SceneBVH{};
+		std::vector<MeshId> m_ObjectMeshes{};
+		std::vector<Matrix> m_ObjectWorldMatrices{};
+		std::vector<AABB> m_ObjectBoxes{};
+		std::vector<uint32_t> m_ObjectChunkStarts{};
+		std::vector<BVH::ObjectId> m_VisibleObjects{}; // Sorted => the instances of a mesh are next to each other
+		bool m_IsObjectLayoutDirty{ true }; // A mesh was added or its instance count changed, the ids moved
+		static constexpr uint32_t OBJECT_CHUNK_SIZE{ 256 };
+
+		const Mesh& GetObjectMesh(BVH::ObjectId object) const;
+		bool IsTransparentObject(BVH::ObjectId object) const;
+		void UpdateSceneBVH(); // World boxes of every object, then refit, the tree is only rebuilt when the ids moved
+		void CullSceneObjects(); // Frustum query nearest first, then the occlusion buffer, before the backends transform a single vertex
+		bool IsMeshVisible(const Mesh& mesh, const Matrix& worldMatrix) const; // Exact test for objects whose box touches a plane
+		void PickObject(int mouseX, int mouseY) const; // Prints the closest mesh under the cursor
+
+		// Level of detail per object, the coarsest whose simplification error stays below LOD_PIXEL_ERROR on screen
+		// Thresholds are sizes of the projected bounding sphere, a level only changes once the size moved LOD_HYSTERESIS past one
+		std::vector<uint8_t> m_ObjectLods{}; // Kept between frames for the hysteresis
+		static constexpr float LOD_PIXEL_ERROR{ 0.5f };
+		static constexpr float LOD_HYSTERESIS{ 0.1f };
+		uint8_t SelectObjectLod(BVH::ObjectId object);
+
+		// Visible opaque meshes become occluders for everything behind them, filled during the frustum query
+		std::unique_ptr<OcclusionBuffer> m_pOcclusionBuffer{};
+
+		PipelineStatistics m_SceneStatistics{}; // Mesh counters of the last frame, every backend
+
+		// --- NULL ---
+		std::unique_ptr<NullBackend> m_pNullBackend{};
 
 		// --- SOFTWARE ---
 		SDL_Surface* m_pFrontBuffer{ nullptr };
 		SDL_Surface* m_pBackBuffer{ nullptr };
-		uint32_t* m_pBackBufferPixels{};
-
-		std::unique_ptr<float[]> m_pDepthBufferPixels{};
-
-		std::vector<VertexOut> m_TransformedMeshVertices{};
+		std::unique_ptr<SoftwareBackend> m_pSoftwareBackend{};
 
-		template <typename MeshType>
-		inline void RenderSoftwareMesh(const MeshType& mesh, const Matrix& viewProjMatrix)
+		// Present - Direct rasterizes straight into the window surface, Blit copies the back buffer into it
+		enum class PresentMode
 		{
-			Matrix worldViewProjectionMatrix{ mesh.GetWorldMatrix() * viewProjMatrix };
-
-			m_TransformedMeshVertices.clear();
-
-			VertexTransformationFunction(mesh.GetVertices(), m_TransformedMeshVertices, worldViewProjectionMatrix, mesh.GetWorldMatrix());
-
-			const auto& meshIndices{ mesh.GetIndices() };
-
-			if (mesh.GetMeshPrimitiveTopology() == PrimitiveTopology::TriangleList)
-			{
-				for (size_t i{}; i < meshIndices.size(); i += 3)
-				{
-					std::array<VertexOut, 3> screenTri{ m_TransformedMeshVertices[meshIndices[i]],
-						m_TransformedMeshVertices[meshIndices[i + 1]],
-						m_TransformedMeshVertices[meshIndices[i + 2]] };
-
-					if (!PassTriangleOptimizations(screenTri))
-						continue; // Skip triangle
-
-					RasterizationStage(mesh, screenTri);
-				}
-			}
-			else
-			{
-				for (size_t i = 0; i < meshIndices.size() - 2; ++i)
-				{
-					std::array<VertexOut, 3> screenTri{};
-
-					if (i & 1)
-					{
-						screenTri = { m_TransformedMeshVertices[meshIndices[i]],
-						m_TransformedMeshVertices[meshIndices[i + 2]],
-						m_TransformedMeshVertices[meshIndices[i + 1]] };
-					}
-					else
-					{
-						screenTri = { m_TransformedMeshVertices[meshIndices[i]],
-						m_TransformedMeshVertices[meshIndices[i + 1]],
-						m_TransformedMeshVertices[meshIndices[i + 2]] };
-					}
-
-					if (!PassTriangleOptimizations(screenTri))
-						continue; // Skip triangle
-
-					RasterizationStage(mesh, screenTri);
-				}
-			}
-			
-		}
-
-		template <typename MeshType>
-		inline void RasterizationStage(const MeshType& mesh, const std::array<VertexOut, 3> screenTri)
-		{
-			// ---- Bounding Box -----
-			std::pair<int, int> topLeft{ static_cast<int>(std::floor(
-				std::min({screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x}))),
-				static_cast<int>(std::floor(
-					std::min({screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y}))) };
-			topLeft.first = std::max(topLeft.first, 0);
-			topLeft.second = std::max(topLeft.second, 0);
-
-			std::pair<int, int> bottomRight{ static_cast<int>(std::ceil(
-				std::max({screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x}))),
-				static_cast<int>(std::ceil(
-					std::max({screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y}))) };
-			bottomRight.first = std::min(bottomRight.first, m_Width - 1);
-			bottomRight.second = std::min(bottomRight.second, m_Height - 1);
-
-			if (m_ShowBoundingBox)
-			{
-				FillRectangle(topLeft.first, topLeft.second, bottomRight.first, bottomRight.second, ColorRGB{ 1.f, 1.f, 1.f });
-			}
-			else
-			{
-				// PIXEL LOOP - Bounding Box
-				for (int px{ topLeft.first }; px <= bottomRight.first; ++px)
-				{
-					for (int py{ int(topLeft.second) }; py <= bottomRight.second; ++py)
-					{
-						ColorRGB finalColor{};
-
-						VertexIn pixel{ Vector3{ static_cast<float>(px) + 0.5f,
-							static_cast<float>(py) + 0.5f, 1.f} }; // We check from the center of the pixel, hence +0.5f
-
-						std::array<float, 3> triangleAreaRatios;
-
-						// INSIDE - OUTSIDE TEST + Depth Interpolation
-						bool pixelInTriangle{ IsPixelIn_Triangle(screenTri, pixel, triangleAreaRatios) };
-
-						if (pixelInTriangle)
-						{
-							int currentPixelNr{ GetPixelNumber(px, py, m_Width) };
-
-							// Depth Test
-							if (pixel.position.z < m_pDepthBufferPixels[currentPixelNr])
-							{
-								if (m_CurrentCullMode != CullMode::Front)
-								{
-									// Depth Write
-									m_pDepthBufferPixels[currentPixelNr] = pixel.position.z;
-								}
-
-								// UV, Normal, Tangent, ViewDirection Interpolation
-								InterpolateVertex(triangleAreaRatios, screenTri, pixel);
-
-								ColorRGB pixelColor{ mesh.GetDiffuseTexture()->Sample(pixel.UVCoordinate) };
-
-								// ----- SHADING -----
-								pixelColor = PixelShading(pixel, mesh, pixelColor);
-
-								switch (m_CurrentPixelColorState)
-								{
-								case dae::Renderer::PixelColorState::FinalColor:
-									finalColor = pixelColor;
-									break;
-								case dae::Renderer::PixelColorState::DepthBuffer:
-									ColorRGB depthValue{ RemapValue(pixel.position.z, 0.997f) };
-									finalColor = depthValue;
-									break;
-								}
-
-								// ---- Render only if overwriting pixel ----
-								//Update Color in Buffer
-								finalColor.MaxToOne();
-
-								m_pBackBufferPixels[currentPixelNr] = SDL_MapRGB(m_pBackBuffer->format,
-									static_cast<uint8_t>(finalColor.r * 255),
-									static_cast<uint8_t>(finalColor.g * 255),
-									static_cast<uint8_t>(finalColor.b * 255));
-							}
-						}
-					}
-				}
-			}
-		}
-
-		void VertexTransformationFunction(const std::vector<VertexIn>& vertices_in, std::vector<VertexOut>& vertices_out, 
-			const Matrix& WVPMatrix, const Matrix& meshWorldMatrix);
-
-		bool PassTriangleOptimizations(const std::array<VertexOut, 3> screenTri) const;
-
-		template <typename MeshType>
-		inline ColorRGB PixelShading(const VertexIn& pixel, const MeshType& mesh, const ColorRGB& pixelColor) const
+			Blit,
+			Direct
+		};
+		PresentMode m_CurrentPresentMode{ PresentMode::Blit };
+		bool m_IsDirectPresentSupported{ false };
+		SDL_Surface* m_pRenderTargetSurface{ nullptr };
+		std::atomic<float> m_PresentTime{};
+		std::atomic<float> m_FrameLatency{};
+
+		bool IsDirectPresentSupported() const;
+
+		// Pipelined Frames - with more than one frame in flight, the raster thread renders frame N+1 while the main thread presents frame N
+		// Window calls never leave the main thread, only color is buffered, depth and tile flags are never read after a frame is done
+		static constexpr int MAX_FRAMES_IN_FLIGHT{ 3 };
+		struct FinishedFrame
 		{
-			ColorRGB finalShadedColor{};
-			const Vector3 lightDirection{ -Vector3{0.577f, -0.577f, 0.577f}.Normalized() }; // Inverted Light
-			constexpr float lightIntensity{ 1.f };
-
-			Vector3 finalNormal{ pixel.normal };
-
-			// Normal Map Sampling
-			if (mesh.GetNormalTexture() && m_ShowNormalMap)
-			{
-				const Vector3 binormal{ Vector3::Cross(pixel.normal, pixel.tangent) };
-
-				// Tangent -> World
-				const Matrix tangentSpaceMatrix{ pixel.tangent, binormal, pixel.normal, {} };
-
-				// Get Normal from map
-				const ColorRGB sampledNormalColor{ mesh.GetNormalTexture()->Sample(pixel.UVCoordinate) };
-
-				// Convert Normal to Tangent space
-				const Vector3 tangentSpaceNormal{
-					sampledNormalColor.r * 2.f - 1.f,
-					sampledNormalColor.g * 2.f - 1.f,
-					sampledNormalColor.b * 2.f - 1.f
-				};
-
-				// Tangent Space to World Space USING the TBN matrix
-				finalNormal = tangentSpaceMatrix.TransformVector(tangentSpaceNormal).Normalized();
-			}
-
-			// Lambert Diffuse
-			const float cosTheta{ std::min(1.f, std::max(0.f, Vector3::Dot(lightDirection, finalNormal))) };
-			const ColorRGB lambertDiffuse{ pixelColor };
-
-
-			const ColorRGB lambertColor(GetLambertColor(lambertDiffuse, cosTheta) * lightIntensity);
-
-			// Specular Color
-			ColorRGB specularColor{ colors::Black };
-			if (m_CurrentLightingMode == LightingMode::Specular || m_CurrentLightingMode == LightingMode::Combined)
-			{
-				if (mesh.GetSpecularTexture() && mesh.GetGlossTexture())
-				{
-					const ColorRGB sampledSpecular{ mesh.GetSpecularTexture()->Sample(pixel.UVCoordinate) };
-					const ColorRGB sampledGlossiness{ mesh.GetGlossTexture()->Sample(pixel.UVCoordinate) };
-
-					constexpr float shininess{ 25.f };
-					const float phongExponent{ sampledGlossiness.r * shininess };
-
-					specularColor = Phong(sampledSpecular, sampledSpecular.r, phongExponent,
-						lightDirection, pixel.viewDirection.Normalized(), finalNormal) * lightIntensity;
-				}
-			}
-
-			// Ambient Color
-			constexpr float ambientStrength{ 0.025f };
-			const ColorRGB ambientColor{ lambertDiffuse * ambientStrength };
-			finalShadedColor += ambientColor;
-
-			switch (m_CurrentLightingMode)
-			{
-			case dae::Renderer::LightingMode::ObservedArea:
-				finalShadedColor = ColorRGB{ cosTheta, cosTheta, cosTheta };
-				break;
-			case dae::Renderer::LightingMode::Diffuse:
-				finalShadedColor = lambertColor;
-				break;
-			case dae::Renderer::LightingMode::Specular:
-				finalShadedColor = specularColor;
-				break;
-			case dae::Renderer::LightingMode::Combined:
-				finalShadedColor = lambertColor + specularColor;
-				break;
-			}
-
-			return finalShadedColor;
-		}
-
-		void FillRectangle(int x0, int y0, int x1, int y1, const ColorRGB& color) const;
-
-		// --- HARDWARE ---
-		bool m_IsDXInitialized{ false };
-
-		ID3D11SamplerState* m_pPointSampler{};
-		ID3D11SamplerState* m_pLinearSampler{};
-		ID3D11SamplerState* m_pAnisotropicSampler{};
-		ID3D11SamplerState* m_CurrentSampler{};
-
-		ID3D11RasterizerState* m_pRasterizerBack{};
-		ID3D11RasterizerState* m_pRasterizerFront{};
-		ID3D11RasterizerState* m_pRasterizerNone{};
-		ID3D11RasterizerState* m_pCurrentRasterizer{};
-
-		void CreateSamplerStates(ID3D11Device* pDevice);
+			int frameIndex{};
+			std::chrono::high_resolution_clock::time_point renderStart{};
+		};
 
-		// DIRECTX
-		HRESULT InitializeDirectX();
-		ID3D11Device* m_pDevice{};
-		ID3D11DeviceContext* m_pDeviceContext{};
+		int m_FramesInFlight{ 1 };
+		int m_CurrentFrameIndex{};
+		std::array<SDL_Surface*, MAX_FRAMES_IN_FLIGHT> m_FrameSurfaces{}; // Created the first time more than one frame is in flight
+		std::array<FinishedFrame, MAX_FRAMES_IN_FLIGHT> m_QueuedFrames{}; // Oldest first, waiting for present
+		int m_NumQueuedFrames{};
 
-		IDXGISwapChain* m_pSwapChain{};
+		// DrawScene of the current frame, handed to the raster thread, the main thread sleeps on m_IsRasterPending once it presented
+		struct RasterJob
+		{
+			BackendScene* pScene{};
+			ColorRGB clearColor{};
+			Matrix viewProjMatrix{};
+		};
+		RasterJob m_RasterJob{};
+		std::atomic<bool> m_IsRasterPending{ false };
+		std::atomic<bool> m_IsRasterThreadRunning{ false };
+		std::thread m_RasterThread{};
 
-		ID3D11Texture2D* m_pDepthStencilBuffer{};
-		ID3D11DepthStencilView* m_pDepthStencilView{};
+		void RasterThreadLoop();
+		void PresentOldestFrame();
+		void PresentQueuedFrames();
+		void SetFramesInFlight(int framesInFlight);
 
-		ID3D11Texture2D* m_pRenderTargetBuffer{};
-		ID3D11RenderTargetView* m_pRenderTargetView{};
+		// --- HARDWARE ---
+		bool m_IsDXInitialized{ false };
+#if defined(DAE_D3D11)
+		std::unique_ptr<D3D11Backend> m_pD3D11Backend{};
+#endif
 
 		void ProcessInput();
 
@@ -316,29 +205,31 @@ namespace dae
 
 		CullMode m_CurrentCullMode;
 		
-		// --- HARDWARE ---
 		bool m_ShowFireMesh;
+
+		bool m_OcclusionCullingActive;
+
+		bool m_LodActive;
+
+		// --- HARDWARE ---
 		SamplerType m_CurrentSamplerType;
 
 		// --- SOFTWARE ---
-		enum class LightingMode
-		{
-			ObservedArea,
-			Diffuse,
-			Specular,
-			Combined
-		};
+		using LightingMode = SoftwareRasterizer::LightingMode;
 		LightingMode m_CurrentLightingMode;
 
 		bool m_ShowNormalMap;
 
-		enum class PixelColorState
-		{
-			FinalColor,
-			DepthBuffer
-		};
+		using PixelColorState = SoftwareRasterizer::PixelColorState;
 		PixelColorState m_CurrentPixelColorState;
 
 		bool m_ShowBoundingBox;
+
+		bool m_SRGBEncodingActive;
+
+		using TransparencyMode = SoftwareRasterizer::TransparencyMode;
+		TransparencyMode m_CurrentTransparencyMode;
+
+		bool m_ClusterCullingActive;
 	};
 }
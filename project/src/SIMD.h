@@ -0,0 +1,168 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+// SSE on every x86/x64 target, AVX + FMA when the compiler is allowed to use them (DAE_AVX2_ENABLED in CMake)
+// Other targets fall back to the scalar code paths
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DAE_SIMD_SSE
+	#include <immintrin.h>
+#endif
+
+#if defined(DAE_SIMD_SSE) && defined(__AVX__)
+	#define DAE_SIMD_AVX
+#endif
+
+#if defined(DAE_SIMD_SSE) && (defined(__FMA__) || defined(__AVX2__))
+	#define DAE_SIMD_FMA
+#endif
+
+namespace dae
+{
+#if defined(DAE_SIMD_SSE)
+	// a * b + c, one rounding with FMA
+	inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+	{
+#if defined(DAE_SIMD_FMA)
+		return _mm_fmadd_ps(a, b, c);
+#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+	}
+
+	// 8 x 16-bit integers widened to two registers of 4 x 32-bit floats
+	inline void LoadUint16x8(const uint16_t* p, __m128& lo, __m128& hi)
+	{
+		const __m128i packed{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+		lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+		hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, _mm_setzero_si128()));
+	}
+
+	inline void LoadInt16x8(const int16_t* p, __m128& lo, __m128& hi)
+	{
+		const __m128i packed{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+		lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16)); // Sign extension
+		hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16));
+	}
+
+	// Finite halves only - the magnitude bits become a float that is 2^112 too small, subnormals included
+	inline __m128 HalfToFloat4(__m128i halves)
+	{
+		const __m128i magnitude{ _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x7FFF)), 13) };
+		const __m128i sign{ _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x8000)), 16) };
+		const __m128 scaled{ _mm_mul_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(_mm_set1_epi32(0x77800000))) };
+		return _mm_or_ps(scaled, _mm_castsi128_ps(sign));
+	}
+
+	inline void LoadHalfx8(const uint16_t* p, __m128& lo, __m128& hi)
+	{
+		const __m128i packed{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+		lo = HalfToFloat4(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+		hi = HalfToFloat4(_mm_unpackhi_epi16(packed, _mm_setzero_si128()));
+	}
+#endif
+
+	float HalfToFloat(uint16_t value); // VertexFormat.cpp
+
+	// 8 lanes per operation - one AVX register, two SSE registers or a plain loop
+	// Every operation rounds like its scalar float counterpart => batched kernels match the per-element code bit for bit
+	struct Float8 final
+	{
+		static constexpr int WIDTH{ 8 };
+
+#if defined(DAE_SIMD_AVX)
+		__m256 v;
+
+		static Float8 Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+		static Float8 Set(float value) { return { _mm256_set1_ps(value) }; }
+		void Store(float* p) const { _mm256_storeu_ps(p, v); }
+
+		Float8 operator+(const Float8& o) const { return { _mm256_add_ps(v, o.v) }; }
+		Float8 operator-(const Float8& o) const { return { _mm256_sub_ps(v, o.v) }; }
+		Float8 operator*(const Float8& o) const { return { _mm256_mul_ps(v, o.v) }; }
+		Float8 operator/(const Float8& o) const { return { _mm256_div_ps(v, o.v) }; }
+
+		static Float8 LoadUint16(const uint16_t* p) { __m128 lo, hi; LoadUint16x8(p, lo, hi); return { _mm256_set_m128(hi, lo) }; }
+		static Float8 LoadInt16(const int16_t* p) { __m128 lo, hi; LoadInt16x8(p, lo, hi); return { _mm256_set_m128(hi, lo) }; }
+		static Float8 LoadHalf(const uint16_t* p) { __m128 lo, hi; LoadHalfx8(p, lo, hi); return { _mm256_set_m128(hi, lo) }; }
+
+		static Float8 Sqrt(const Float8& a) { return { _mm256_sqrt_ps(a.v) }; }
+		static Float8 Max(const Float8& a, const Float8& b) { return { _mm256_max_ps(a.v, b.v) }; }
+		static Float8 Abs(const Float8& a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v) }; }
+		static Float8 CopySign(const Float8& magnitude, const Float8& sign) // Sign bit of sign => -0 counts as negative
+		{
+			const __m256 signMask{ _mm256_set1_ps(-0.f) };
+			return { _mm256_or_ps(_mm256_andnot_ps(signMask, magnitude.v), _mm256_and_ps(signMask, sign.v)) };
+		}
+		static Float8 MultiplyAdd(const Float8& a, const Float8& b, const Float8& c)
+		{
+#if defined(DAE_SIMD_FMA)
+			return { _mm256_fmadd_ps(a.v, b.v, c.v) };
+#else
+			return { _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v) };
+#endif
+		}
+#elif defined(DAE_SIMD_SSE)
+		__m128 lo;
+		__m128 hi;
+
+		static Float8 Load(const float* p) { return { _mm_loadu_ps(p), _mm_loadu_ps(p + 4) }; }
+		static Float8 Set(float value) { return { _mm_set1_ps(value), _mm_set1_ps(value) }; }
+		void Store(float* p) const { _mm_storeu_ps(p, lo); _mm_storeu_ps(p + 4, hi); }
+
+		Float8 operator+(const Float8& o) const { return { _mm_add_ps(lo, o.lo), _mm_add_ps(hi, o.hi) }; }
+		Float8 operator-(const Float8& o) const { return { _mm_sub_ps(lo, o.lo), _mm_sub_ps(hi, o.hi) }; }
+		Float8 operator*(const Float8& o) const { return { _mm_mul_ps(lo, o.lo), _mm_mul_ps(hi, o.hi) }; }
+		Float8 operator/(const Float8& o) const { return { _mm_div_ps(lo, o.lo), _mm_div_ps(hi, o.hi) }; }
+
+		static Float8 LoadUint16(const uint16_t* p) { Float8 r; LoadUint16x8(p, r.lo, r.hi); return r; }
+		static Float8 LoadInt16(const int16_t* p) { Float8 r; LoadInt16x8(p, r.lo, r.hi); return r; }
+		static Float8 LoadHalf(const uint16_t* p) { Float8 r; LoadHalfx8(p, r.lo, r.hi); return r; }
+
+		static Float8 Sqrt(const Float8& a) { return { _mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi) }; }
+		static Float8 Max(const Float8& a, const Float8& b) { return { _mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi) }; }
+		static Float8 Abs(const Float8& a)
+		{
+			const __m128 signMask{ _mm_set1_ps(-0.f) };
+			return { _mm_andnot_ps(signMask, a.lo), _mm_andnot_ps(signMask, a.hi) };
+		}
+		static Float8 CopySign(const Float8& magnitude, const Float8& sign) // Sign bit of sign => -0 counts as negative
+		{
+			const __m128 signMask{ _mm_set1_ps(-0.f) };
+			return { _mm_or_ps(_mm_andnot_ps(signMask, magnitude.lo), _mm_and_ps(signMask, sign.lo)),
+				_mm_or_ps(_mm_andnot_ps(signMask, magnitude.hi), _mm_and_ps(signMask, sign.hi)) };
+		}
+		static Float8 MultiplyAdd(const Float8& a, const Float8& b, const Float8& c)
+		{
+			return { dae::MultiplyAdd(a.lo, b.lo, c.lo), dae::MultiplyAdd(a.hi, b.hi, c.hi) };
+		}
+#else
+		float v[WIDTH];
+
+		static Float8 Load(const float* p) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = p[i]; return r; }
+		static Float8 Set(float value) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = value; return r; }
+		void Store(float* p) const { for (int i{}; i < WIDTH; ++i) p[i] = v[i]; }
+
+		Float8 operator+(const Float8& o) const { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = v[i] + o.v[i]; return r; }
+		Float8 operator-(const Float8& o) const { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = v[i] - o.v[i]; return r; }
+		Float8 operator*(const Float8& o) const { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = v[i] * o.v[i]; return r; }
+		Float8 operator/(const Float8& o) const { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = v[i] / o.v[i]; return r; }
+
+		static Float8 LoadUint16(const uint16_t* p) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = static_cast<float>(p[i]); return r; }
+		static Float8 LoadInt16(const int16_t* p) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = static_cast<float>(p[i]); return r; }
+		static Float8 LoadHalf(const uint16_t* p) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = HalfToFloat(p[i]); return r; }
+
+		static Float8 Sqrt(const Float8& a) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = std::sqrt(a.v[i]); return r; }
+		static Float8 Max(const Float8& a, const Float8& b) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = std::max(a.v[i], b.v[i]); return r; }
+		static Float8 Abs(const Float8& a) { Float8 r; for (int i{}; i < WIDTH; ++i) r.v[i] = std::abs(a.v[i]); return r; }
+		static Float8 CopySign(const Float8& magnitude, const Float8& sign)
+		{
+			Float8 r;
+			for (int i{}; i < WIDTH; ++i) r.v[i] = std::copysign(magnitude.v[i], sign.v[i]);
+			return r;
+		}
+		static Float8 MultiplyAdd(const Float8& a, const Float8& b, const Float8& c) { return a * b + c; }
+#endif
+	};
+}
@@ -0,0 +1,254 @@
+#include "SoftwareBackend.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace dae;
+
+SoftwareBackend::SoftwareBackend(int width, int height) :
+	m_Rasterizer{ width, height }
+{
+}
+
+BufferHandle SoftwareBackend::CreateVertexBuffer(const std::vector<VertexIn>& vertices)
+{
+	m_VertexBuffers.emplace_back(std::make_unique<VertexStreams>(VertexStreams::FromVertices(vertices)));
+	return static_cast<BufferHandle>(m_VertexBuffers.size());
+}
+
+BufferHandle SoftwareBackend::CreateVertexBuffer(const QuantizedVertexBuffer& vertices)
+{
+	m_VertexBuffers.emplace_back(std::make_unique<VertexStreams>(VertexStreams::FromVertices(vertices)));
+	return static_cast<BufferHandle>(m_VertexBuffers.size());
+}
+
+BufferHandle SoftwareBackend::CreateIndexBuffer(const std::vector<uint16_t>& indices)
+{
+	m_IndexBuffers.emplace_back(IndexBufferView{ indices.data(), IndexFormat::UInt16 });
+	return static_cast<BufferHandle>(m_IndexBuffers.size());
+}
+
+BufferHandle SoftwareBackend::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+{
+	m_IndexBuffers.emplace_back(IndexBufferView{ indices.data(), IndexFormat::UInt32 });
+	return static_cast<BufferHandle>(m_IndexBuffers.size());
+}
+
+TextureHandle SoftwareBackend::CreateTexture(const Texture* pTexture)
+{
+	if (!pTexture)
+		return INVALID_HANDLE;
+
+	m_Textures.emplace_back(pTexture);
+	return static_cast<TextureHandle>(m_Textures.size());
+}
+
+BufferHandle SoftwareBackend::CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat)
+{
+	m_VertexBuffers.emplace_back(std::make_unique<VertexStreams>(vertexFormat == VertexFormat::Quantized ?
+		VertexStreams::FromVertices(QuantizeVertices(meshlets.vertices)) : VertexStreams::FromVertices(meshlets.vertices)));
+
+	m_MeshletBuffers.emplace_back(MeshletBufferView{ m_VertexBuffers.back().get(), &meshlets });
+	return static_cast<BufferHandle>(m_MeshletBuffers.size());
+}
+
+void SoftwareBackend::BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos)
+{
+	m_HasTransparentDraws = false;
+
+	m_Rasterizer.BeginFrame(m_pColorTarget, PackColor(clearColor), viewProjMatrix, cameraPos, m_Settings);
+}
+
+void SoftwareBackend::EndFrame()
+{
+	// Transparent draws were only gathered, blend them on top of every opaque draw
+	if (m_HasTransparentDraws)
+	{
+		if (m_CompareTransparencyRequested)
+		{
+			m_CompareTransparencyRequested = false;
+			m_TransparencyComparison = m_Rasterizer.CompareTransparencyModes();
+
+			if (m_PrintTransparencyComparison)
+			{
+				std::wcout << L"**TRANSPARENCY BENCHMARK** (" << m_TransparencyComparison.numTriangles << L" triangles)\n";
+				std::wcout << L">> SORTED = " << m_TransparencyComparison.sortedTime << L" ms\n";
+				std::wcout << L">> WEIGHTED BLENDED OIT = " << m_TransparencyComparison.oitTime << L" ms\n";
+				std::wcout << L">> MEAN CHANNEL ERROR = " << m_TransparencyComparison.meanChannelError
+					<< L" | MAX CHANNEL ERROR = " << m_TransparencyComparison.maxChannelError << L"\n";
+			}
+		}
+		else
+		{
+			m_Rasterizer.RenderTransparentTriangles();
+		}
+	}
+
+	m_Rasterizer.EndFrame();
+}
+
+void SoftwareBackend::RequestTransparencyComparison(bool isPrinted)
+{
+	m_CompareTransparencyRequested = true;
+	m_PrintTransparencyComparison = isPrinted;
+	m_TransparencyComparison = TransparencyComparison{};
+}
+
+void SoftwareBackend::SetPipelineState(const PipelineState& pipelineState)
+{
+	m_PipelineState = pipelineState;
+
+	// Cull mode drives the depth write of the software path
+	m_Rasterizer.SetCullMode(pipelineState.cullMode);
+}
+
+void SoftwareBackend::SetVertexBuffer(BufferHandle vertexBuffer)
+{
+	m_DrawCall.pVertices = vertexBuffer != INVALID_HANDLE ? m_VertexBuffers[vertexBuffer - 1].get() : nullptr;
+}
+
+void SoftwareBackend::SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology)
+{
+	const IndexBufferView indexBufferView{ indexBuffer != INVALID_HANDLE ? m_IndexBuffers[indexBuffer - 1] : IndexBufferView{ nullptr, IndexFormat::UInt32 } };
+	m_DrawCall.pIndices = indexBufferView.pIndices;
+	m_DrawCall.indexFormat = indexBufferView.format;
+	m_DrawCall.topology = topology;
+}
+
+void SoftwareBackend::SetTexture(TextureSlot slot, TextureHandle texture)
+{
+	const Texture* pTexture{ texture != INVALID_HANDLE ? m_Textures[texture - 1] : nullptr };
+
+	switch (slot)
+	{
+	case TextureSlot::Diffuse:
+		m_DrawCall.pDiffuseTexture = pTexture;
+		break;
+	case TextureSlot::Normal:
+		m_DrawCall.pNormalTexture = pTexture;
+		break;
+	case TextureSlot::Specular:
+		m_DrawCall.pSpecularTexture = pTexture;
+		break;
+	case TextureSlot::Gloss:
+		m_DrawCall.pGlossTexture = pTexture;
+		break;
+	default:
+		break;
+	}
+}
+
+void SoftwareBackend::SetWorldMatrix(const Matrix& worldMatrix)
+{
+	m_DrawCall.worldMatrix = worldMatrix;
+}
+
+void SoftwareBackend::SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	m_pInstanceTransforms = pWorldMatrices;
+	m_InstanceCount = instanceCount;
+}
+
+void SoftwareBackend::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	if (!m_DrawCall.pVertices || !m_DrawCall.pIndices || !m_DrawCall.pDiffuseTexture)
+		return;
+
+	m_DrawCall.indexCount = indexCount;
+	m_DrawCall.startIndex = startIndex;
+	m_DrawCall.baseVertex = baseVertex;
+	m_DrawCall.pMeshlets = nullptr;
+
+	Submit(m_DrawCall);
+}
+
+void SoftwareBackend::DrawMeshlets(BufferHandle meshletBuffer)
+{
+	if (meshletBuffer == INVALID_HANDLE || !m_DrawCall.pDiffuseTexture)
+		return;
+
+	// Bound textures and world matrix, the meshlets replace the bound buffers for this draw only
+	SoftwareRasterizer::DrawCall drawCall{ m_DrawCall };
+	drawCall.pVertices = m_MeshletBuffers[meshletBuffer - 1].pVertices;
+	drawCall.pMeshlets = m_MeshletBuffers[meshletBuffer - 1].pMeshlets;
+
+	Submit(drawCall);
+}
+
+void SoftwareBackend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex)
+{
+	if (!m_DrawCall.pVertices || !m_DrawCall.pIndices || !m_DrawCall.pDiffuseTexture || !m_pInstanceTransforms)
+		return;
+
+	SoftwareRasterizer::DrawCall drawCall{ m_DrawCall };
+	drawCall.indexCount = indexCount;
+	drawCall.startIndex = startIndex;
+	drawCall.baseVertex = baseVertex;
+	drawCall.pMeshlets = nullptr;
+
+	SubmitInstanced(drawCall, instanceCount);
+}
+
+// One instanced draw per submesh would transform every instance once per submesh
+void SoftwareBackend::DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount)
+{
+	if (!m_DrawCall.pVertices || !m_DrawCall.pIndices || !m_DrawCall.pDiffuseTexture || !m_pInstanceTransforms)
+		return;
+
+	SoftwareRasterizer::DrawCall drawCall{ m_DrawCall };
+	drawCall.pSubmeshes = submeshes.data();
+	drawCall.submeshCount = static_cast<uint32_t>(submeshes.size());
+	drawCall.pMeshlets = nullptr;
+
+	SubmitInstanced(drawCall, instanceCount);
+}
+
+void SoftwareBackend::DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount)
+{
+	if (meshletBuffer == INVALID_HANDLE || !m_DrawCall.pDiffuseTexture || !m_pInstanceTransforms)
+		return;
+
+	// Cluster culling runs per instance, it tests the meshlet bounds against the world matrix of the instance
+	SoftwareRasterizer::DrawCall drawCall{ m_DrawCall };
+	drawCall.pVertices = m_MeshletBuffers[meshletBuffer - 1].pVertices;
+	drawCall.pMeshlets = m_MeshletBuffers[meshletBuffer - 1].pMeshlets;
+
+	SubmitInstanced(drawCall, instanceCount);
+}
+
+void SoftwareBackend::Submit(const SoftwareRasterizer::DrawCall& drawCall)
+{
+	if (m_PipelineState.blendMode == BlendMode::Transparent)
+	{
+		if (!m_HasTransparentDraws)
+		{
+			m_HasTransparentDraws = true;
+			m_Rasterizer.BeginTransparentPass();
+		}
+
+		m_Rasterizer.GatherTransparent(drawCall);
+	}
+	else
+	{
+		m_Rasterizer.Draw(drawCall);
+	}
+}
+
+void SoftwareBackend::SubmitInstanced(const SoftwareRasterizer::DrawCall& drawCall, uint32_t instanceCount)
+{
+	instanceCount = std::min(instanceCount, m_InstanceCount);
+
+	if (m_PipelineState.blendMode == BlendMode::Transparent)
+	{
+		if (!m_HasTransparentDraws)
+		{
+			m_HasTransparentDraws = true;
+			m_Rasterizer.BeginTransparentPass();
+		}
+
+		m_Rasterizer.GatherTransparentInstanced(drawCall, m_pInstanceTransforms, instanceCount);
+	}
+	else
+	{
+		m_Rasterizer.DrawInstanced(drawCall, m_pInstanceTransforms, instanceCount);
+	}
+}
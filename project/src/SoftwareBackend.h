@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <memory>
+
+#include "RenderBackend.h"
+#include "SoftwareRasterizer.h"
+
+namespace dae
+{
+	// CPU backend - index buffers and textures are views on the CPU mesh data, vertex buffers are converted to SoA streams once
+	// Draws go straight into the SoftwareRasterizer
+	class SoftwareBackend final : public RenderBackend
+	{
+	public:
+		SoftwareBackend(int width, int height);
+		virtual ~SoftwareBackend() override = default;
+
+		SoftwareBackend(const SoftwareBackend&) = delete;
+		SoftwareBackend(SoftwareBackend&&) noexcept = delete;
+		SoftwareBackend& operator=(const SoftwareBackend&) = delete;
+		SoftwareBackend& operator=(SoftwareBackend&&) noexcept = delete;
+
+		virtual const char* GetName() const override { return "Software"; };
+
+		virtual BufferHandle CreateVertexBuffer(const std::vector<VertexIn>& vertices) override;
+		virtual BufferHandle CreateVertexBuffer(const QuantizedVertexBuffer& vertices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint16_t>& indices) override;
+		virtual BufferHandle CreateIndexBuffer(const std::vector<uint32_t>& indices) override;
+		virtual TextureHandle CreateTexture(const Texture* pTexture) override;
+		virtual BufferHandle CreateMeshletBuffer(const MeshletMesh& meshlets, VertexFormat vertexFormat) override;
+
+		virtual void BeginFrame(const ColorRGB& clearColor, const Matrix& viewProjMatrix, const Vector3& cameraPos) override;
+		virtual void EndFrame() override;
+
+		virtual void SetPipelineState(const PipelineState& pipelineState) override;
+		virtual void SetVertexBuffer(BufferHandle vertexBuffer) override;
+		virtual void SetIndexBuffer(BufferHandle indexBuffer, PrimitiveTopology topology) override;
+		virtual void SetTexture(TextureSlot slot, TextureHandle texture) override;
+		virtual void SetWorldMatrix(const Matrix& worldMatrix) override;
+		virtual void SetInstanceTransforms(const Matrix* pWorldMatrices, uint32_t instanceCount) override;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawMeshlets(BufferHandle meshletBuffer) override;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex) override;
+		virtual void DrawSubmeshesInstanced(const std::vector<Mesh::Submesh>& submeshes, uint32_t instanceCount) override; // Instance by instance, all submeshes per transform
+		virtual void DrawMeshletsInstanced(BufferHandle meshletBuffer, uint32_t instanceCount) override;
+
+		// --- SOFTWARE ONLY ---
+		// Set before BeginFrame, pColorTarget has to stay valid until EndFrame
+		void SetColorTarget(uint32_t* pColorTarget) { m_pColorTarget = pColorTarget; };
+		void SetSettings(const SoftwareRasterizer::Settings& settings) { m_Settings = settings; };
+		// Next frame with transparent draws renders both modes, [B] prints the result
+		void RequestTransparencyComparison(bool isPrinted);
+		const TransparencyComparison& GetTransparencyComparison() const { return m_TransparencyComparison; }; // Last requested, empty until it ran
+		const PipelineStatistics& GetFrameStatistics() const { return m_Rasterizer.GetFrameStatistics(); };
+
+	private:
+		SoftwareRasterizer m_Rasterizer;
+		SoftwareRasterizer::Settings m_Settings{};
+
+		uint32_t* m_pColorTarget{};
+		bool m_CompareTransparencyRequested{ false };
+		bool m_PrintTransparencyComparison{ false };
+		TransparencyComparison m_TransparencyComparison{};
+
+		// Handle N lives at index N - 1
+		std::vector<std::unique_ptr<VertexStreams>> m_VertexBuffers{}; // unique_ptr => bound draw call pointers survive new buffers
+		struct IndexBufferView
+		{
+			const void* pIndices;
+			IndexFormat format;
+		};
+		std::vector<IndexBufferView> m_IndexBuffers{};
+		struct MeshletBufferView
+		{
+			const VertexStreams* pVertices; // Owned by m_VertexBuffers
+			const MeshletMesh* pMeshlets;
+		};
+		std::vector<MeshletBufferView> m_MeshletBuffers{};
+		std::vector<const Texture*> m_Textures{};
+
+		PipelineState m_PipelineState{};
+		SoftwareRasterizer::DrawCall m_DrawCall{}; // Bound state, completed by DrawIndexed
+
+		// Not copied - handed to the rasterizer with every instanced draw
+		const Matrix* m_pInstanceTransforms{};
+		uint32_t m_InstanceCount{};
+		bool m_HasTransparentDraws{ false };
+
+		void Submit(const SoftwareRasterizer::DrawCall& drawCall); // Drawn right away when opaque, gathered when transparent
+		void SubmitInstanced(const SoftwareRasterizer::DrawCall& drawCall, uint32_t instanceCount);
+	};
+}
@@ -0,0 +1,1042 @@
+#include "SoftwareRasterizer.h"
+#include "Profiler.h"
+
+// Standard includes
+#include <iostream>
+#include <execution>
+#include <numeric>
+#include <chrono>
+#include <cstring>
+
+using namespace dae;
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height) :
+	m_Width{ width },
+	m_Height{ height }
+{
+	m_SpanRed.resize(m_Width);
+	m_SpanGreen.resize(m_Width);
+	m_SpanBlue.resize(m_Width);
+	m_SpanPixelNumbers.resize(m_Width);
+	m_SpanPackedPixels.resize(m_Width);
+
+	m_pDepthBufferPixels = std::make_unique<float[]>(m_Width * m_Height);
+	std::fill_n(m_pDepthBufferPixels.get(), m_Width * m_Height, std::numeric_limits<float>::max()); // Depth buffer elements are initalized with float max
+
+	// Transparency Buffers (cleared per tile when used)
+	m_pAccumulationBuffer = std::make_unique<Vector4[]>(m_Width * m_Height);
+	m_pRevealageBuffer = std::make_unique<float[]>(m_Width * m_Height);
+
+	m_NumTilesX = (m_Width + TILE_SIZE - 1) / TILE_SIZE;
+	m_NumTilesY = (m_Height + TILE_SIZE - 1) / TILE_SIZE;
+	m_TileIndices.resize(m_NumTilesX * m_NumTilesY);
+	std::iota(m_TileIndices.begin(), m_TileIndices.end(), 0);
+	m_TileCleared.resize(m_TileIndices.size());
+	m_TileTriangleBins.resize(m_TileIndices.size());
+	m_TileStatistics.resize(m_TileIndices.size());
+
+	m_pOverdrawBuffer = std::make_unique<uint16_t[]>(m_Width * m_Height);
+	m_TileShadingTimes.resize(m_TileIndices.size());
+	m_TileTriangleCounts.resize(m_TileIndices.size());
+}
+
+void SoftwareRasterizer::BeginFrame(uint32_t* pColorTarget, uint32_t packedClearColor, const Matrix& viewProjMatrix, const Vector3& cameraOrigin, const Settings& settings)
+{
+	m_pBackBufferPixels = pColorTarget;
+	m_ViewProjMatrix = viewProjMatrix;
+	m_CameraOrigin = cameraOrigin;
+	m_Settings = settings;
+	m_Frustum = Frustum::FromViewProjection(viewProjMatrix);
+
+	// CLEAR THE BUFFERS - Lazily, per tile on first touch (see EnsureTilesCleared / ResolveUntouchedTiles)
+	m_PackedClearColor = packedClearColor;
+	std::fill(m_TileCleared.begin(), m_TileCleared.end(), uint8_t{ 0 });
+
+	// The view projection may have changed
+	m_pTransformedVertexStreams = nullptr;
+
+	// Heatmaps of the previous frame
+	if (m_Settings.pixelColorState == PixelColorState::Overdraw)
+	{
+		std::fill_n(m_pOverdrawBuffer.get(), m_Width * m_Height, uint16_t{ 0 });
+	}
+	else if (IsGatheringTileHeatmap())
+	{
+		std::fill(m_TileShadingTimes.begin(), m_TileShadingTimes.end(), 0.f);
+		std::fill(m_TileTriangleCounts.begin(), m_TileTriangleCounts.end(), 0u);
+	}
+}
+
+void SoftwareRasterizer::Draw(const DrawCall& drawCall)
+{
+	DAE_PROFILE_SCOPE("Draw");
+
+	TransformDrawCallVertices(drawCall);
+
+	// Setup, rasterization and shading are interleaved per pixel => one scope for all of them
+	DAE_PROFILE_SCOPE("Rasterize");
+	AssembleTriangles(drawCall, [&](const std::array<VertexOut, 3>& screenTri)
+		{
+			RasterizationStage(drawCall, screenTri);
+		});
+}
+
+void SoftwareRasterizer::DrawInstanced(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	DAE_PROFILE_SCOPE("DrawInstanced");
+
+	AssembleInstancedTriangles(drawCall, pWorldMatrices, instanceCount, [&](const std::array<VertexOut, 3>& screenTri)
+		{
+			RasterizationStage(drawCall, screenTri);
+		});
+}
+
+void SoftwareRasterizer::BeginTransparentPass()
+{
+	m_TransparentTriangles.clear();
+}
+
+void SoftwareRasterizer::GatherTransparent(const DrawCall& drawCall)
+{
+	DAE_PROFILE_SCOPE("GatherTransparent");
+
+	TransformDrawCallVertices(drawCall);
+
+	AssembleTriangles(drawCall, [&](const std::array<VertexOut, 3>& screenTri)
+		{
+			// position.w holds 1/w, so the view depth is its inverse
+			const float avgViewDepth{ (1.f / screenTri[0].position.w + 1.f / screenTri[1].position.w + 1.f / screenTri[2].position.w) / 3.f };
+			m_TransparentTriangles.emplace_back(TransparentTriangle{ screenTri, drawCall.pDiffuseTexture, avgViewDepth });
+		});
+}
+
+void SoftwareRasterizer::GatherTransparentInstanced(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	DAE_PROFILE_SCOPE("GatherTransparent");
+
+	AssembleInstancedTriangles(drawCall, pWorldMatrices, instanceCount, [&](const std::array<VertexOut, 3>& screenTri)
+		{
+			const float avgViewDepth{ (1.f / screenTri[0].position.w + 1.f / screenTri[1].position.w + 1.f / screenTri[2].position.w) / 3.f };
+			m_TransparentTriangles.emplace_back(TransparentTriangle{ screenTri, drawCall.pDiffuseTexture, avgViewDepth });
+		});
+}
+
+void SoftwareRasterizer::EndFrame()
+{
+	// Tiles no triangle touched still hold last frame
+	{
+		DAE_PROFILE_SCOPE("ResolveUntouchedTiles");
+		ResolveUntouchedTiles();
+	}
+
+	ResolveHeatmap();
+
+	// Merge the statistics of this frame
+	for (PipelineStatistics& tileStatistics : m_TileStatistics)
+	{
+		m_FrameStatistics += tileStatistics;
+		tileStatistics = PipelineStatistics{};
+	}
+
+	m_LastFrameStatistics = m_FrameStatistics;
+	m_FrameStatistics = PipelineStatistics{};
+}
+
+void SoftwareRasterizer::RasterizationStage(const DrawCall& drawCall, const std::array<VertexOut, 3>& screenTri)
+{
+	// ---- Bounding Box -----
+	std::pair<int, int> topLeft{ static_cast<int>(std::floor(
+		std::min({screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x}))),
+		static_cast<int>(std::floor(
+			std::min({screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y}))) };
+	topLeft.first = std::max(topLeft.first, 0);
+	topLeft.second = std::max(topLeft.second, 0);
+
+	std::pair<int, int> bottomRight{ static_cast<int>(std::ceil(
+		std::max({screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x}))),
+		static_cast<int>(std::ceil(
+			std::max({screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y}))) };
+	bottomRight.first = std::min(bottomRight.first, m_Width - 1);
+	bottomRight.second = std::min(bottomRight.second, m_Height - 1);
+
+	EnsureTilesCleared(topLeft.first, topLeft.second, bottomRight.first, bottomRight.second);
+
+	const bool isGatheringTileHeatmap{ IsGatheringTileHeatmap() };
+	const bool isCountingOverdraw{ m_Settings.pixelColorState == PixelColorState::Overdraw };
+	const auto shadingStart{ isGatheringTileHeatmap ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{} };
+
+	// Local counters, the pixel loop stores to the buffers and would reload members every pixel
+	uint64_t pixelsTested{};
+	uint64_t pixelsCovered{};
+	uint64_t depthPasses{};
+
+	const bool samplesNormal{ drawCall.pNormalTexture && m_Settings.showNormalMap };
+	const bool samplesSpecular{ drawCall.pSpecularTexture && drawCall.pGlossTexture &&
+		(m_Settings.lightingMode == LightingMode::Specular || m_Settings.lightingMode == LightingMode::Combined) };
+	const uint64_t samplesPerPixel{ 1ull + (samplesNormal ? 1 : 0) + (samplesSpecular ? 2 : 0) };
+
+	if (m_Settings.showBoundingBox)
+	{
+		FillRectangle(topLeft.first, topLeft.second, bottomRight.first, bottomRight.second, ColorRGB{ 1.f, 1.f, 1.f });
+	}
+	else
+	{
+		// PIXEL LOOP - Bounding Box (row by row, every row is packed as one span)
+		for (int py{ topLeft.second }; py <= bottomRight.second; ++py)
+		{
+			int spanCount{};
+
+			for (int px{ topLeft.first }; px <= bottomRight.first; ++px)
+			{
+				ColorRGB finalColor{};
+
+				VertexIn pixel{ Vector3{ static_cast<float>(px) + 0.5f,
+					static_cast<float>(py) + 0.5f, 1.f} }; // We check from the center of the pixel, hence +0.5f
+
+				std::array<float, 3> triangleAreaRatios;
+
+				// INSIDE - OUTSIDE TEST + Depth Interpolation
+				bool pixelInTriangle{ IsPixelIn_Triangle(screenTri, pixel, triangleAreaRatios) };
+				++pixelsTested;
+
+				if (pixelInTriangle)
+				{
+					int currentPixelNr{ GetPixelNumber(px, py, m_Width) };
+					++pixelsCovered;
+
+					// Depth Test
+					if (pixel.position.z < m_pDepthBufferPixels[currentPixelNr])
+					{
+						++depthPasses;
+
+						if (isCountingOverdraw)
+						{
+							++m_pOverdrawBuffer[currentPixelNr];
+						}
+
+						if (m_Settings.cullMode != CullMode::Front)
+						{
+							// Depth Write
+							m_pDepthBufferPixels[currentPixelNr] = pixel.position.z;
+						}
+
+						// UV, Normal, Tangent, ViewDirection Interpolation
+						InterpolateVertex(triangleAreaRatios, screenTri, pixel);
+
+						ColorRGB pixelColor{ drawCall.pDiffuseTexture->Sample(pixel.UVCoordinate) };
+
+						// ----- SHADING -----
+						pixelColor = PixelShading(pixel, drawCall, pixelColor);
+
+						switch (m_Settings.pixelColorState)
+						{
+						case PixelColorState::DepthBuffer:
+						{
+							ColorRGB depthValue{ RemapValue(pixel.position.z, 0.997f) };
+							finalColor = depthValue;
+							break;
+						}
+						default: // Heatmaps replace the final color in EndFrame
+							finalColor = pixelColor;
+							break;
+						}
+
+						// ---- Render only if overwriting pixel ----
+						// Stage color, packed together with the rest of the row
+						m_SpanRed[spanCount] = finalColor.r;
+						m_SpanGreen[spanCount] = finalColor.g;
+						m_SpanBlue[spanCount] = finalColor.b;
+						m_SpanPixelNumbers[spanCount] = currentPixelNr;
+						++spanCount;
+					}
+				}
+			}
+
+			//Update Color in Buffer
+			PackColorSpan(m_SpanRed.data(), m_SpanGreen.data(), m_SpanBlue.data(), m_SpanPackedPixels.data(), spanCount, m_Settings.sRGBEncoding);
+
+			for (int i{}; i < spanCount; ++i)
+			{
+				m_pBackBufferPixels[m_SpanPixelNumbers[i]] = m_SpanPackedPixels[i];
+			}
+		}
+	}
+
+	m_FrameStatistics.pixelsTested += pixelsTested;
+	m_FrameStatistics.pixelsCovered += pixelsCovered;
+	m_FrameStatistics.depthPasses += depthPasses;
+	m_FrameStatistics.depthFailures += pixelsCovered - depthPasses;
+	m_FrameStatistics.shaderInvocations += depthPasses;
+	m_FrameStatistics.textureSamples += depthPasses * samplesPerPixel;
+
+	if (isGatheringTileHeatmap)
+	{
+		const std::chrono::duration<float, std::milli> shadingTime{ std::chrono::steady_clock::now() - shadingStart };
+		AddTriangleToTileHeatmaps(topLeft.first, topLeft.second, bottomRight.first, bottomRight.second, shadingTime.count());
+	}
+}
+
+ColorRGB SoftwareRasterizer::PixelShading(const VertexIn& pixel, const DrawCall& drawCall, const ColorRGB& pixelColor) const
+{
+	ColorRGB finalShadedColor{};
+	const Vector3 lightDirection{ -Vector3{0.577f, -0.577f, 0.577f}.Normalized() }; // Inverted Light
+	constexpr float lightIntensity{ 1.f };
+
+	Vector3 finalNormal{ pixel.normal };
+
+	// Normal Map Sampling
+	if (drawCall.pNormalTexture && m_Settings.showNormalMap)
+	{
+		const Vector3 binormal{ Vector3::Cross(pixel.normal, pixel.tangent) };
+
+		// Tangent -> World
+		const Matrix tangentSpaceMatrix{ pixel.tangent, binormal, pixel.normal, {} };
+
+		// Get Normal from map
+		const ColorRGB sampledNormalColor{ drawCall.pNormalTexture->Sample(pixel.UVCoordinate) };
+
+		// Convert Normal to Tangent space
+		const Vector3 tangentSpaceNormal{
+			sampledNormalColor.r * 2.f - 1.f,
+			sampledNormalColor.g * 2.f - 1.f,
+			sampledNormalColor.b * 2.f - 1.f
+		};
+
+		// Tangent Space to World Space USING the TBN matrix
+		finalNormal = tangentSpaceMatrix.TransformVector(tangentSpaceNormal).Normalized();
+	}
+
+	// Lambert Diffuse
+	const float cosTheta{ std::min(1.f, std::max(0.f, Vector3::Dot(lightDirection, finalNormal))) };
+	const ColorRGB lambertDiffuse{ pixelColor };
+
+
+	const ColorRGB lambertColor(GetLambertColor(lambertDiffuse, cosTheta) * lightIntensity);
+
+	// Specular Color
+	ColorRGB specularColor{ colors::Black };
+	if (m_Settings.lightingMode == LightingMode::Specular || m_Settings.lightingMode == LightingMode::Combined)
+	{
+		if (drawCall.pSpecularTexture && drawCall.pGlossTexture)
+		{
+			const ColorRGB sampledSpecular{ drawCall.pSpecularTexture->Sample(pixel.UVCoordinate) };
+			const ColorRGB sampledGlossiness{ drawCall.pGlossTexture->Sample(pixel.UVCoordinate) };
+
+			constexpr float shininess{ 25.f };
+			const float phongExponent{ sampledGlossiness.r * shininess };
+
+			specularColor = Phong(sampledSpecular, sampledSpecular.r, phongExponent,
+				lightDirection, pixel.viewDirection.Normalized(), finalNormal) * lightIntensity;
+		}
+	}
+
+	// Ambient Color
+	constexpr float ambientStrength{ 0.025f };
+	const ColorRGB ambientColor{ lambertDiffuse * ambientStrength };
+	finalShadedColor += ambientColor;
+
+	switch (m_Settings.lightingMode)
+	{
+	case LightingMode::ObservedArea:
+		finalShadedColor = ColorRGB{ cosTheta, cosTheta, cosTheta };
+		break;
+	case LightingMode::Diffuse:
+		finalShadedColor = lambertColor;
+		break;
+	case LightingMode::Specular:
+		finalShadedColor = specularColor;
+		break;
+	case LightingMode::Combined:
+		finalShadedColor = lambertColor + specularColor;
+		break;
+	}
+
+	return finalShadedColor;
+}
+
+void SoftwareRasterizer::TransformDrawCallVertices(const DrawCall& drawCall)
+{
+	// Submeshes share one vertex buffer => transformed once for all of them
+	if (drawCall.pVertices == m_pTransformedVertexStreams
+		&& std::memcmp(&drawCall.worldMatrix, &m_TransformedWorldMatrix, sizeof(Matrix)) == 0)
+		return;
+
+	m_pTransformedVertexStreams = drawCall.pVertices;
+	m_TransformedWorldMatrix = drawCall.worldMatrix;
+
+	Matrix worldViewProjectionMatrix{ drawCall.worldMatrix * m_ViewProjMatrix };
+
+	if (drawCall.pMeshlets)
+	{
+		m_VisibleMeshlets.clear();
+		CullMeshlets(drawCall, drawCall.worldMatrix);
+		TransformVisibleMeshlets(drawCall, worldViewProjectionMatrix);
+		return;
+	}
+
+	VertexTransformationFunction(*drawCall.pVertices, m_TransformedMeshVertices, worldViewProjectionMatrix, drawCall.worldMatrix);
+}
+
+void SoftwareRasterizer::CullMeshlets(const DrawCall& drawCall, const Matrix& worldMatrix)
+{
+	DAE_PROFILE_SCOPE("CullMeshlets");
+
+	const std::vector<Meshlet>& meshlets{ drawCall.pMeshlets->meshlets };
+	m_FrameStatistics.clustersSubmitted += meshlets.size();
+
+	if (!m_Settings.clusterCulling)
+	{
+		const size_t firstVisible{ m_VisibleMeshlets.size() };
+		m_VisibleMeshlets.resize(firstVisible + meshlets.size());
+		std::iota(m_VisibleMeshlets.begin() + firstVisible, m_VisibleMeshlets.end(), 0u);
+		return;
+	}
+
+	// Only one winding is ever rasterized (see PassTriangleOptimizations), so the cone test holds in every cull mode
+	const MeshletCuller culler{ worldMatrix, m_Frustum, m_CameraOrigin, true };
+
+	for (uint32_t i{}; i < meshlets.size(); ++i)
+	{
+		switch (culler.Classify(meshlets[i]))
+		{
+		case MeshletVisibility::OutsideFrustum:
+			++m_FrameStatistics.clustersCulledFrustum;
+			break;
+		case MeshletVisibility::Backfacing:
+			++m_FrameStatistics.clustersCulledBackface;
+			break;
+		default:
+			m_VisibleMeshlets.emplace_back(i);
+			break;
+		}
+	}
+}
+
+void SoftwareRasterizer::TransformVisibleMeshlets(const DrawCall& drawCall, const Matrix& WVPMatrix)
+{
+	DAE_PROFILE_SCOPE("VertexTransform");
+
+	const auto start{ std::chrono::steady_clock::now() };
+
+	const VertexStreams& streams{ *drawCall.pVertices };
+	const std::vector<Meshlet>& meshlets{ drawCall.pMeshlets->meshlets };
+
+	if (m_TransformedMeshVertices.size() < streams.numVertices)
+	{
+		m_TransformedMeshVertices.resize(streams.numVertices);
+	}
+
+	size_t numVertices{};
+	for (uint32_t meshletIndex : m_VisibleMeshlets)
+	{
+		numVertices += meshlets[meshletIndex].vertexCount;
+	}
+	m_FrameStatistics.verticesTransformed += numVertices;
+
+	// Every meshlet starts a new batch, its padding vertices are not transformed
+	const VertexTransformConstants constants{ WVPMatrix, drawCall.worldMatrix, m_CameraOrigin, static_cast<float>(m_Width), static_cast<float>(m_Height) };
+	const auto transformMeshlet{ [&](uint32_t meshletIndex)
+		{
+			const Meshlet& meshlet{ meshlets[meshletIndex] };
+			TransformVertexStreams(streams, meshlet.vertexOffset, meshlet.vertexOffset + meshlet.vertexCount, constants, m_TransformedMeshVertices.data());
+		} };
+
+	if (numVertices < PARALLEL_TRANSFORM_MIN_VERTICES)
+	{
+		std::for_each(m_VisibleMeshlets.begin(), m_VisibleMeshlets.end(), transformMeshlet);
+	}
+	else
+	{
+		std::for_each(std::execution::par, m_VisibleMeshlets.begin(), m_VisibleMeshlets.end(), transformMeshlet);
+	}
+
+	m_FrameStatistics.vertexTransformTime += static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void SoftwareRasterizer::TransformInstanceBatch(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount)
+{
+	const VertexStreams& streams{ *drawCall.pVertices };
+	const size_t numVertices{ streams.numVertices };
+
+	if (m_TransformedMeshVertices.size() < numVertices * instanceCount)
+	{
+		m_TransformedMeshVertices.resize(numVertices * instanceCount);
+	}
+
+	// Cull and gather the work of every instance first => one pass over all of them, parallel even when a single instance is small
+	m_InstanceConstants.clear();
+	m_InstanceTransformJobs.clear();
+	m_InstanceMeshletStarts.clear();
+	m_VisibleMeshlets.clear();
+
+	for (uint32_t instance{}; instance < instanceCount; ++instance)
+	{
+		const Matrix& worldMatrix{ pWorldMatrices[instance] };
+		m_InstanceConstants.emplace_back(VertexTransformConstants{ worldMatrix * m_ViewProjMatrix, worldMatrix, m_CameraOrigin,
+			static_cast<float>(m_Width), static_cast<float>(m_Height) });
+		m_InstanceMeshletStarts.emplace_back(m_VisibleMeshlets.size());
+
+		if (drawCall.pMeshlets)
+		{
+			// Every meshlet starts a new batch, its padding vertices are not transformed
+			const size_t firstVisible{ m_VisibleMeshlets.size() };
+			CullMeshlets(drawCall, worldMatrix);
+
+			for (size_t i{ firstVisible }; i < m_VisibleMeshlets.size(); ++i)
+			{
+				const Meshlet& meshlet{ drawCall.pMeshlets->meshlets[m_VisibleMeshlets[i]] };
+				m_InstanceTransformJobs.emplace_back(InstanceTransformJob{ instance, meshlet.vertexOffset, meshlet.vertexOffset + meshlet.vertexCount });
+			}
+		}
+		else
+		{
+			for (size_t chunkStart{}; chunkStart < numVertices; chunkStart += TRANSFORM_CHUNK_SIZE)
+			{
+				m_InstanceTransformJobs.emplace_back(InstanceTransformJob{ instance, chunkStart, std::min(chunkStart + TRANSFORM_CHUNK_SIZE, numVertices) });
+			}
+		}
+	}
+	m_InstanceMeshletStarts.emplace_back(m_VisibleMeshlets.size());
+
+	DAE_PROFILE_SCOPE("VertexTransform");
+
+	const auto start{ std::chrono::steady_clock::now() };
+
+	size_t numTransformed{};
+	for (const InstanceTransformJob& job : m_InstanceTransformJobs)
+	{
+		numTransformed += job.lastVertex - job.firstVertex;
+	}
+	m_FrameStatistics.verticesTransformed += numTransformed;
+
+	const auto transformJob{ [&](const InstanceTransformJob& job)
+		{
+			TransformVertexStreams(streams, job.firstVertex, job.lastVertex, m_InstanceConstants[job.instance],
+				m_TransformedMeshVertices.data() + job.instance * numVertices);
+		} };
+
+	if (numTransformed < PARALLEL_TRANSFORM_MIN_VERTICES)
+	{
+		std::for_each(m_InstanceTransformJobs.begin(), m_InstanceTransformJobs.end(), transformJob);
+	}
+	else
+	{
+		std::for_each(std::execution::par, m_InstanceTransformJobs.begin(), m_InstanceTransformJobs.end(), transformJob);
+	}
+
+	m_FrameStatistics.vertexTransformTime += static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void SoftwareRasterizer::VertexTransformationFunction(const VertexStreams& vertices_in, std::vector<VertexOut>& vertices_out,
+	const Matrix& WVPMatrix, const Matrix& worldMatrix)
+{
+	DAE_PROFILE_SCOPE("VertexTransform");
+
+	const auto start{ std::chrono::steady_clock::now() };
+
+	const size_t numVertices{ vertices_in.numVertices };
+	m_FrameStatistics.verticesTransformed += numVertices;
+
+	// Only grows => no reallocation once the largest mesh was drawn, every slot below numVertices is overwritten
+	if (vertices_out.size() < numVertices)
+	{
+		vertices_out.resize(numVertices);
+	}
+
+	const VertexTransformConstants constants{ WVPMatrix, worldMatrix, m_CameraOrigin, static_cast<float>(m_Width), static_cast<float>(m_Height) };
+
+	if (numVertices < PARALLEL_TRANSFORM_MIN_VERTICES)
+	{
+		TransformVertexStreams(vertices_in, 0, numVertices, constants, vertices_out.data());
+	}
+	else
+	{
+		m_TransformChunkStarts.clear();
+		for (size_t chunkStart{}; chunkStart < numVertices; chunkStart += TRANSFORM_CHUNK_SIZE)
+		{
+			m_TransformChunkStarts.emplace_back(chunkStart);
+		}
+
+		std::for_each(std::execution::par, m_TransformChunkStarts.begin(), m_TransformChunkStarts.end(), [&](size_t chunkStart)
+			{
+				TransformVertexStreams(vertices_in, chunkStart, chunkStart + TRANSFORM_CHUNK_SIZE, constants, vertices_out.data());
+			});
+	}
+
+	m_FrameStatistics.vertexTransformTime += static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+bool SoftwareRasterizer::PassTriangleOptimizations(const std::array<VertexOut, 3>& screenTri)
+{
+	++m_FrameStatistics.trianglesSubmitted;
+
+	// --- INSIDE SCREEN CHECK ---
+	if (std::any_of(screenTri.begin(), screenTri.end(),
+		[&](const VertexOut& v) {
+			return v.position.x < 0.f || v.position.x >= m_Width ||
+				v.position.y < 0.f || v.position.y >= m_Height;
+		}))
+	{
+		++m_FrameStatistics.trianglesCulledOffscreen;
+		return false; // Skip triangle
+	}
+
+	// --- FRUSTRUM CULLING ---
+	if (std::any_of(screenTri.begin(), screenTri.end(),
+		[&](const VertexOut& v) {
+			return v.position.z < 0.f || v.position.z > 1.f;
+		}))
+	{
+		++m_FrameStatistics.trianglesCulledDepthRange;
+		return false; // Skip triangle
+	}
+
+	// --- FACING --- IsPixelIn_Triangle only accepts one winding, the other one would test its whole bounding box for nothing
+	const Vector2 v0{ screenTri[0].position.x, screenTri[0].position.y };
+	const float signedArea{ Vector2::Cross(Vector2{ screenTri[1].position.x, screenTri[1].position.y } - v0,
+		Vector2{ screenTri[2].position.x, screenTri[2].position.y } - v0) };
+
+	if (signedArea == 0.f)
+	{
+		++m_FrameStatistics.trianglesCulledZeroArea;
+		return false; // Skip triangle
+	}
+
+	if (signedArea < 0.f)
+	{
+		++m_FrameStatistics.trianglesCulledFacing;
+		return false; // Skip triangle
+	}
+
+	return true;
+}
+
+void SoftwareRasterizer::FillRectangle(int x0, int y0, int x1, int y1, const ColorRGB& color) const
+{
+	const uint32_t packedColor{ PackColor(color, m_Settings.sRGBEncoding) };
+
+	for (int y = y0; y <= y1; ++y)
+	{
+		std::fill_n(m_pBackBufferPixels + GetPixelNumber(x0, y, m_Width), x1 - x0 + 1, packedColor);
+	}
+}
+
+void SoftwareRasterizer::GetTileRect(int tileIndex, int& minX, int& minY, int& maxX, int& maxY) const
+{
+	minX = (tileIndex % m_NumTilesX) * TILE_SIZE;
+	minY = (tileIndex / m_NumTilesX) * TILE_SIZE;
+	maxX = std::min(minX + TILE_SIZE, m_Width) - 1;
+	maxY = std::min(minY + TILE_SIZE, m_Height) - 1;
+}
+
+void SoftwareRasterizer::ClearTile(int tileIndex)
+{
+	DAE_PROFILE_SCOPE("ClearTile");
+
+	int minX, minY, maxX, maxY;
+	GetTileRect(tileIndex, minX, minY, maxX, maxY);
+
+	for (int py{ minY }; py <= maxY; ++py)
+	{
+		const int rowStart{ GetPixelNumber(minX, py, m_Width) };
+		std::fill_n(m_pDepthBufferPixels.get() + rowStart, maxX - minX + 1, std::numeric_limits<float>::max());
+		std::fill_n(m_pBackBufferPixels + rowStart, maxX - minX + 1, m_PackedClearColor);
+	}
+
+	m_TileCleared[tileIndex] = 1;
+}
+
+void SoftwareRasterizer::EnsureTilesCleared(int minX, int minY, int maxX, int maxY)
+{
+	const int minTileX{ std::max(0, minX / TILE_SIZE) };
+	const int minTileY{ std::max(0, minY / TILE_SIZE) };
+	const int maxTileX{ std::min(m_NumTilesX - 1, maxX / TILE_SIZE) };
+	const int maxTileY{ std::min(m_NumTilesY - 1, maxY / TILE_SIZE) };
+
+	for (int tileY{ minTileY }; tileY <= maxTileY; ++tileY)
+	{
+		for (int tileX{ minTileX }; tileX <= maxTileX; ++tileX)
+		{
+			const int tileIndex{ tileX + tileY * m_NumTilesX };
+			if (!m_TileCleared[tileIndex])
+			{
+				ClearTile(tileIndex);
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::ResolveUntouchedTiles()
+{
+	// Color only, depth of an untouched tile is never read this frame
+	for (int tileIndex : m_TileIndices)
+	{
+		if (m_TileCleared[tileIndex])
+			continue;
+
+		int minX, minY, maxX, maxY;
+		GetTileRect(tileIndex, minX, minY, maxX, maxY);
+
+		for (int py{ minY }; py <= maxY; ++py)
+		{
+			std::fill_n(m_pBackBufferPixels + GetPixelNumber(minX, py, m_Width), maxX - minX + 1, m_PackedClearColor);
+		}
+	}
+}
+
+bool SoftwareRasterizer::IsGatheringTileHeatmap() const
+{
+	return m_Settings.pixelColorState == PixelColorState::TileShadingTime || m_Settings.pixelColorState == PixelColorState::TileTriangles;
+}
+
+void SoftwareRasterizer::AddTriangleToTileHeatmaps(int minX, int minY, int maxX, int maxY, float shadingTime)
+{
+	if (maxX < minX || maxY < minY)
+		return;
+
+	const float boxArea{ static_cast<float>((maxX - minX + 1) * (maxY - minY + 1)) };
+
+	for (int tileY{ minY / TILE_SIZE }; tileY <= maxY / TILE_SIZE; ++tileY)
+	{
+		for (int tileX{ minX / TILE_SIZE }; tileX <= maxX / TILE_SIZE; ++tileX)
+		{
+			const int tileIndex{ tileX + tileY * m_NumTilesX };
+
+			int tileMinX, tileMinY, tileMaxX, tileMaxY;
+			GetTileRect(tileIndex, tileMinX, tileMinY, tileMaxX, tileMaxY);
+
+			const int overlapArea{ (std::min(maxX, tileMaxX) - std::max(minX, tileMinX) + 1) * (std::min(maxY, tileMaxY) - std::max(minY, tileMinY) + 1) };
+
+			m_TileShadingTimes[tileIndex] += shadingTime * overlapArea / boxArea;
+			++m_TileTriangleCounts[tileIndex];
+		}
+	}
+}
+
+void SoftwareRasterizer::ResolveHeatmap()
+{
+	// Black => nothing was drawn there
+	switch (m_Settings.pixelColorState)
+	{
+	case PixelColorState::Overdraw:
+		for (int i{}; i < m_Width * m_Height; ++i)
+		{
+			const int numFragments{ m_pOverdrawBuffer[i] };
+			m_pBackBufferPixels[i] = numFragments == 0 ? PackColor(colors::Black, false) :
+				PackColor(GetHeatmapColor(static_cast<float>(numFragments - 1) / (HEATMAP_MAX_OVERDRAW - 1)), false);
+		}
+		break;
+	case PixelColorState::TileShadingTime:
+	case PixelColorState::TileTriangles:
+	{
+		const float maxShadingTime{ *std::max_element(m_TileShadingTimes.begin(), m_TileShadingTimes.end()) };
+
+		for (int tileIndex : m_TileIndices)
+		{
+			ColorRGB tileColor{ colors::Black };
+			if (m_TileTriangleCounts[tileIndex] > 0)
+			{
+				tileColor = m_Settings.pixelColorState == PixelColorState::TileShadingTime ?
+					GetHeatmapColor(m_TileShadingTimes[tileIndex] / std::max(maxShadingTime, 1e-6f)) :
+					GetHeatmapColor(static_cast<float>(m_TileTriangleCounts[tileIndex]) / HEATMAP_MAX_TILE_TRIANGLES);
+			}
+
+			int minX, minY, maxX, maxY;
+			GetTileRect(tileIndex, minX, minY, maxX, maxY);
+
+			for (int py{ minY }; py <= maxY; ++py)
+			{
+				std::fill_n(m_pBackBufferPixels + GetPixelNumber(minX, py, m_Width), maxX - minX + 1, PackColor(tileColor, false));
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void SoftwareRasterizer::RenderTransparentTriangles()
+{
+	switch (m_Settings.transparencyMode)
+	{
+	case TransparencyMode::Sorted:
+		RenderTransparentSorted();
+		break;
+	case TransparencyMode::WeightedBlendedOIT:
+		RenderTransparentWeightedBlended();
+		break;
+	}
+}
+
+void SoftwareRasterizer::RenderTransparentSorted()
+{
+	DAE_PROFILE_SCOPE("TransparentSorted");
+
+	// Back to front, every frame
+	std::sort(m_TransparentTriangles.begin(), m_TransparentTriangles.end(),
+		[](const TransparentTriangle& a, const TransparentTriangle& b) { return a.viewDepth > b.viewDepth; });
+
+	const bool isGatheringTileHeatmap{ IsGatheringTileHeatmap() };
+
+	for (const TransparentTriangle& triangle : m_TransparentTriangles)
+	{
+		const auto& v{ triangle.vertices };
+		const int minX{ static_cast<int>(std::min({ v[0].position.x, v[1].position.x, v[2].position.x })) };
+		const int minY{ static_cast<int>(std::min({ v[0].position.y, v[1].position.y, v[2].position.y })) };
+		const int maxX{ static_cast<int>(std::max({ v[0].position.x, v[1].position.x, v[2].position.x })) };
+		const int maxY{ static_cast<int>(std::max({ v[0].position.y, v[1].position.y, v[2].position.y })) };
+		EnsureTilesCleared(minX, minY, maxX, maxY);
+
+		const auto shadingStart{ isGatheringTileHeatmap ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{} };
+
+		RasterizeTransparentTriangle(triangle, 0, 0, m_Width - 1, m_Height - 1, TransparencyMode::Sorted, m_FrameStatistics);
+
+		if (isGatheringTileHeatmap)
+		{
+			const std::chrono::duration<float, std::milli> shadingTime{ std::chrono::steady_clock::now() - shadingStart };
+			AddTriangleToTileHeatmaps(std::max(0, minX), std::max(0, minY), std::min(m_Width - 1, maxX), std::min(m_Height - 1, maxY), shadingTime.count());
+		}
+	}
+}
+
+void SoftwareRasterizer::RenderTransparentWeightedBlended()
+{
+	DAE_PROFILE_SCOPE("TransparentOIT");
+
+	// --- BINNING --- (submission order, no sort)
+	BinTransparentTriangles();
+
+	// --- ACCUMULATE + RESOLVE --- Tiles own disjoint pixels, so they run in parallel without locks
+	const bool isGatheringTileHeatmap{ IsGatheringTileHeatmap() };
+
+	std::for_each(std::execution::par, m_TileIndices.begin(), m_TileIndices.end(), [&](int tileIndex)
+		{
+			const auto& bin{ m_TileTriangleBins[tileIndex] };
+			if (bin.empty())
+				return;
+
+			DAE_PROFILE_SCOPE("TransparentTile");
+
+			const auto shadingStart{ isGatheringTileHeatmap ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{} };
+
+			int minX, minY, maxX, maxY;
+			GetTileRect(tileIndex, minX, minY, maxX, maxY);
+
+			// Tile owns its flag => no other job touches it
+			if (!m_TileCleared[tileIndex])
+			{
+				ClearTile(tileIndex);
+			}
+
+			// Clear only the tile that is about to be used
+			for (int py{ minY }; py <= maxY; ++py)
+			{
+				const int rowStart{ GetPixelNumber(minX, py, m_Width) };
+				std::fill_n(m_pAccumulationBuffer.get() + rowStart, maxX - minX + 1, Vector4{ 0.f, 0.f, 0.f, 0.f });
+				std::fill_n(m_pRevealageBuffer.get() + rowStart, maxX - minX + 1, 1.f);
+			}
+
+			for (uint32_t triIdx : bin)
+			{
+				RasterizeTransparentTriangle(m_TransparentTriangles[triIdx], minX, minY, maxX, maxY, TransparencyMode::WeightedBlendedOIT,
+					m_TileStatistics[tileIndex]);
+			}
+
+			ResolveTransparencyTile(tileIndex);
+
+			// Tile owns its heatmap slots as well
+			if (isGatheringTileHeatmap)
+			{
+				const std::chrono::duration<float, std::milli> shadingTime{ std::chrono::steady_clock::now() - shadingStart };
+				m_TileShadingTimes[tileIndex] += shadingTime.count();
+				m_TileTriangleCounts[tileIndex] += static_cast<uint32_t>(bin.size());
+			}
+		});
+}
+
+void SoftwareRasterizer::BinTransparentTriangles()
+{
+	DAE_PROFILE_SCOPE("BinTransparent");
+
+	for (auto& bin : m_TileTriangleBins)
+	{
+		bin.clear();
+	}
+
+	for (uint32_t triIdx{}; triIdx < m_TransparentTriangles.size(); ++triIdx)
+	{
+		const auto& v{ m_TransparentTriangles[triIdx].vertices };
+
+		const int minTileX{ std::max(0, static_cast<int>(std::min({ v[0].position.x, v[1].position.x, v[2].position.x })) / TILE_SIZE) };
+		const int minTileY{ std::max(0, static_cast<int>(std::min({ v[0].position.y, v[1].position.y, v[2].position.y })) / TILE_SIZE) };
+		const int maxTileX{ std::min(m_NumTilesX - 1, static_cast<int>(std::max({ v[0].position.x, v[1].position.x, v[2].position.x })) / TILE_SIZE) };
+		const int maxTileY{ std::min(m_NumTilesY - 1, static_cast<int>(std::max({ v[0].position.y, v[1].position.y, v[2].position.y })) / TILE_SIZE) };
+
+		for (int tileY{ minTileY }; tileY <= maxTileY; ++tileY)
+		{
+			for (int tileX{ minTileX }; tileX <= maxTileX; ++tileX)
+			{
+				m_TileTriangleBins[tileX + tileY * m_NumTilesX].push_back(triIdx);
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::RasterizeTransparentTriangle(const TransparentTriangle& triangle, int minX, int minY, int maxX, int maxY, TransparencyMode transparencyMode,
+	PipelineStatistics& statistics)
+{
+	const auto& screenTri{ triangle.vertices };
+
+	// ---- Bounding Box (clamped to the given rect) -----
+	const int topLeftX{ std::max(minX, static_cast<int>(std::floor(std::min({ screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x })))) };
+	const int topLeftY{ std::max(minY, static_cast<int>(std::floor(std::min({ screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y })))) };
+	const int bottomRightX{ std::min(maxX, static_cast<int>(std::ceil(std::max({ screenTri[0].position.x, screenTri[1].position.x, screenTri[2].position.x })))) };
+	const int bottomRightY{ std::min(maxY, static_cast<int>(std::ceil(std::max({ screenTri[0].position.y, screenTri[1].position.y, screenTri[2].position.y })))) };
+
+	uint64_t pixelsCovered{};
+	uint64_t depthPasses{};
+
+	for (int py{ topLeftY }; py <= bottomRightY; ++py)
+	{
+		for (int px{ topLeftX }; px <= bottomRightX; ++px)
+		{
+			VertexIn pixel{ Vector3{ static_cast<float>(px) + 0.5f, static_cast<float>(py) + 0.5f, 1.f } };
+			std::array<float, 3> triangleAreaRatios;
+
+			if (!IsPixelIn_Triangle(screenTri, pixel, triangleAreaRatios))
+				continue;
+
+			const int currentPixelNr{ GetPixelNumber(px, py, m_Width) };
+			++pixelsCovered;
+
+			// Depth Test against opaque geometry, NO Depth Write
+			if (pixel.position.z >= m_pDepthBufferPixels[currentPixelNr])
+				continue;
+
+			++depthPasses;
+			if (m_Settings.pixelColorState == PixelColorState::Overdraw)
+			{
+				++m_pOverdrawBuffer[currentPixelNr];
+			}
+
+			InterpolateVertex(triangleAreaRatios, screenTri, pixel);
+
+			float alpha{};
+			const ColorRGB color{ triangle.pDiffuseTexture->Sample(pixel.UVCoordinate, alpha) };
+
+			if (alpha <= 0.f)
+				continue;
+
+			if (transparencyMode == TransparencyMode::Sorted)
+			{
+				// Classic "over" blend on the back buffer
+				const ColorRGB dstColor{ UnpackColor(m_pBackBufferPixels[currentPixelNr], m_Settings.sRGBEncoding) };
+
+				m_pBackBufferPixels[currentPixelNr] = PackColor(color * alpha + dstColor * (1.f - alpha), m_Settings.sRGBEncoding);
+			}
+			else
+			{
+				const float viewDepth{ 1.f / (triangleAreaRatios[0] * screenTri[2].position.w +
+					triangleAreaRatios[1] * screenTri[0].position.w +
+					triangleAreaRatios[2] * screenTri[1].position.w) };
+				const float weight{ GetOITWeight(alpha, viewDepth) };
+
+				m_pAccumulationBuffer[currentPixelNr] += Vector4{ color.r * alpha * weight, color.g * alpha * weight, color.b * alpha * weight, alpha * weight };
+				m_pRevealageBuffer[currentPixelNr] *= 1.f - alpha;
+			}
+		}
+	}
+
+	const uint64_t boxWidth{ static_cast<uint64_t>(std::max(0, bottomRightX - topLeftX + 1)) };
+	const uint64_t boxHeight{ static_cast<uint64_t>(std::max(0, bottomRightY - topLeftY + 1)) };
+
+	statistics.pixelsTested += boxWidth * boxHeight;
+	statistics.pixelsCovered += pixelsCovered;
+	statistics.depthPasses += depthPasses;
+	statistics.depthFailures += pixelsCovered - depthPasses;
+	statistics.shaderInvocations += depthPasses;
+	statistics.textureSamples += depthPasses;
+}
+
+void SoftwareRasterizer::ResolveTransparencyTile(int tileIndex)
+{
+	int minX, minY, maxX, maxY;
+	GetTileRect(tileIndex, minX, minY, maxX, maxY);
+
+	for (int py{ minY }; py <= maxY; ++py)
+	{
+		for (int px{ minX }; px <= maxX; ++px)
+		{
+			const int currentPixelNr{ GetPixelNumber(px, py, m_Width) };
+
+			const float revealage{ m_pRevealageBuffer[currentPixelNr] };
+			if (revealage >= 1.f)
+				continue; // No transparent coverage
+
+			const Vector4& accumulation{ m_pAccumulationBuffer[currentPixelNr] };
+			const float invWeight{ 1.f / std::max(accumulation.w, 1e-5f) };
+			const ColorRGB averageColor{ accumulation.x * invWeight, accumulation.y * invWeight, accumulation.z * invWeight };
+			const float alpha{ 1.f - revealage };
+
+			const ColorRGB dstColor{ UnpackColor(m_pBackBufferPixels[currentPixelNr], m_Settings.sRGBEncoding) };
+
+			m_pBackBufferPixels[currentPixelNr] = PackColor(averageColor * alpha + dstColor * revealage, m_Settings.sRGBEncoding);
+		}
+	}
+}
+
+TransparencyComparison SoftwareRasterizer::CompareTransparencyModes()
+{
+	using Clock = std::chrono::high_resolution_clock;
+	const size_t numPixels{ static_cast<size_t>(m_Width * m_Height) };
+
+	// Both modes start from the same opaque frame, so every tile has to hold valid data first
+	EnsureTilesCleared(0, 0, m_Width - 1, m_Height - 1);
+	const std::vector<uint32_t> opaquePixels(m_pBackBufferPixels, m_pBackBufferPixels + numPixels);
+
+	// The mode that isn't selected goes first => the frame looks the same as without the comparison
+	const bool isSortedSelected{ m_Settings.transparencyMode == TransparencyMode::Sorted };
+	const auto renderMode{ [&](bool isSorted)
+		{
+			const auto start{ Clock::now() };
+			if (isSorted)
+				RenderTransparentSorted();
+			else
+				RenderTransparentWeightedBlended();
+
+			const std::chrono::duration<float, std::milli> time{ Clock::now() - start };
+			return time.count();
+		} };
+
+	const float firstTime{ renderMode(!isSortedSelected) };
+
+	const std::vector<uint32_t> firstPixels(m_pBackBufferPixels, m_pBackBufferPixels + numPixels);
+	std::copy(opaquePixels.begin(), opaquePixels.end(), m_pBackBufferPixels);
+
+	const float secondTime{ renderMode(isSortedSelected) };
+
+	// Image difference
+	double totalError{};
+	int maxChannelError{};
+	for (size_t i{}; i < numPixels; ++i)
+	{
+		for (int shift : { 16, 8, 0 })
+		{
+			const int error{ std::abs(static_cast<int>((firstPixels[i] >> shift) & 0xFF) - static_cast<int>((m_pBackBufferPixels[i] >> shift) & 0xFF)) };
+			totalError += error;
+			maxChannelError = std::max(maxChannelError, error);
+		}
+	}
+
+	TransparencyComparison comparison{};
+	comparison.numTriangles = m_TransparentTriangles.size();
+	comparison.sortedTime = isSortedSelected ? secondTime : firstTime;
+	comparison.oitTime = isSortedSelected ? firstTime : secondTime;
+	comparison.meanChannelError = totalError / (numPixels * 3);
+	comparison.maxChannelError = maxChannelError;
+	return comparison;
+}
@@ -0,0 +1,346 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "Mesh.h"
+#include "PixelFormat.h"
+#include "PipelineStatistics.h"
+#include "VertexStreams.h"
+#include "Meshlets.h"
+#include "BoundingVolumes.h"
+
+namespace dae
+{
+	// CPU rasterizer - renders indexed draws into a packed ARGB8888 color target it does not own
+	// No window and no graphics API, so it builds on every platform (see DualRasterizerCore in CMake)
+	class SoftwareRasterizer final
+	{
+	public:
+		enum class LightingMode
+		{
+			ObservedArea,
+			Diffuse,
+			Specular,
+			Combined
+		};
+
+		enum class PixelColorState
+		{
+			FinalColor,
+			DepthBuffer,
+			Overdraw, // Shaded fragments per pixel
+			TileShadingTime, // Raster + shading time per tile, relative to the slowest tile
+			TileTriangles // Triangles per tile
+		};
+
+		enum class TransparencyMode
+		{
+			Sorted,
+			WeightedBlendedOIT
+		};
+
+		struct Settings
+		{
+			LightingMode lightingMode{ LightingMode::Combined };
+			bool showNormalMap{ true };
+			PixelColorState pixelColorState{ PixelColorState::FinalColor };
+			bool showBoundingBox{ false };
+			bool sRGBEncoding{ false };
+			CullMode cullMode{ CullMode::Back };
+			TransparencyMode transparencyMode{ TransparencyMode::Sorted };
+			bool clusterCulling{ true }; // Meshlets outside the frustum or facing away skip the vertex stage
+		};
+
+		// One indexed draw, everything the pipeline reads from a mesh
+		struct DrawCall
+		{
+			const VertexStreams* pVertices{}; // SoA copy of the vertex buffer (see SoftwareBackend::CreateVertexBuffer)
+			const void* pIndices{}; // uint16_t or uint32_t array, see indexFormat
+			IndexFormat indexFormat{ IndexFormat::UInt32 };
+			uint32_t indexCount{};
+			uint32_t startIndex{};
+			int32_t baseVertex{}; // Added to every index
+			const MeshletMesh* pMeshlets{}; // Set => drawn per meshlet from pVertices in meshlet order, the index fields are ignored
+			const Mesh::Submesh* pSubmeshes{}; // Set => every submesh is drawn instead of the index range above
+			uint32_t submeshCount{};
+			PrimitiveTopology topology{ PrimitiveTopology::TriangleList };
+			Matrix worldMatrix{};
+
+			const Texture* pDiffuseTexture{};
+			const Texture* pNormalTexture{};
+			const Texture* pSpecularTexture{};
+			const Texture* pGlossTexture{};
+		};
+
+		SoftwareRasterizer(int width, int height);
+		~SoftwareRasterizer() = default;
+
+		SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer(SoftwareRasterizer&&) noexcept = delete;
+		SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+		SoftwareRasterizer& operator=(SoftwareRasterizer&&) noexcept = delete;
+
+		// pColorTarget holds width * height pixels without row padding, cleared lazily per tile
+		void BeginFrame(uint32_t* pColorTarget, uint32_t packedClearColor, const Matrix& viewProjMatrix, const Vector3& cameraOrigin, const Settings& settings);
+		void Draw(const DrawCall& drawCall);
+		void DrawInstanced(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount); // The world matrix of the draw call is ignored
+		void SetCullMode(CullMode cullMode) { m_Settings.cullMode = cullMode; };
+
+		// Transparent draws are gathered first, then blended together (order independent or sorted)
+		void BeginTransparentPass();
+		void GatherTransparent(const DrawCall& drawCall);
+		void GatherTransparentInstanced(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount);
+		void RenderTransparentTriangles();
+		TransparencyComparison CompareTransparencyModes(); // Instead of RenderTransparentTriangles, the selected mode stays on screen
+
+		void EndFrame();
+
+		int GetWidth() const { return m_Width; };
+		int GetHeight() const { return m_Height; };
+
+		const PipelineStatistics& GetFrameStatistics() const { return m_LastFrameStatistics; }; // Last finished frame
+
+	private:
+		int m_Width{};
+		int m_Height{};
+
+		Settings m_Settings{};
+		Matrix m_ViewProjMatrix{};
+		Vector3 m_CameraOrigin{};
+		Frustum m_Frustum{}; // World space, from m_ViewProjMatrix
+
+		uint32_t* m_pBackBufferPixels{}; // Color target of this frame
+		std::unique_ptr<float[]> m_pDepthBufferPixels{};
+
+		// Screen Tiles - color and depth are cleared lazily, the first time a tile is touched
+		static constexpr int TILE_SIZE{ 32 };
+		int m_NumTilesX{};
+		int m_NumTilesY{};
+		std::vector<int> m_TileIndices{}; // 0..numTiles-1, iterated by the parallel tile passes
+		std::vector<uint8_t> m_TileCleared{}; // uint8_t instead of bool => tiles can be flagged from different threads
+		uint32_t m_PackedClearColor{};
+
+		void GetTileRect(int tileIndex, int& minX, int& minY, int& maxX, int& maxY) const;
+		void ClearTile(int tileIndex);
+		void EnsureTilesCleared(int minX, int minY, int maxX, int maxY);
+		void ResolveUntouchedTiles();
+
+		// Statistics - the calling thread counts into m_FrameStatistics, parallel tile jobs into their own tile's slot
+		// Merged in EndFrame, no atomics on the hot path
+		PipelineStatistics m_FrameStatistics{};
+		std::vector<PipelineStatistics> m_TileStatistics{};
+		PipelineStatistics m_LastFrameStatistics{};
+
+		// Heatmaps - only gathered while one of them is shown, drawn over the frame in EndFrame
+		static constexpr int HEATMAP_MAX_OVERDRAW{ 8 }; // Shaded fragments per pixel shown as full red
+		static constexpr int HEATMAP_MAX_TILE_TRIANGLES{ 128 };
+		std::unique_ptr<uint16_t[]> m_pOverdrawBuffer{};
+		std::vector<float> m_TileShadingTimes{}; // ms
+		std::vector<uint32_t> m_TileTriangleCounts{};
+
+		bool IsGatheringTileHeatmap() const;
+		void AddTriangleToTileHeatmaps(int minX, int minY, int maxX, int maxY, float shadingTime); // Time is split over the tiles by bounding box overlap
+		void ResolveHeatmap();
+
+		// Vertex Stage - sized to the largest mesh so far, large meshes are transformed in parallel chunks
+		static constexpr size_t PARALLEL_TRANSFORM_MIN_VERTICES{ 16384 };
+		static constexpr size_t TRANSFORM_CHUNK_SIZE{ 4096 }; // Multiple of VertexStreams::BATCH_SIZE
+		std::vector<VertexOut> m_TransformedMeshVertices{};
+		std::vector<size_t> m_TransformChunkStarts{};
+
+		// What m_TransformedMeshVertices holds, reset every frame
+		const VertexStreams* m_pTransformedVertexStreams{};
+		Matrix m_TransformedWorldMatrix{};
+
+		void TransformDrawCallVertices(const DrawCall& drawCall); // Skipped when the previous draw transformed the same buffer and world matrix
+
+		// Cluster Culling - meshlets of the last transformed draw that survived, only their vertices are transformed
+		std::vector<uint32_t> m_VisibleMeshlets{};
+
+		void CullMeshlets(const DrawCall& drawCall, const Matrix& worldMatrix); // Appends the survivors to m_VisibleMeshlets
+		void TransformVisibleMeshlets(const DrawCall& drawCall, const Matrix& WVPMatrix);
+
+		// Instancing - the instances of a batch are transformed together in one pass, instance i owns numVertices slots from i * numVertices
+		// The batch is capped so m_TransformedMeshVertices doesn't grow with the instance count
+		static constexpr size_t INSTANCE_BATCH_MAX_VERTICES{ 131072 }; // 7.5 MB of VertexOut, at least one instance per batch
+		struct InstanceTransformJob
+		{
+			uint32_t instance; // Within the batch
+			size_t firstVertex;
+			size_t lastVertex;
+		};
+		std::vector<InstanceTransformJob> m_InstanceTransformJobs{};
+		std::vector<VertexTransformConstants> m_InstanceConstants{};
+		std::vector<size_t> m_InstanceMeshletStarts{}; // Into m_VisibleMeshlets per instance of the batch, one more for the end of the last
+
+		void TransformInstanceBatch(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount);
+
+		template <typename TriangleFunction>
+		inline void AssembleInstancedTriangles(const DrawCall& drawCall, const Matrix* pWorldMatrices, uint32_t instanceCount, TriangleFunction&& triangleFunction)
+		{
+			if (instanceCount == 0)
+				return;
+
+			// Every submesh of an instance is assembled from the same transform
+			const size_t numVertices{ drawCall.pVertices->numVertices };
+			const uint32_t batchSize{ static_cast<uint32_t>(std::clamp<size_t>(INSTANCE_BATCH_MAX_VERTICES / std::max<size_t>(numVertices, 1), 1, instanceCount)) };
+
+			for (uint32_t firstInstance{}; firstInstance < instanceCount; firstInstance += batchSize)
+			{
+				const uint32_t batchCount{ std::min(batchSize, instanceCount - firstInstance) };
+				TransformInstanceBatch(drawCall, pWorldMatrices + firstInstance, batchCount);
+
+				for (uint32_t instance{}; instance < batchCount; ++instance)
+				{
+					AssembleTriangles(drawCall, m_TransformedMeshVertices.data() + instance * numVertices,
+						m_VisibleMeshlets.data() + m_InstanceMeshletStarts[instance], m_VisibleMeshlets.data() + m_InstanceMeshletStarts[instance + 1], triangleFunction);
+				}
+			}
+
+			// m_TransformedMeshVertices no longer holds a single draw
+			m_pTransformedVertexStreams = nullptr;
+		}
+
+		// Shaded colors of one row, waiting to be packed (sized to the screen width)
+		std::vector<float> m_SpanRed{};
+		std::vector<float> m_SpanGreen{};
+		std::vector<float> m_SpanBlue{};
+		std::vector<int> m_SpanPixelNumbers{};
+		std::vector<uint32_t> m_SpanPackedPixels{};
+
+		// Primitive Assembly - calls triangleFunction for every screen triangle that passes the optimizations
+		template <typename TriangleFunction>
+		inline void AssembleTriangles(const DrawCall& drawCall, TriangleFunction&& triangleFunction)
+		{
+			AssembleTriangles(drawCall, m_TransformedMeshVertices.data(), m_VisibleMeshlets.data(), m_VisibleMeshlets.data() + m_VisibleMeshlets.size(), triangleFunction);
+		}
+
+		// pVertices are the transformed vertices of one draw or instance, [pFirstMeshlet, pLastMeshlet) its visible meshlets
+		template <typename TriangleFunction>
+		inline void AssembleTriangles(const DrawCall& drawCall, const VertexOut* pVertices, const uint32_t* pFirstMeshlet, const uint32_t* pLastMeshlet,
+			TriangleFunction& triangleFunction)
+		{
+			if (drawCall.pMeshlets)
+			{
+				// 8-bit local indices, relative to the first vertex of their meshlet
+				const MeshletMesh& meshletMesh{ *drawCall.pMeshlets };
+				for (const uint32_t* pMeshletIndex{ pFirstMeshlet }; pMeshletIndex != pLastMeshlet; ++pMeshletIndex)
+				{
+					const Meshlet& meshlet{ meshletMesh.meshlets[*pMeshletIndex] };
+					AssembleIndexedTriangles(meshletMesh.triangles.data(), meshlet.triangleOffset * 3, (meshlet.triangleOffset + meshlet.triangleCount) * 3,
+						pVertices + meshlet.vertexOffset, PrimitiveTopology::TriangleList, triangleFunction);
+				}
+			}
+			else if (drawCall.pSubmeshes)
+			{
+				for (uint32_t submesh{}; submesh < drawCall.submeshCount; ++submesh)
+				{
+					const Mesh::Submesh& range{ drawCall.pSubmeshes[submesh] };
+					AssembleIndexRange(drawCall, range.startIndex, range.indexCount, pVertices + range.baseVertex, triangleFunction);
+				}
+			}
+			else
+			{
+				AssembleIndexRange(drawCall, drawCall.startIndex, drawCall.indexCount, pVertices + drawCall.baseVertex, triangleFunction);
+			}
+		}
+
+		template <typename TriangleFunction>
+		inline void AssembleIndexRange(const DrawCall& drawCall, uint32_t startIndex, uint32_t indexCount, const VertexOut* pVertices, TriangleFunction& triangleFunction)
+		{
+			if (drawCall.indexFormat == IndexFormat::UInt16)
+			{
+				AssembleIndexedTriangles(static_cast<const uint16_t*>(drawCall.pIndices), startIndex, startIndex + indexCount, pVertices, drawCall.topology, triangleFunction);
+			}
+			else
+			{
+				AssembleIndexedTriangles(static_cast<const uint32_t*>(drawCall.pIndices), startIndex, startIndex + indexCount, pVertices, drawCall.topology, triangleFunction);
+			}
+		}
+
+		// One instantiation per index width => the index loads stay narrow in the hot loop
+		template <typename IndexType, typename TriangleFunction>
+		inline void AssembleIndexedTriangles(const IndexType* meshIndices, size_t firstIndex, size_t lastIndex, const VertexOut* pVertices,
+			PrimitiveTopology topology, TriangleFunction& triangleFunction)
+		{
+			if (topology == PrimitiveTopology::TriangleList)
+			{
+				for (size_t i{ firstIndex }; i + 2 < lastIndex; i += 3)
+				{
+					std::array<VertexOut, 3> screenTri{ pVertices[meshIndices[i]],
+						pVertices[meshIndices[i + 1]],
+						pVertices[meshIndices[i + 2]] };
+
+					if (!PassTriangleOptimizations(screenTri))
+						continue; // Skip triangle
+
+					++m_FrameStatistics.trianglesRasterized;
+					triangleFunction(screenTri);
+				}
+			}
+			else
+			{
+				for (size_t i = firstIndex; i + 2 < lastIndex; ++i)
+				{
+					std::array<VertexOut, 3> screenTri{};
+
+					if ((i - firstIndex) & 1)
+					{
+						screenTri = { pVertices[meshIndices[i]],
+						pVertices[meshIndices[i + 2]],
+						pVertices[meshIndices[i + 1]] };
+					}
+					else
+					{
+						screenTri = { pVertices[meshIndices[i]],
+						pVertices[meshIndices[i + 1]],
+						pVertices[meshIndices[i + 2]] };
+					}
+
+					if (!PassTriangleOptimizations(screenTri))
+						continue; // Skip triangle
+
+					++m_FrameStatistics.trianglesRasterized;
+					triangleFunction(screenTri);
+				}
+			}
+		}
+
+		void RasterizationStage(const DrawCall& drawCall, const std::array<VertexOut, 3>& screenTri);
+
+		void VertexTransformationFunction(const VertexStreams& vertices_in, std::vector<VertexOut>& vertices_out,
+			const Matrix& WVPMatrix, const Matrix& meshWorldMatrix);
+
+		bool PassTriangleOptimizations(const std::array<VertexOut, 3>& screenTri); // Counts the submitted and culled triangles
+
+		ColorRGB PixelShading(const VertexIn& pixel, const DrawCall& drawCall, const ColorRGB& pixelColor) const;
+
+		void FillRectangle(int x0, int y0, int x1, int y1, const ColorRGB& color) const;
+
+		// --- TRANSPARENCY ---
+		struct TransparentTriangle
+		{
+			std::array<VertexOut, 3> vertices{};
+			const Texture* pDiffuseTexture{};
+			float viewDepth{}; // Average view space depth, only used as sort key
+		};
+		std::vector<TransparentTriangle> m_TransparentTriangles{};
+
+		// Weighted Blended OIT targets (McGuire & Bavoil), resolved per tile
+		std::vector<std::vector<uint32_t>> m_TileTriangleBins{}; // Indices into m_TransparentTriangles
+
+		std::unique_ptr<Vector4[]> m_pAccumulationBuffer{}; // xyz = weighted premultiplied color, w = weighted alpha
+		std::unique_ptr<float[]> m_pRevealageBuffer{};
+
+		void RenderTransparentSorted();
+		void RenderTransparentWeightedBlended();
+		void BinTransparentTriangles();
+		void RasterizeTransparentTriangle(const TransparentTriangle& triangle, int minX, int minY, int maxX, int maxY, TransparencyMode transparencyMode,
+			PipelineStatistics& statistics);
+		void ResolveTransparencyTile(int tileIndex);
+	};
+}
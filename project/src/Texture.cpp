@@ -2,13 +2,12 @@
 #include "Vector2.h"
 #include <SDL_image.h>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace dae;
 
-#define SAFE_RELEASE(p) \
-if (p) {p->Release(); p = nullptr; }
-
 Texture::Texture(SDL_Surface * pSurface) :
 	m_pSurface{ pSurface },
 	m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
@@ -17,9 +16,6 @@ Texture::Texture(SDL_Surface * pSurface) :
 
 Texture::~Texture()
 {
-	SAFE_RELEASE(m_pSRV);
-	SAFE_RELEASE(m_pResourceTexture);
-
 	if (m_pSurface)
 	{
 		SDL_FreeSurface(m_pSurface);
@@ -28,7 +24,7 @@ Texture::~Texture()
 	}
 }
 
-Texture* Texture::LoadFromFile(ID3D11Device* device, const std::string& filePath)
+Texture* Texture::LoadFromFile(const std::string& filePath)
 {
 	SDL_Surface* surface{ IMG_Load(filePath.c_str()) };
 
@@ -38,69 +34,22 @@ Texture* Texture::LoadFromFile(ID3D11Device* device, const std::string& filePath
 		return nullptr;
 	}
 
-	Texture* newTexture{ new Texture(surface) };
-
-	// ----- Create Texture2D -----
-	D3D11_TEXTURE2D_DESC desc{};
-	desc.Width = surface->w;
-	desc.Height = surface->h;
-	desc.MipLevels = 1;
-	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	desc.SampleDesc.Count = 1;
-	desc.SampleDesc.Quality = 0;
-	desc.Usage = D3D11_USAGE_IMMUTABLE;
-	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-	desc.CPUAccessFlags = 0;
-	desc.MiscFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA initData{};
-	initData.pSysMem = surface->pixels;
-	initData.SysMemPitch = static_cast<UINT>(surface->pitch);
-	initData.SysMemSlicePitch = static_cast<UINT>(surface->h * surface->pitch);
-
-	HRESULT result{ device->CreateTexture2D(&desc, &initData, &newTexture->m_pResourceTexture) };
-	if (FAILED(result))
-	{
-		std::wcout << "Failed to create Texture2D\n";
-		// Free resources correctly
-		SDL_FreeSurface(surface);
-		delete newTexture;
-		return nullptr;
-	}
-
-	// ----- Create SRV -----
-	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-	srvDesc.Format = desc.Format;
-	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = 1;
-
-	result = device->CreateShaderResourceView(newTexture->m_pResourceTexture, &srvDesc, &newTexture->m_pSRV);
-	if (FAILED(result))
-	{
-		std::wcout << "Failed to create SRV\n";
-		// Free resources correctly
-		SDL_FreeSurface(surface);
-		delete newTexture;
-		return nullptr;
-	}
-
-	//SDL_FreeSurface(surface); // Not needed anymore
-
-	return newTexture;
+	return new Texture(surface);
 }
 
-ID3D11ShaderResourceView* Texture::GetSRV() const
+// Wrap addressing like the hardware samplers, some meshes have UVs just outside [0, 1]
+int Texture::GetPixelIndex(const Vector2& uv) const
 {
-	return m_pSRV;
+	const int x{ static_cast<int>((uv.x - std::floor(uv.x)) * m_pSurface->w) };
+	const int y{ static_cast<int>((uv.y - std::floor(uv.y)) * m_pSurface->h) };
+
+	// uv - floor(uv) rounds up to 1 for tiny negative values
+	return std::min(x, m_pSurface->w - 1) + std::min(y, m_pSurface->h - 1) * m_pSurface->w;
 }
 
 ColorRGB Texture::Sample(const Vector2& uv) const
 {
-	int x{ static_cast<int>(uv.x * m_pSurface->w) };
-	int y{ static_cast<int>(uv.y * m_pSurface->h) };
-
-	int pixelIndex{ x + y * m_pSurface->w };
+	const int pixelIndex{ GetPixelIndex(uv) };
 	uint32_t pixel{ m_pSurfacePixels[pixelIndex] };
 
 	uint8_t r, g, b;
@@ -108,3 +57,15 @@ ColorRGB Texture::Sample(const Vector2& uv) const
 
 	return ColorRGB(r / 255.f, g / 255.f, b / 255.f);
 }
+
+ColorRGB Texture::Sample(const Vector2& uv, float& outAlpha) const
+{
+	const int pixelIndex{ GetPixelIndex(uv) };
+	uint32_t pixel{ m_pSurfacePixels[pixelIndex] };
+
+	uint8_t r, g, b, a;
+	SDL_GetRGBA(pixel, m_pSurface->format, &r, &g, &b, &a);
+
+	outAlpha = a / 255.f;
+	return ColorRGB(r / 255.f, g / 255.f, b / 255.f);
+}
@@ -1,35 +1,38 @@
 #pragma once
 #include <SDL_surface.h>
 #include <string>
-// DirectX Headers
-#include <dxgi.h>
-#include <d3d11.h>
-#include <d3dcompiler.h>
-#include <d3dx11effect.h>
+#include <cstdint>
 
 #include "ColorRGB.h"
 #include "Vector2.h"
 
 using namespace dae;
 
+// CPU texture, sampled by the software rasterizer (the GPU copy lives in D3D11Texture)
 class Texture final
 {
 public:
 	~Texture();
-	static Texture* LoadFromFile(ID3D11Device* device, const std::string& filePath);
 
-	ID3D11ShaderResourceView* GetSRV() const;
+	Texture(const Texture&) = delete;
+	Texture(Texture&&) noexcept = delete;
+	Texture& operator=(const Texture&) = delete;
+	Texture& operator=(Texture&&) noexcept = delete;
+
+	static Texture* LoadFromFile(const std::string& filePath);
+
+	const SDL_Surface* GetSurface() const { return m_pSurface; };
 
 	// --- SOFTWARE ---
 	ColorRGB Sample(const Vector2& uv) const;
+	ColorRGB Sample(const Vector2& uv, float& outAlpha) const;
 
 private:
 	Texture(SDL_Surface* pSurface);
 
-	ID3D11Texture2D* m_pResourceTexture{};
-	ID3D11ShaderResourceView* m_pSRV{};
-
 	// --- SOFTWARE ---
+	int GetPixelIndex(const Vector2& uv) const;
+
 	SDL_Surface* m_pSurface;
 	uint32_t* m_pSurfacePixels;
 
@@ -1,31 +1,43 @@
 #include "Timer.h"
+#include <algorithm>
 #include <iostream>
-#include <numeric>
-#include <fstream>
 #include "SDL.h"
 using namespace dae;
 
 Timer::Timer()
 {
-	const uint64_t countsPerSecond = SDL_GetPerformanceFrequency();
-	m_SecondsPerCount = 1.0f / static_cast<float>(countsPerSecond);
+	m_CountsPerSecond = SDL_GetPerformanceFrequency();
+}
+
+uint64_t Timer::GetTimestamp() const
+{
+	// Split in whole seconds and the rest, counts * 1e9 would overflow after a few days
+	const uint64_t counts = SDL_GetPerformanceCounter();
+	return (counts / m_CountsPerSecond) * 1'000'000'000 + (counts % m_CountsPerSecond) * 1'000'000'000 / m_CountsPerSecond;
 }
 
 void Timer::Reset()
 {
-	const uint64_t currentTime = SDL_GetPerformanceCounter();
+	const uint64_t currentTime = GetTimestamp();
 
 	m_BaseTime = currentTime;
 	m_PreviousTime = currentTime;
+	m_PausedTime = 0;
 	m_StopTime = 0;
-	m_FPSTimer = 0.0f;
+	m_FPSTimer = 0;
 	m_FPSCount = 0;
 	m_IsStopped = false;
+
+	m_RecentFrameIndex = 0;
+	m_NumRecentFrames = 0;
+	m_FrameTimeHistogram.Reset();
+	m_NumStalls = 0;
+	m_IsLastFrameStall = false;
 }
 
 void Timer::Start()
 {
-	const uint64_t startTime = SDL_GetPerformanceCounter();
+	const uint64_t startTime = GetTimestamp();
 
 	if (m_IsStopped)
 	{
@@ -37,93 +49,50 @@ void Timer::Start()
 	}
 }
 
-void Timer::StartBenchmark(int numFrames)
-{
-	if (m_BenchmarkActive)
-	{
-		std::cout << "(Benchmark already running)";
-		return;
-	}
-
-	m_BenchmarkActive = true;
-
-	m_BenchmarkAvg = 0.f;
-	m_BenchmarkHigh = FLT_MIN;
-	m_BenchmarkLow = FLT_MAX;
-
-	m_BenchmarkFrames = numFrames;
-	m_BenchmarkCurrFrame = 0;
-
-	m_Benchmarks.clear();
-	m_Benchmarks.resize(m_BenchmarkFrames);
-
-	std::cout << "**BENCHMARK STARTED**\n";
-}
-
 void Timer::Update()
 {
 	if (m_IsStopped)
 	{
 		m_FPS = 0;
-		m_ElapsedTime = 0.0f;
-		m_TotalTime = (float)(((m_StopTime - m_PausedTime) - m_BaseTime) * m_BaseTime);
+		m_ElapsedTime = 0;
+		m_TotalTime = (m_StopTime - m_PausedTime) - m_BaseTime;
 		return;
 	}
 
-	const uint64_t currentTime = SDL_GetPerformanceCounter();
+	const uint64_t currentTime = GetTimestamp();
 	m_CurrentTime = currentTime;
 
-	m_ElapsedTime = (float)((m_CurrentTime - m_PreviousTime) * m_SecondsPerCount);
+	const uint64_t frameTime = m_CurrentTime - m_PreviousTime;
+	m_ElapsedTime = frameTime;
 	m_PreviousTime = m_CurrentTime;
 
-	if (m_ElapsedTime < 0.0f)
-		m_ElapsedTime = 0.0f;
-
 	if (m_ForceElapsedUpperBound && m_ElapsedTime > m_ElapsedUpperBound)
 	{
 		m_ElapsedTime = m_ElapsedUpperBound;
 	}
 
-	m_TotalTime = (float)(((m_CurrentTime - m_PausedTime) - m_BaseTime) * m_SecondsPerCount);
+	m_TotalTime = (m_CurrentTime - m_PausedTime) - m_BaseTime;
+
+	//FRAME TIME LOGIC - the real frame time, not the bounded one
+	m_RecentFrameTimes[m_RecentFrameIndex] = frameTime;
+	m_RecentFrameIndex = (m_RecentFrameIndex + 1) % FRAME_HISTORY_SIZE;
+	m_NumRecentFrames = std::min(m_NumRecentFrames + 1, FRAME_HISTORY_SIZE);
+
+	m_FrameTimeHistogram.Record(frameTime);
+
+	m_IsLastFrameStall = m_FrameBudget > 0 && frameTime > m_FrameBudget;
+	if (m_IsLastFrameStall)
+		++m_NumStalls;
 
 	//FPS LOGIC
 	m_FPSTimer += m_ElapsedTime;
 	++m_FPSCount;
-	if (m_FPSTimer >= 1.0f)
+	if (m_FPSTimer >= 1'000'000'000)
 	{
-		m_dFPS = m_FPSCount / m_FPSTimer;
+		m_dFPS = static_cast<float>(m_FPSCount / (m_FPSTimer * 1e-9));
 		m_FPS = m_FPSCount;
 		m_FPSCount = 0;
-		m_FPSTimer = 0.0f;
-
-		if (m_BenchmarkActive)
-		{
-			m_Benchmarks[m_BenchmarkCurrFrame] = m_dFPS;
-
-			m_BenchmarkLow = std::min(m_BenchmarkLow, m_dFPS);
-			m_BenchmarkHigh = std::max(m_BenchmarkHigh, m_dFPS);
-
-			++m_BenchmarkCurrFrame;
-			if (m_BenchmarkCurrFrame >= m_BenchmarkFrames)
-			{
-				m_BenchmarkActive = false;
-				m_BenchmarkAvg = std::accumulate(m_Benchmarks.begin(), m_Benchmarks.end(), 0.f) / float(m_BenchmarkFrames);
-
-				//print
-				std::cout << "**BENCHMARK FINISHED**\n";
-				std::cout << ">> HIGH = " << m_BenchmarkHigh << std::endl;
-				std::cout << ">> LOW = " << m_BenchmarkLow << std::endl;
-				std::cout << ">> AVG = " << m_BenchmarkAvg << std::endl;
-
-				//file save
-				std::ofstream fileStream("benchmark.txt");
-				fileStream << "FRAMES = " << m_BenchmarkCurrFrame << std::endl;
-				fileStream << "HIGH = " << m_BenchmarkHigh << std::endl;
-				fileStream << "LOW = " << m_BenchmarkLow << std::endl;
-				fileStream << "AVG = " << m_BenchmarkAvg << std::endl;
-				fileStream.close();
-			}
-		}
+		m_FPSTimer = 0;
 	}
 }
 
@@ -131,9 +100,17 @@ void Timer::Stop()
 {
 	if (!m_IsStopped)
 	{
-		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const uint64_t currentTime = GetTimestamp();
 
 		m_StopTime = currentTime;
 		m_IsStopped = true;
 	}
 }
+
+uint64_t Timer::GetRecentFrameTime(size_t age) const
+{
+	if (age >= m_NumRecentFrames)
+		return 0;
+
+	return m_RecentFrameTimes[(m_RecentFrameIndex + FRAME_HISTORY_SIZE - 1 - age) % FRAME_HISTORY_SIZE];
+}
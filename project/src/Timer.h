@@ -1,9 +1,13 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+
+#include "FrameTimeHistogram.h"
 
 namespace dae
 {
+	// Times are kept as integer ns => no precision is lost after long uptimes
 	class Timer final
 	{
 	public:
@@ -15,8 +19,6 @@ namespace dae
 		Timer& operator=(const Timer&) = delete;
 		Timer& operator=(Timer&&) noexcept = delete;
 
-		void StartBenchmark(int numFrames = 10);
-
 		void Reset();
 		void Start();
 		void Update();
@@ -24,11 +26,31 @@ namespace dae
 
 		uint32_t GetFPS() const { return m_FPS; };
 		float GetdFPS() const { return m_dFPS; };
-		float GetElapsed() const { return m_ElapsedTime; };
-		float GetTotal() const { return m_TotalTime; };
+		float GetElapsed() const { return static_cast<float>(m_ElapsedTime * 1e-9); }; // s
+		double GetTotal() const { return m_TotalTime * 1e-9; }; // s
+		uint64_t GetElapsedNs() const { return m_ElapsedTime; };
+		uint64_t GetTotalNs() const { return m_TotalTime; };
 		bool IsRunning() const { return !m_IsStopped; };
 
+		uint64_t GetTimestamp() const; // ns, monotonic
+
+		// Ring of the most recent frame times (ns), age 0 is the last frame
+		static constexpr size_t FRAME_HISTORY_SIZE{ 256 };
+		size_t GetNumRecentFrames() const { return m_NumRecentFrames; };
+		uint64_t GetRecentFrameTime(size_t age) const;
+
+		// Every frame since the last Reset
+		const FrameTimeHistogram& GetFrameTimeHistogram() const { return m_FrameTimeHistogram; };
+
+		// Stalls - frames that took longer than the budget (ns, 0 => no stall detection)
+		void SetFrameBudget(uint64_t frameBudget) { m_FrameBudget = frameBudget; };
+		uint64_t GetFrameBudget() const { return m_FrameBudget; };
+		bool IsLastFrameStall() const { return m_IsLastFrameStall; };
+		uint64_t GetNumStalls() const { return m_NumStalls; };
+
 	private:
+		uint64_t m_CountsPerSecond = 0;
+
 		uint64_t m_BaseTime = 0;
 		uint64_t m_PausedTime = 0;
 		uint64_t m_StopTime = 0;
@@ -39,21 +61,21 @@ namespace dae
 		float m_dFPS = 0.0f;
 		uint32_t m_FPSCount = 0;
 
-		float m_TotalTime = 0.0f;
-		float m_ElapsedTime = 0.0f;
-		float m_SecondsPerCount = 0.0f;
-		float m_ElapsedUpperBound = 0.03f;
-		float m_FPSTimer = 0.0f;
+		uint64_t m_TotalTime = 0;
+		uint64_t m_ElapsedTime = 0;
+		uint64_t m_ElapsedUpperBound = 30'000'000;
+		uint64_t m_FPSTimer = 0;
+
+		std::array<uint64_t, FRAME_HISTORY_SIZE> m_RecentFrameTimes{};
+		size_t m_RecentFrameIndex = 0; // Next slot to write
+		size_t m_NumRecentFrames = 0;
+		FrameTimeHistogram m_FrameTimeHistogram{};
+
+		uint64_t m_FrameBudget = 0;
+		uint64_t m_NumStalls = 0;
+		bool m_IsLastFrameStall = false;
 
 		bool m_IsStopped = true;
 		bool m_ForceElapsedUpperBound = false;
-
-		bool m_BenchmarkActive = false;
-		float m_BenchmarkHigh{ 0.f };
-		float m_BenchmarkLow{ 0.f };
-		float m_BenchmarkAvg{ 0.f };
-		int m_BenchmarkFrames{ 0 };
-		int m_BenchmarkCurrFrame{ 0 };
-		std::vector<float> m_Benchmarks{};
 	};
 }
@@ -1,7 +1,7 @@
 #include "TransparencyEffect.h"
 #include <iostream>
 #include <sstream> // string stream for wstringstream
-#include "Texture.h"
+#include "D3D11Texture.h"
 
 TransparencyEffect::TransparencyEffect(ID3D11Device* pDevice)
 	:Effect::Effect(pDevice, L"resources/PartCoverage.fx")
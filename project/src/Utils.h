@@ -8,8 +8,10 @@ namespace dae
 	namespace Utils
 	{
 		//Just parses vertices and indices
+#if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
+#endif
 		static bool ParseOBJ(const std::string& filename, std::vector<VertexIn>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
 		{
 			std::ifstream file(filename);
@@ -159,6 +161,8 @@ namespace dae
 
 			return true;
 		}
+#if defined(_MSC_VER)
 #pragma warning(pop)
+#endif
 	}
 }
\ No newline at end of file
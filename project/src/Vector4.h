@@ -1,10 +1,13 @@
 #pragma once
+#include "Vector3.h"
+#include "SIMD.h"
 
 namespace dae
 {
 	struct Vector2;
-	struct Vector3;
-	struct Vector4 final
+
+	// 16-byte aligned => loads straight into an SSE register (see Matrix)
+	struct alignas(16) Vector4 final
 	{
 		float x;
 		float y;
@@ -12,8 +15,8 @@ namespace dae
 		float w;
 
 		Vector4() = default;
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(const Vector3& v, float _w);
+		Vector4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+		Vector4(const Vector3& v, float _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
 
 		float Magnitude() const;
 		float SqrMagnitude() const;
@@ -33,5 +36,58 @@ namespace dae
 		float& operator[](int index);
 		float operator[](int index) const;
 		bool operator==(const Vector4& v) const;
+
+#if defined(DAE_SIMD_SSE)
+		__m128 Load() const { return _mm_load_ps(&x); }
+		void Store(__m128 v) { _mm_store_ps(&x, v); }
+		static Vector4 FromRegister(__m128 v) { Vector4 result; result.Store(v); return result; }
+#endif
 	};
+
+#pragma region Inline Definitions
+	inline float Vector4::Dot(const Vector4& v1, const Vector4& v2)
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	}
+
+	inline Vector4 Vector4::operator*(float scale) const
+	{
+#if defined(DAE_SIMD_SSE)
+		return FromRegister(_mm_mul_ps(Load(), _mm_set1_ps(scale)));
+#else
+		return { x * scale, y * scale, z * scale, w * scale };
+#endif
+	}
+
+	inline Vector4 Vector4::operator+(const Vector4& v) const
+	{
+#if defined(DAE_SIMD_SSE)
+		return FromRegister(_mm_add_ps(Load(), v.Load()));
+#else
+		return { x + v.x, y + v.y, z + v.z, w + v.w };
+#endif
+	}
+
+	inline Vector4 Vector4::operator-(const Vector4& v) const
+	{
+#if defined(DAE_SIMD_SSE)
+		return FromRegister(_mm_sub_ps(Load(), v.Load()));
+#else
+		return { x - v.x, y - v.y, z - v.z, w - v.w };
+#endif
+	}
+
+	inline Vector4& Vector4::operator+=(const Vector4& v)
+	{
+#if defined(DAE_SIMD_SSE)
+		Store(_mm_add_ps(Load(), v.Load()));
+#else
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		w += v.w;
+#endif
+		return *this;
+	}
+#pragma endregion
 }
@@ -0,0 +1,194 @@
+#include "VertexFormat.h"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr float UNORM16_MAX{ 65535.f };
+		constexpr float SNORM16_MAX{ 32767.f };
+
+		uint16_t ToUnorm16(float value)
+		{
+			return static_cast<uint16_t>(std::lround(Saturate(value) * UNORM16_MAX));
+		}
+
+		int16_t ToSnorm16(float value)
+		{
+			return static_cast<int16_t>(std::lround(Clamp(value, -1.f, 1.f) * SNORM16_MAX));
+		}
+
+		// D3D SNORM rule: -32768 and -32767 both decode to -1
+		float FromSnorm16(int16_t value)
+		{
+			return std::max(value * SNORM16_SCALE, -1.f);
+		}
+
+		float SignNotZero(float value)
+		{
+			return value >= 0.f ? 1.f : -1.f;
+		}
+	}
+
+	QuantizedVertexBuffer QuantizeVertices(const std::vector<VertexIn>& vertices)
+	{
+		QuantizedVertexBuffer buffer{};
+		if (vertices.empty())
+			return buffer;
+
+		Vector3 minPosition{ vertices[0].position };
+		Vector3 maxPosition{ vertices[0].position };
+		for (const VertexIn& vertex : vertices)
+		{
+			minPosition = Vector3::Min(minPosition, vertex.position);
+			maxPosition = Vector3::Max(maxPosition, vertex.position);
+		}
+
+		buffer.positionMin = minPosition;
+		buffer.positionExtent = maxPosition - minPosition;
+
+		const auto toUnit{ [](float value, float min, float extent) { return extent > 0.f ? (value - min) / extent : 0.f; } };
+
+		buffer.vertices.reserve(vertices.size());
+		for (const VertexIn& vertex : vertices)
+		{
+			QuantizedVertex quantized{};
+			quantized.position[0] = ToUnorm16(toUnit(vertex.position.x, minPosition.x, buffer.positionExtent.x));
+			quantized.position[1] = ToUnorm16(toUnit(vertex.position.y, minPosition.y, buffer.positionExtent.y));
+			quantized.position[2] = ToUnorm16(toUnit(vertex.position.z, minPosition.z, buffer.positionExtent.z));
+			quantized.position[3] = ToUnorm16(1.f); // VertexIn has no handedness, the binormal is always cross(N, T)
+
+			quantized.UVCoordinate[0] = FloatToHalf(vertex.UVCoordinate.x);
+			quantized.UVCoordinate[1] = FloatToHalf(vertex.UVCoordinate.y);
+
+			EncodeOctahedral(vertex.normal, quantized.normal[0], quantized.normal[1]);
+			EncodeOctahedral(vertex.tangent, quantized.tangent[0], quantized.tangent[1]);
+
+			buffer.vertices.emplace_back(quantized);
+		}
+
+		return buffer;
+	}
+
+	// Same math as DecodeVertex in PosCol3D.fx and the batched decoder in TransformVertexStreams
+	VertexIn DequantizeVertex(const QuantizedVertex& vertex, const Vector3& positionMin, const Vector3& positionExtent)
+	{
+		VertexIn result{};
+		result.position = Vector3{ positionMin.x + vertex.position[0] * UNORM16_SCALE * positionExtent.x,
+			positionMin.y + vertex.position[1] * UNORM16_SCALE * positionExtent.y,
+			positionMin.z + vertex.position[2] * UNORM16_SCALE * positionExtent.z };
+		result.UVCoordinate = Vector2{ HalfToFloat(vertex.UVCoordinate[0]), HalfToFloat(vertex.UVCoordinate[1]) };
+		result.normal = DecodeOctahedral(vertex.normal[0], vertex.normal[1]);
+		result.tangent = DecodeOctahedral(vertex.tangent[0], vertex.tangent[1]);
+		return result;
+	}
+
+	size_t GetVertexSize(VertexFormat format)
+	{
+		return format == VertexFormat::Quantized ? sizeof(QuantizedVertex) : sizeof(VertexIn);
+	}
+
+	const char* GetVertexFormatName(VertexFormat format)
+	{
+		return format == VertexFormat::Quantized ? "QUANTIZED" : "FLOAT32";
+	}
+
+	uint16_t FloatToHalf(float value)
+	{
+		const uint32_t bits{ std::bit_cast<uint32_t>(value) };
+		const uint32_t sign{ (bits >> 16) & 0x8000u };
+		const uint32_t floatExponent{ (bits >> 23) & 0xFFu };
+		uint32_t mantissa{ bits & 0x7FFFFFu };
+
+		// Infinity and NaN (NaN keeps a mantissa bit)
+		if (floatExponent == 0xFFu)
+			return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+		const int exponent{ static_cast<int>(floatExponent) - 127 + 15 };
+		if (exponent >= 31)
+			return static_cast<uint16_t>(sign | 0x7C00u);
+
+		// Subnormal half, the implicit one becomes part of the mantissa
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+				return static_cast<uint16_t>(sign);
+
+			mantissa |= 0x800000u;
+			const int shift{ 14 - exponent };
+			uint32_t half{ mantissa >> shift };
+			const uint32_t remainder{ mantissa & ((1u << shift) - 1u) };
+			const uint32_t halfway{ 1u << (shift - 1) };
+			if (remainder > halfway || (remainder == halfway && (half & 1u)))
+				++half;
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		// A mantissa carry rolls over into the exponent, up to infinity
+		uint32_t half{ (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13) };
+		const uint32_t remainder{ mantissa & 0x1FFFu };
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+			++half;
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		const uint32_t sign{ (value & 0x8000u) << 16 };
+		const uint32_t exponent{ (value >> 10) & 0x1Fu };
+		const uint32_t mantissa{ value & 0x3FFu };
+
+		if (exponent == 0x1Fu)
+			return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+
+		if (exponent == 0)
+		{
+			const float subnormal{ std::ldexp(static_cast<float>(mantissa), -24) };
+			return sign ? -subnormal : subnormal;
+		}
+
+		return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+	}
+
+	// Project onto the octahedron |x| + |y| + |z| = 1, fold the lower half over the diagonals
+	void EncodeOctahedral(const Vector3& direction, int16_t& x, int16_t& y)
+	{
+		const float length{ std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z) };
+		if (length <= 0.f)
+		{
+			x = 0;
+			y = 0;
+			return;
+		}
+
+		float octX{ direction.x / length };
+		float octY{ direction.y / length };
+		if (direction.z < 0.f)
+		{
+			const float foldedX{ (1.f - std::abs(octY)) * SignNotZero(octX) };
+			octY = (1.f - std::abs(octX)) * SignNotZero(octY);
+			octX = foldedX;
+		}
+
+		x = ToSnorm16(octX);
+		y = ToSnorm16(octY);
+	}
+
+	Vector3 DecodeOctahedral(int16_t x, int16_t y)
+	{
+		Vector3 direction{ FromSnorm16(x), FromSnorm16(y), 0.f };
+		direction.z = 1.f - std::abs(direction.x) - std::abs(direction.y);
+
+		// Unfold the lower half
+		const float fold{ Saturate(-direction.z) };
+		direction.x += direction.x >= 0.f ? -fold : fold;
+		direction.y += direction.y >= 0.f ? -fold : fold;
+
+		return direction.Normalized();
+	}
+}
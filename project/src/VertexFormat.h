@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+
+namespace dae
+{
+	// Layout of the vertex buffers a backend creates from a Mesh
+	enum class VertexFormat
+	{
+		Float32,  // VertexIn as is, 56 bytes
+		Quantized, // QuantizedVertex, 20 bytes - decoded in the vertex stage (TransformVertexStreams, PosCol3D.fx)
+
+		Count
+	};
+	constexpr int VERTEX_FORMAT_COUNT{ static_cast<int>(VertexFormat::Count) };
+
+	// 16-bit position relative to the mesh AABB, half float UV, octahedral normal and tangent
+	struct QuantizedVertex
+	{
+		uint16_t position[4]{}; // UNORM16 in [positionMin, positionMin + positionExtent], w = tangent sign (0 => -1, 65535 => +1)
+		uint16_t UVCoordinate[2]{}; // Half floats, UVs may leave [0, 1]
+		int16_t normal[2]{}; // SNORM16, octahedral
+		int16_t tangent[2]{}; // SNORM16, octahedral
+	};
+	static_assert(sizeof(QuantizedVertex) == 20, "QuantizedVertex has to match the R16G16B16A16 + 3 x R16G16 input layout");
+
+	struct QuantizedVertexBuffer
+	{
+		std::vector<QuantizedVertex> vertices{};
+		Vector3 positionMin{};
+		Vector3 positionExtent{}; // AABB size, a flat axis has extent 0 and decodes to positionMin
+	};
+
+	QuantizedVertexBuffer QuantizeVertices(const std::vector<VertexIn>& vertices);
+	VertexIn DequantizeVertex(const QuantizedVertex& vertex, const Vector3& positionMin, const Vector3& positionExtent);
+
+	size_t GetVertexSize(VertexFormat format); // Bytes per vertex in a vertex buffer
+	const char* GetVertexFormatName(VertexFormat format);
+
+	// Dequantization scales - multiplied, not divided, the same way in every decoder
+	constexpr float UNORM16_SCALE{ 1.f / 65535.f };
+	constexpr float SNORM16_SCALE{ 1.f / 32767.f };
+
+	// Building blocks, also used by the batched decoder (TransformVertexStreams)
+	uint16_t FloatToHalf(float value); // Round to nearest even, overflow => infinity
+	float HalfToFloat(uint16_t value);
+	void EncodeOctahedral(const Vector3& direction, int16_t& x, int16_t& y); // direction does not have to be normalized
+	Vector3 DecodeOctahedral(int16_t x, int16_t y); // Normalized
+}
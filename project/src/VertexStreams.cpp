@@ -0,0 +1,260 @@
+#include "VertexStreams.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace dae;
+
+VertexStreams VertexStreams::FromVertices(const std::vector<VertexIn>& vertices)
+{
+	VertexStreams streams{};
+	streams.numVertices = vertices.size();
+
+	// Padding lanes stay zero, they are transformed but never written out
+	const size_t paddedSize{ (vertices.size() + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE };
+	for (std::vector<float>* pStream : { &streams.positionX, &streams.positionY, &streams.positionZ, &streams.u, &streams.v,
+		&streams.normalX, &streams.normalY, &streams.normalZ, &streams.tangentX, &streams.tangentY, &streams.tangentZ })
+	{
+		pStream->resize(paddedSize, 0.f);
+	}
+
+	for (size_t i{}; i < vertices.size(); ++i)
+	{
+		const VertexIn& vertex{ vertices[i] };
+
+		streams.positionX[i] = vertex.position.x;
+		streams.positionY[i] = vertex.position.y;
+		streams.positionZ[i] = vertex.position.z;
+		streams.u[i] = vertex.UVCoordinate.x;
+		streams.v[i] = vertex.UVCoordinate.y;
+		streams.normalX[i] = vertex.normal.x;
+		streams.normalY[i] = vertex.normal.y;
+		streams.normalZ[i] = vertex.normal.z;
+		streams.tangentX[i] = vertex.tangent.x;
+		streams.tangentY[i] = vertex.tangent.y;
+		streams.tangentZ[i] = vertex.tangent.z;
+	}
+
+	return streams;
+}
+
+VertexStreams VertexStreams::FromVertices(const QuantizedVertexBuffer& vertices)
+{
+	VertexStreams streams{};
+	streams.format = VertexFormat::Quantized;
+	streams.numVertices = vertices.vertices.size();
+	streams.positionMin = vertices.positionMin;
+	streams.positionExtent = vertices.positionExtent;
+
+	const size_t paddedSize{ (streams.numVertices + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE };
+	for (std::vector<uint16_t>* pStream : { &streams.quantizedPositionX, &streams.quantizedPositionY, &streams.quantizedPositionZ,
+		&streams.halfU, &streams.halfV })
+	{
+		pStream->resize(paddedSize, uint16_t{ 0 });
+	}
+	for (std::vector<int16_t>* pStream : { &streams.octahedralNormalX, &streams.octahedralNormalY, &streams.octahedralTangentX,
+		&streams.octahedralTangentY })
+	{
+		pStream->resize(paddedSize, int16_t{ 0 });
+	}
+
+	for (size_t i{}; i < streams.numVertices; ++i)
+	{
+		const QuantizedVertex& vertex{ vertices.vertices[i] };
+
+		streams.quantizedPositionX[i] = vertex.position[0];
+		streams.quantizedPositionY[i] = vertex.position[1];
+		streams.quantizedPositionZ[i] = vertex.position[2];
+		streams.halfU[i] = vertex.UVCoordinate[0];
+		streams.halfV[i] = vertex.UVCoordinate[1];
+		streams.octahedralNormalX[i] = vertex.normal[0];
+		streams.octahedralNormalY[i] = vertex.normal[1];
+		streams.octahedralTangentX[i] = vertex.tangent[0];
+		streams.octahedralTangentY[i] = vertex.tangent[1];
+	}
+
+	return streams;
+}
+
+namespace
+{
+	// Same math as DecodeOctahedral, Vector3::Normalized included
+	void DecodeOctahedral8(const int16_t* pX, const int16_t* pY, float* pOutX, float* pOutY, float* pOutZ)
+	{
+		const Float8 zero{ Float8::Set(0.f) };
+		const Float8 one{ Float8::Set(1.f) };
+		const Float8 minusOne{ Float8::Set(-1.f) };
+		const Float8 snormScale{ Float8::Set(SNORM16_SCALE) };
+
+		Float8 x{ Float8::Max(Float8::LoadInt16(pX) * snormScale, minusOne) };
+		Float8 y{ Float8::Max(Float8::LoadInt16(pY) * snormScale, minusOne) };
+		const Float8 z{ one - Float8::Abs(x) - Float8::Abs(y) };
+
+		// Unfold the lower half
+		const Float8 fold{ Float8::Max(zero - z, zero) };
+		x = x - Float8::CopySign(fold, x);
+		y = y - Float8::CopySign(fold, y);
+
+		const Float8 length{ Float8::Sqrt(x * x + y * y + z * z) };
+		(x / length).Store(pOutX);
+		(y / length).Store(pOutY);
+		(z / length).Store(pOutZ);
+	}
+}
+
+void dae::TransformVertexStreams(const VertexStreams& streams, size_t first, size_t last, const VertexTransformConstants& constants,
+	VertexOut* pVerticesOut)
+{
+	assert(first % VertexStreams::BATCH_SIZE == 0);
+	last = std::min(last, streams.numVertices);
+
+	// Every matrix element broadcast to all lanes once, [row][column]
+	Float8 wvp[4][4];
+	Float8 world[4][4];
+	for (int r{}; r < 4; ++r)
+	{
+		for (int c{}; c < 4; ++c)
+		{
+			wvp[r][c] = Float8::Set(constants.worldViewProjectionMatrix[r][c]);
+			world[r][c] = Float8::Set(constants.worldMatrix[r][c]);
+		}
+	}
+
+	const Float8 one{ Float8::Set(1.f) };
+	const Float8 half{ Float8::Set(0.5f) };
+	const Float8 screenWidth{ Float8::Set(constants.screenWidth) };
+	const Float8 screenHeight{ Float8::Set(constants.screenHeight) };
+	const Float8 cameraX{ Float8::Set(constants.cameraOrigin.x) };
+	const Float8 cameraY{ Float8::Set(constants.cameraOrigin.y) };
+	const Float8 cameraZ{ Float8::Set(constants.cameraOrigin.z) };
+
+	// One output component per row, scattered into the VertexOut structs after the batch
+	enum Component { ScreenX, ScreenY, ScreenZ, ScreenW, U, V, NormalX, NormalY, NormalZ, TangentX, TangentY, TangentZ,
+		ViewX, ViewY, ViewZ, NumComponents };
+	alignas(32) float batchOut[NumComponents][Float8::WIDTH];
+
+	// One input stream per row - points into the float streams, or into batchIn for quantized vertices
+	enum Input { PositionX, PositionY, PositionZ, InU, InV, InNormalX, InNormalY, InNormalZ, InTangentX, InTangentY, InTangentZ, NumInputs };
+	alignas(32) float batchIn[NumInputs][Float8::WIDTH];
+	const float* pIn[NumInputs]{};
+
+	const bool isQuantized{ streams.format == VertexFormat::Quantized };
+	if (isQuantized)
+	{
+		for (int input{}; input < NumInputs; ++input)
+		{
+			pIn[input] = batchIn[input];
+		}
+	}
+
+	for (size_t batch{ first }; batch < last; batch += VertexStreams::BATCH_SIZE)
+	{
+		const size_t batchCount{ std::min(VertexStreams::BATCH_SIZE, last - batch) };
+
+		if (isQuantized)
+		{
+			// Decode into batchIn, same math as DequantizeVertex
+			const Float8 unormScale{ Float8::Set(UNORM16_SCALE) };
+			const auto decodePosition{ [&](const std::vector<uint16_t>& stream, float min, float extent, float* pOut)
+				{
+					(Float8::Set(min) + Float8::LoadUint16(&stream[batch]) * unormScale * Float8::Set(extent)).Store(pOut);
+				} };
+
+			decodePosition(streams.quantizedPositionX, streams.positionMin.x, streams.positionExtent.x, batchIn[PositionX]);
+			decodePosition(streams.quantizedPositionY, streams.positionMin.y, streams.positionExtent.y, batchIn[PositionY]);
+			decodePosition(streams.quantizedPositionZ, streams.positionMin.z, streams.positionExtent.z, batchIn[PositionZ]);
+			Float8::LoadHalf(&streams.halfU[batch]).Store(batchIn[InU]);
+			Float8::LoadHalf(&streams.halfV[batch]).Store(batchIn[InV]);
+			DecodeOctahedral8(&streams.octahedralNormalX[batch], &streams.octahedralNormalY[batch],
+				batchIn[InNormalX], batchIn[InNormalY], batchIn[InNormalZ]);
+			DecodeOctahedral8(&streams.octahedralTangentX[batch], &streams.octahedralTangentY[batch],
+				batchIn[InTangentX], batchIn[InTangentY], batchIn[InTangentZ]);
+		}
+		else
+		{
+			pIn[PositionX] = &streams.positionX[batch];
+			pIn[PositionY] = &streams.positionY[batch];
+			pIn[PositionZ] = &streams.positionZ[batch];
+			pIn[InU] = &streams.u[batch];
+			pIn[InV] = &streams.v[batch];
+			pIn[InNormalX] = &streams.normalX[batch];
+			pIn[InNormalY] = &streams.normalY[batch];
+			pIn[InNormalZ] = &streams.normalZ[batch];
+			pIn[InTangentX] = &streams.tangentX[batch];
+			pIn[InTangentY] = &streams.tangentY[batch];
+			pIn[InTangentZ] = &streams.tangentZ[batch];
+		}
+
+		const Float8 px{ Float8::Load(pIn[PositionX]) };
+		const Float8 py{ Float8::Load(pIn[PositionY]) };
+		const Float8 pz{ Float8::Load(pIn[PositionZ]) };
+
+		// Model -> Clip, summed in the order of Matrix::TransformPoint
+		const auto transformPoint{ [&](const Float8 (&matrix)[4][4], int c)
+			{
+				Float8 result{ matrix[0][c] * px };
+				result = Float8::MultiplyAdd(matrix[1][c], py, result);
+				result = Float8::MultiplyAdd(matrix[2][c], pz, result);
+				return result + matrix[3][c];
+			} };
+
+		const Float8 clipW{ transformPoint(wvp, 3) };
+		const Float8 invW{ one / clipW };
+
+		// Perspective Divide
+		const Float8 projectedX{ transformPoint(wvp, 0) * invW };
+		const Float8 projectedY{ transformPoint(wvp, 1) * invW };
+		const Float8 projectedZ{ transformPoint(wvp, 2) * invW };
+
+		// Perspective -> Screen
+		((projectedX + one) * half * screenWidth).Store(batchOut[ScreenX]);
+		((one - projectedY) * half * screenHeight).Store(batchOut[ScreenY]);
+		projectedZ.Store(batchOut[ScreenZ]);
+		invW.Store(batchOut[ScreenW]);
+
+		(Float8::Load(pIn[InU]) * invW).Store(batchOut[U]);
+		(Float8::Load(pIn[InV]) * invW).Store(batchOut[V]);
+
+		// Model -> World, summed in the order of Matrix::TransformVector
+		const auto transformVector{ [&](const Float8& x, const Float8& y, const Float8& z, int c)
+			{
+				Float8 result{ world[0][c] * x };
+				result = Float8::MultiplyAdd(world[1][c], y, result);
+				return Float8::MultiplyAdd(world[2][c], z, result);
+			} };
+
+		const Float8 nx{ Float8::Load(pIn[InNormalX]) };
+		const Float8 ny{ Float8::Load(pIn[InNormalY]) };
+		const Float8 nz{ Float8::Load(pIn[InNormalZ]) };
+		transformVector(nx, ny, nz, 0).Store(batchOut[NormalX]);
+		transformVector(nx, ny, nz, 1).Store(batchOut[NormalY]);
+		transformVector(nx, ny, nz, 2).Store(batchOut[NormalZ]);
+
+		const Float8 tx{ Float8::Load(pIn[InTangentX]) };
+		const Float8 ty{ Float8::Load(pIn[InTangentY]) };
+		const Float8 tz{ Float8::Load(pIn[InTangentZ]) };
+		transformVector(tx, ty, tz, 0).Store(batchOut[TangentX]);
+		transformVector(tx, ty, tz, 1).Store(batchOut[TangentY]);
+		transformVector(tx, ty, tz, 2).Store(batchOut[TangentZ]);
+
+		// View direction, normalized like Vector3::Normalized
+		const Float8 viewX{ cameraX - transformPoint(world, 0) };
+		const Float8 viewY{ cameraY - transformPoint(world, 1) };
+		const Float8 viewZ{ cameraZ - transformPoint(world, 2) };
+		const Float8 viewLength{ Float8::Sqrt(viewX * viewX + viewY * viewY + viewZ * viewZ) };
+		(viewX / viewLength).Store(batchOut[ViewX]);
+		(viewY / viewLength).Store(batchOut[ViewY]);
+		(viewZ / viewLength).Store(batchOut[ViewZ]);
+
+		for (size_t lane{}; lane < batchCount; ++lane)
+		{
+			VertexOut& vertex{ pVerticesOut[batch + lane] };
+			vertex.position = Vector4{ batchOut[ScreenX][lane], batchOut[ScreenY][lane], batchOut[ScreenZ][lane], batchOut[ScreenW][lane] };
+			vertex.UVCoordinate = Vector2{ batchOut[U][lane], batchOut[V][lane] };
+			vertex.normal = Vector3{ batchOut[NormalX][lane], batchOut[NormalY][lane], batchOut[NormalZ][lane] };
+			vertex.tangent = Vector3{ batchOut[TangentX][lane], batchOut[TangentY][lane], batchOut[TangentZ][lane] };
+			vertex.viewDirection = Vector3{ batchOut[ViewX][lane], batchOut[ViewY][lane], batchOut[ViewZ][lane] };
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+#include "Math.h" // Includes dae structs + DataStructs + important enum classes
+#include "VertexFormat.h"
+
+namespace dae
+{
+	// Structure of arrays copy of a vertex buffer - one stream per component, padded to whole batches
+	// Built once when the buffer is created, the vertex stage then loads 8 vertices per component with a single load
+	// Quantized buffers stay quantized (18 instead of 44 bytes per vertex) and are decoded per batch in the vertex stage
+	struct VertexStreams final
+	{
+		static constexpr size_t BATCH_SIZE{ 8 }; // Float8::WIDTH
+
+		VertexFormat format{ VertexFormat::Float32 };
+		size_t numVertices{};
+
+		std::vector<float> positionX{};
+		std::vector<float> positionY{};
+		std::vector<float> positionZ{};
+		std::vector<float> u{};
+		std::vector<float> v{};
+		std::vector<float> normalX{};
+		std::vector<float> normalY{};
+		std::vector<float> normalZ{};
+		std::vector<float> tangentX{};
+		std::vector<float> tangentY{};
+		std::vector<float> tangentZ{};
+
+		// VertexFormat::Quantized - same encoding as QuantizedVertex, the float streams stay empty
+		std::vector<uint16_t> quantizedPositionX{};
+		std::vector<uint16_t> quantizedPositionY{};
+		std::vector<uint16_t> quantizedPositionZ{};
+		std::vector<uint16_t> halfU{};
+		std::vector<uint16_t> halfV{};
+		std::vector<int16_t> octahedralNormalX{};
+		std::vector<int16_t> octahedralNormalY{};
+		std::vector<int16_t> octahedralTangentX{};
+		std::vector<int16_t> octahedralTangentY{};
+		Vector3 positionMin{};
+		Vector3 positionExtent{};
+
+		static VertexStreams FromVertices(const std::vector<VertexIn>& vertices);
+		static VertexStreams FromVertices(const QuantizedVertexBuffer& vertices);
+	};
+
+	// Everything the vertex stage reads besides the vertices, the same for every vertex of a draw
+	struct VertexTransformConstants
+	{
+		Matrix worldViewProjectionMatrix{};
+		Matrix worldMatrix{};
+		Vector3 cameraOrigin{};
+		float screenWidth{};
+		float screenHeight{};
+	};
+
+	// Transforms vertices [first, last) into pVerticesOut[first, last), first has to be a multiple of BATCH_SIZE
+	// Same math and rounding as the per-vertex path: clip space, perspective divide, screen space, 1/w for the attributes
+	void TransformVertexStreams(const VertexStreams& streams, size_t first, size_t last, const VertexTransformConstants& constants,
+		VertexOut* pVerticesOut);
+}
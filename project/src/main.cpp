@@ -2,15 +2,24 @@
 #include "SDL.h"
 #include "SDL_surface.h"
 #include "SDL_image.h"
-#include "SDL_syswm.h"
 #undef main
 
 //Standard includes
 #include <iostream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
 
 //Project includes
 #include "Timer.h"
 #include "Renderer.h"
+#include "Benchmark.h"
+#include "Profiler.h"
 #if defined(_DEBUG)
 	#include "LeakDetector.h"
 #endif
@@ -23,22 +32,358 @@ void ShutDown(SDL_Window* pWindow)
 	SDL_Quit();
 }
 
-int main(int argc, char* args[])
+struct LaunchOptions
+{
+	bool isHeadless{ false };
+	bool isBenchmark{ false };
+	std::string benchmarkOutput{ "benchmark.json" };
+	int numFrames{ 100 };
+	int width{ 640 };
+	int height{ 480 };
+	std::string outputDirectory{}; // Empty => frames are not written
+	std::string outputFormat{ "ppm" };
+	RasterizerMode headlessMode{ RasterizerMode::Software }; // Null => submission overhead only, nothing is rasterized
+	std::string tracePath{}; // Empty => no trace is written
+	uint32_t traceFirstFrame{ 0 };
+	uint32_t traceLastFrame{ UINT32_MAX };
+	float frameBudget{ 1000.f / 30.f }; // ms, slower frames are reported as stalls
+	VertexFormat vertexFormat{ VertexFormat::Float32 };
+	uint32_t maxSubmeshVertices{}; // --split-16bit, 0 => every mesh keeps a single submesh
+	bool isLodActive{ true }; // Off => every mesh at full detail, to compare runs with and without levels of detail
+	SoftwareRasterizer::TransparencyMode transparencyMode{ SoftwareRasterizer::TransparencyMode::Sorted };
+};
+
+// Chrome trace of the profiled frames, open it in chrome://tracing or ui.perfetto.dev
+void WriteTrace(const std::string& filePath, uint32_t firstFrame, uint32_t lastFrame)
+{
+#if defined(DAE_PROFILER)
+	if (Profiler::WriteChromeTrace(filePath, firstFrame, lastFrame))
+		std::cout << "Trace written to " << filePath << '\n';
+	else
+		std::cout << "Failed to write " << filePath << '\n';
+#else
+	(void)firstFrame;
+	(void)lastFrame;
+	std::cout << "Built without the profiler (DAE_PROFILER_ENABLED), " << filePath << " is not written\n";
+#endif
+}
+
+// The whole text has to be a number, a typo leaves outValue as it is instead of throwing
+template<typename T>
+bool ParseNumber(const std::string& text, T& outValue)
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	const char* pEnd{ text.data() + text.size() };
+	T value{};
+	const auto [pLast, error] { std::from_chars(text.data(), pEnd, value) };
+	if (error != std::errc{} || pLast != pEnd)
+		return false;
+
+	outValue = value;
+	return true;
+}
+
+LaunchOptions ParseLaunchOptions(int argc, char* args[])
+{
+	LaunchOptions options{};
+
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ args[i] };
+		const bool hasValue{ i + 1 < argc };
+
+		if (argument == "--headless")
+			options.isHeadless = true;
+		else if (argument == "--benchmark")
+			options.isBenchmark = true;
+		else if (argument == "--benchmark-output" && hasValue)
+			options.benchmarkOutput = args[++i];
+		else if (argument == "--frames" && hasValue)
+		{
+			if (ParseNumber(args[++i], options.numFrames))
+				options.numFrames = std::max(1, options.numFrames);
+			else
+				std::cout << "Invalid frame count " << args[i] << ", using " << options.numFrames << '\n';
+		}
+		else if (argument == "--width" && hasValue)
+		{
+			if (ParseNumber(args[++i], options.width))
+				options.width = std::max(1, options.width);
+			else
+				std::cout << "Invalid width " << args[i] << ", using " << options.width << '\n';
+		}
+		else if (argument == "--height" && hasValue)
+		{
+			if (ParseNumber(args[++i], options.height))
+				options.height = std::max(1, options.height);
+			else
+				std::cout << "Invalid height " << args[i] << ", using " << options.height << '\n';
+		}
+		else if (argument == "--output" && hasValue)
+			options.outputDirectory = args[++i];
+		else if (argument == "--format" && hasValue)
+			options.outputFormat = args[++i];
+		else if (argument == "--frame-budget" && hasValue)
+		{
+			if (ParseNumber(args[++i], options.frameBudget))
+				options.frameBudget = std::max(0.f, options.frameBudget);
+			else
+				std::cout << "Invalid frame budget " << args[i] << ", using " << options.frameBudget << " ms\n";
+		}
+		else if (argument == "--trace" && hasValue)
+			options.tracePath = args[++i];
+		else if (argument == "--trace-frames" && hasValue)
+		{
+			// first-last, frames are counted from 1
+			const std::string range{ args[++i] };
+			const size_t separator{ range.find('-') };
+			uint32_t firstFrame{};
+			uint32_t lastFrame{};
+			const bool isValid{ ParseNumber(range.substr(0, separator), firstFrame)
+				&& ParseNumber(separator == std::string::npos ? range : range.substr(separator + 1), lastFrame) };
 
+			if (isValid && firstFrame <= lastFrame)
+			{
+				options.traceFirstFrame = firstFrame;
+				options.traceLastFrame = lastFrame;
+			}
+			else
+			{
+				std::cout << "Invalid trace frame range " << range << ", expected first-last with first <= last\n";
+			}
+		}
+		else if (argument == "--vertex-format" && hasValue)
+		{
+			const std::string vertexFormat{ args[++i] };
+			if (vertexFormat == "quantized")
+				options.vertexFormat = VertexFormat::Quantized;
+			else if (vertexFormat == "float32")
+				options.vertexFormat = VertexFormat::Float32;
+			else
+				std::cout << "Unknown vertex format " << vertexFormat << ", using float32\n";
+		}
+		else if (argument == "--split-16bit" && hasValue)
+		{
+			// Vertices per submesh, 3 to 65536
+			if (ParseNumber(args[++i], options.maxSubmeshVertices))
+				options.maxSubmeshVertices = std::clamp(options.maxSubmeshVertices, 3u, 65536u);
+			else
+				std::cout << "Invalid submesh vertex count " << args[i] << ", meshes are not split\n";
+		}
+		else if (argument == "--lod" && hasValue)
+		{
+			const std::string lod{ args[++i] };
+			if (lod == "on" || lod == "off")
+				options.isLodActive = lod == "on";
+			else
+				std::cout << "Unknown level of detail setting " << lod << ", using on\n";
+		}
+		else if (argument == "--transparency" && hasValue)
+		{
+			const std::string transparency{ args[++i] };
+			if (transparency == "sorted")
+				options.transparencyMode = SoftwareRasterizer::TransparencyMode::Sorted;
+			else if (transparency == "oit")
+				options.transparencyMode = SoftwareRasterizer::TransparencyMode::WeightedBlendedOIT;
+			else
+				std::cout << "Unknown transparency mode " << transparency << ", using sorted\n";
+		}
+		else if (argument == "--backend" && hasValue)
+		{
+			const std::string backend{ args[++i] };
+			if (backend == "null")
+				options.headlessMode = RasterizerMode::Null;
+			else if (backend == "software")
+				options.headlessMode = RasterizerMode::Software;
+			else
+				std::cout << "Unknown backend " << backend << ", using software\n";
+		}
+		else
+			std::cout << "Unknown argument: " << argument << '\n';
+	}
+
+	if (options.outputFormat != "ppm" && options.outputFormat != "png")
+	{
+		std::cout << "Unknown output format " << options.outputFormat << ", using ppm\n";
+		options.outputFormat = "ppm";
+	}
+
+	return options;
+}
+
+// No window, no D3D => software frames rendered into memory as fast as possible
+int RunHeadless(const LaunchOptions& options)
+{
+	SDL_Init(0);
+
+	if (!options.outputDirectory.empty())
+		std::filesystem::create_directories(options.outputDirectory);
+
+	const auto pTimer = new Timer();
+	pTimer->SetFrameBudget(static_cast<uint64_t>(options.frameBudget * 1'000'000.f));
+	const auto pRenderer = new Renderer(options.width, options.height, options.headlessMode, options.vertexFormat, options.maxSubmeshVertices);
+	pRenderer->SetLodActive(options.isLodActive);
+	pRenderer->SetTransparencyMode(options.transparencyMode);
+
+	std::cout << "Rendering " << options.numFrames << " frames at " << options.width << "x" << options.height
+		<< (options.headlessMode == RasterizerMode::Null ? " (null backend)" : "") << '\n';
+
+	pTimer->Start();
+	const auto startTime{ std::chrono::high_resolution_clock::now() };
+
+	for (int frame{}; frame < options.numFrames; ++frame)
+	{
+		pRenderer->Update(pTimer);
+		pRenderer->Render();
+		pTimer->Update();
+
+		if (!options.outputDirectory.empty() && options.headlessMode == RasterizerMode::Software)
+		{
+			std::ostringstream fileName{};
+			fileName << "frame_" << std::setw(4) << std::setfill('0') << frame << '.' << options.outputFormat;
+
+			const std::filesystem::path filePath{ std::filesystem::path{ options.outputDirectory } / fileName.str() };
+			if (!pRenderer->SaveFrame(filePath.string()))
+				std::cout << "Failed to write " << filePath.string() << '\n';
+		}
+	}
+
+	const std::chrono::duration<double> totalTime{ std::chrono::high_resolution_clock::now() - startTime };
+	pTimer->Stop();
+
+	const FrameTimeHistogram& histogram{ pTimer->GetFrameTimeHistogram() };
+	std::cout << "Total: " << totalTime.count() << " s | Avg: " << totalTime.count() * 1000.0 / options.numFrames << " ms"
+		<< " | FPS: " << options.numFrames / totalTime.count() << " | p99: " << histogram.GetValueAtPercentile(99.0) * 1e-6 << " ms"
+		<< " | Stalls: " << pTimer->GetNumStalls() << std::endl;
+	pRenderer->PrintBackendStats();
+
+	if (!options.tracePath.empty())
+		WriteTrace(options.tracePath, options.traceFirstFrame, options.traceLastFrame);
+
+	delete pRenderer;
+	delete pTimer;
+
+	SDL_Quit();
+	return 0;
+}
+
+// Scripted scenarios at fixed resolutions, frame count and timestep => results are comparable across versions
+int RunBenchmark(const LaunchOptions& options)
+{
+	constexpr std::array<BenchmarkResolution, 3> resolutions{ { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } } };
+	constexpr float timeStep{ 1.f / 60.f };
+	constexpr int numWarmUpFrames{ 5 }; // Not recorded, first touches of textures and buffers
+	constexpr int maxTransparencyComparisons{ 10 }; // Untimed frames per scenario rendered with both transparency modes
+
+	SDL_Init(0);
+
+	std::vector<BenchmarkResult> results{};
+	BenchmarkConfiguration configuration{};
+	configuration.isLodActive = options.isLodActive;
+	configuration.vertexFormat = options.vertexFormat == VertexFormat::Quantized ? "quantized" : "float32";
+	configuration.transparencyMode = options.transparencyMode == SoftwareRasterizer::TransparencyMode::Sorted ? "sorted" : "oit";
+
+	for (const BenchmarkResolution& resolution : resolutions)
+	{
+		const auto pRenderer = new Renderer(resolution.width, resolution.height, options.headlessMode, options.vertexFormat, options.maxSubmeshVertices);
+		pRenderer->SetLodActive(options.isLodActive);
+		pRenderer->SetTransparencyMode(options.transparencyMode);
+		configuration.backendName = pRenderer->GetBackendName();
+
+		for (int scenarioIndex{}; scenarioIndex < BENCHMARK_SCENARIO_COUNT; ++scenarioIndex)
+		{
+			const BenchmarkScenario scenario{ static_cast<BenchmarkScenario>(scenarioIndex) };
+
+			BenchmarkResult result{};
+			result.scenarioName = GetScenarioName(scenario);
+			result.resolution = resolution;
+			result.timeStep = timeStep;
+			result.frameTimes.reserve(options.numFrames);
+			result.frameBudget = options.frameBudget;
+
+			Timer timer{};
+			timer.SetFrameBudget(static_cast<uint64_t>(options.frameBudget * 1'000'000.f));
+
+			for (int frame{ -numWarmUpFrames }; frame < options.numFrames; ++frame)
+			{
+				pRenderer->ApplyBenchmarkFrame(EvaluateScenario(scenario, std::max(0, frame) * timeStep));
+
+				// Recording starts with the first frame after the warm-up
+				if (frame == 0)
+					timer.Reset();
+
+				pRenderer->Render();
+
+				if (frame >= 0)
+				{
+					timer.Update();
+					result.frameTimes.emplace_back(static_cast<float>(timer.GetElapsedNs() * 1e-6));
+					result.statistics += pRenderer->GetPipelineStatistics();
+				}
+			}
+
+			result.frameTimeHistogram = timer.GetFrameTimeHistogram();
+			result.numStalls = timer.GetNumStalls();
+
+			// After the timed frames, rendering both modes would count twice in the frame times
+			if (options.headlessMode == RasterizerMode::Software)
+			{
+				const int numComparisons{ std::min(options.numFrames, maxTransparencyComparisons) };
+				for (int comparison{}; comparison < numComparisons; ++comparison)
+				{
+					const int frame{ comparison * options.numFrames / numComparisons };
+					pRenderer->ApplyBenchmarkFrame(EvaluateScenario(scenario, frame * timeStep));
+					pRenderer->RequestTransparencyComparison();
+					pRenderer->Render();
+
+					if (pRenderer->GetTransparencyComparison().numTriangles > 0)
+					{
+						++result.numTransparencyComparisons;
+						result.transparencyComparison += pRenderer->GetTransparencyComparison();
+					}
+				}
+			}
+
+			SummarizeFrameTimes(result);
+			PrintBenchmarkResult(result);
+			results.emplace_back(std::move(result));
+		}
+
+		delete pRenderer;
+	}
+
+	if (WriteBenchmarkJSON(options.benchmarkOutput, configuration, results))
+		std::cout << "Benchmark results written to " << options.benchmarkOutput << '\n';
+	else
+		std::cout << "Failed to write " << options.benchmarkOutput << '\n';
+
+	if (!options.tracePath.empty())
+		WriteTrace(options.tracePath, options.traceFirstFrame, options.traceLastFrame);
+
+	SDL_Quit();
+	return 0;
+}
+
+int main(int argc, char* args[])
+{
 	// Leak detection
 	#if defined(_DEBUG)
 		LeakDetector detector{};
 	#endif
 
+	DAE_PROFILE_THREAD("Main");
+
+	const LaunchOptions options{ ParseLaunchOptions(argc, args) };
+	if (options.isBenchmark)
+		return RunBenchmark(options);
+
+	if (options.isHeadless)
+		return RunHeadless(options);
+
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
 
-	const uint32_t width = 640;
-	const uint32_t height = 480;
+	const uint32_t width = options.width;
+	const uint32_t height = options.height;
 
 	SDL_Window* pWindow = SDL_CreateWindow(
 		"DirectX - Daniel Adamov, 2DAE10",
@@ -51,7 +396,10 @@ int main(int argc, char* args[])
 
 	//Initialize "framework"
 	const auto pTimer = new Timer();
-	const auto pRenderer = new Renderer(pWindow);
+	pTimer->SetFrameBudget(static_cast<uint64_t>(options.frameBudget * 1'000'000.f));
+	const auto pRenderer = new Renderer(pWindow, options.vertexFormat, options.maxSubmeshVertices);
+	pRenderer->SetLodActive(options.isLodActive);
+	pRenderer->SetTransparencyMode(options.transparencyMode);
 
 	//Start loop
 	pTimer->Start();
@@ -81,6 +429,13 @@ int main(int argc, char* args[])
 					else
 						std::wcout << L"Print FPS OFF\n";
 				}
+				else if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+				{
+					constexpr uint32_t numTracedFrames{ 60 };
+					const uint32_t lastFrame{ Profiler::GetFrameIndex() };
+					WriteTrace(options.tracePath.empty() ? "trace.json" : options.tracePath,
+						lastFrame > numTracedFrames ? lastFrame - numTracedFrames + 1 : 0, lastFrame);
+				}
 				break;
 			default: 
 				break;
@@ -98,11 +453,18 @@ int main(int argc, char* args[])
 
 		if (isPrintingFPS)
 		{
+			if (pTimer->IsLastFrameStall())
+				std::cout << "Stall: " << pTimer->GetRecentFrameTime(0) * 1e-6 << " ms" << std::endl;
+
 			printTimer += pTimer->GetElapsed();
 			if (printTimer >= 1.f)
 			{
 				printTimer = 0.f;
-				std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+				const FrameTimeHistogram& histogram{ pTimer->GetFrameTimeHistogram() };
+				std::cout << "dFPS: " << pTimer->GetdFPS() << " | Present: " << pRenderer->GetPresentTime() << " ms"
+					<< " | Latency: " << pRenderer->GetFrameLatency() << " ms"
+					<< " | p99: " << histogram.GetValueAtPercentile(99.0) * 1e-6 << " ms | Stalls: " << pTimer->GetNumStalls() << std::endl;
+				pRenderer->PrintPipelineStatistics();
 			}
 		}
 	}